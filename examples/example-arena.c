@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2010-2022 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <arena.h>
+#include <tree-map.h>
+
+#define REQUESTS  100
+#define ENTRIES   1000
+
+int     int_compare  ( const void *left, const void *right );
+bool    nop_destroy  ( void *key, void *value );
+
+int main( int argc, char *argv[] )
+{
+	lc_arena_t arena;
+	lc_allocator_t allocator;
+	lc_arena_checkpoint_t checkpoint;
+	lc_arena_chunk_t* first_chunk;
+	bool result;
+	int r;
+	int i;
+
+	result = lc_arena_create( &arena, 0, malloc, free );
+	assert( result );
+	lc_arena_allocator( &arena, &allocator );
+
+	/* A request-scoped tree map: keys, values and nodes all come from the
+	 * arena and are released in one step at the end of each request.
+	 */
+	for( r = 0; r < REQUESTS; r++ )
+	{
+		lc_tree_map_t map;
+		long sum = 0;
+
+		lc_tree_map_create_with_allocator( &map, nop_destroy, int_compare, &allocator );
+
+		for( i = 0; i < ENTRIES; i++ )
+		{
+			int *key   = lc_arena_alloc( &arena, sizeof(int) );
+			int *value = lc_arena_alloc( &arena, sizeof(int) );
+			*key   = (i * 7919) % ENTRIES;
+			*value = r;
+
+			result = lc_tree_map_insert( &map, key, value );
+			assert( result );
+		}
+
+		for( i = 0; i < ENTRIES; i++ )
+		{
+			void *value = NULL;
+			result = lc_tree_map_search( &map, &i, &value );
+			assert( result );
+			sum += *(int*) value;
+		}
+		assert( sum == (long) r * ENTRIES );
+
+		lc_tree_map_clear( &map );
+		lc_tree_map_destroy( &map );
+		lc_arena_reset( &arena );
+	}
+	printf( "  Requests: %d maps of %d entries built and reset\n", REQUESTS, ENTRIES );
+
+	/* Allocations are aligned. */
+	for( i = 0; i < 100; i++ )
+	{
+		void *p = lc_arena_alloc( &arena, (size_t) i + 1 );
+		assert( ((uintptr_t) p % LC_ARENA_ALIGNMENT) == 0 );
+		p = lc_arena_alloc_aligned( &arena, 3, 64 );
+		assert( ((uintptr_t) p % 64) == 0 );
+	}
+
+	/* The last allocation grows in place. */
+	{
+		char *text = lc_arena_alloc( &arena, 6 );
+		char *grown;
+		strcpy( text, "hello" );
+		grown = lc_arena_realloc( &arena, text, 6, 12 );
+		assert( grown == text );
+		strcat( grown, " world" );
+		printf( "   Realloc: %s\n", grown );
+	}
+
+	/* Everything after a checkpoint is released by a rollback. */
+	lc_arena_checkpoint( &arena, &checkpoint );
+	for( i = 0; i < 10000; i++ )
+	{
+		lc_arena_alloc( &arena, 100 ); /* spills into more chunks */
+	}
+	lc_arena_rollback( &arena, &checkpoint );
+	assert( arena.ptr == checkpoint.ptr );
+	printf( "  Rollback: restored\n" );
+
+	/* Large allocations get a chunk of their own. */
+	{
+		void *big = lc_arena_alloc( &arena, 4 * LC_ARENA_CHUNK_SIZE );
+		assert( big );
+		memset( big, 0, 4 * LC_ARENA_CHUNK_SIZE );
+	}
+
+	first_chunk = arena.first;
+	lc_arena_reset( &arena );
+	lc_arena_trim( &arena );
+	assert( arena.first == first_chunk && arena.current == first_chunk );
+	printf( "     Reset: done\n" );
+
+	lc_arena_destroy( &arena );
+	return 0;
+}
+
+int int_compare( const void *left, const void *right )
+{
+	return *(const int*) left - *(const int*) right;
+}
+
+bool nop_destroy( void *key, void *value )
+{
+	/* The arena owns the keys and values. */
+	return true;
+}
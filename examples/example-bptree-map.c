@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <bptree-map.h>
+
+#define COUNT   100000
+
+static int int_compare( const void *left, const void *right )
+{
+	int l = *(const int*) left;
+	int r = *(const int*) right;
+	return (l > r) - (l < r);
+}
+
+/* Keys and values are owned by the map. */
+static bool key_value_destroy( void *key, void *value )
+{
+	free( key );
+	free( value );
+	return true;
+}
+
+static int* int_create( int number )
+{
+	int* p = (int*) malloc( sizeof(int) );
+	assert( p );
+	*p = number;
+	return p;
+}
+
+int main( int argc, char *argv[] )
+{
+	lc_bptree_map_t map;
+	lc_bptree_map_iterator_t iter;
+	int previous;
+	size_t count;
+	int i;
+	bool result;
+
+	lc_bptree_map_create( &map, key_value_destroy, int_compare, malloc, free );
+	srand( 0 );
+
+	/* Insert in a scrambled order. */
+	for( i = 0; i < COUNT; i++ )
+	{
+		int number = (int) (((long) i * 7919) % COUNT);
+		result = lc_bptree_map_insert( &map, int_create( number ), int_create( -number ) );
+		assert( result );
+	}
+
+	assert( lc_bptree_map_size(&map) == COUNT );
+
+	i = 42;
+	assert( !lc_bptree_map_insert( &map, &i, &i ) );
+
+	for( i = 0; i < COUNT; i++ )
+	{
+		result = lc_bptree_map_find( &map, &i, &iter );
+		assert( result );
+		assert( *(int*) lc_bptree_map_iterator_value( &iter ) == -i );
+	}
+
+	/* Remove a random two thirds; keys used as separators are freed too. */
+	for( i = 0; i < 2 * COUNT; i++ )
+	{
+		int number = rand() % COUNT;
+
+		if( number % 3 != 0 )
+		{
+			lc_bptree_map_remove( &map, &number );
+		}
+	}
+
+	previous = -1;
+	count    = 0;
+	for( result = lc_bptree_map_begin( &map, &iter ); result; result = lc_bptree_map_next( &iter ) )
+	{
+		int key = *(int*) lc_bptree_map_iterator_key( &iter );
+		assert( key > previous );
+		previous = key;
+		count++;
+	}
+
+	assert( count == lc_bptree_map_size(&map) );
+	printf( "%lu keys left, tree height %lu\n", (unsigned long) count, (unsigned long) lc_bptree_map_height(&map) );
+
+	for( i = 0; i < COUNT; i++ )
+	{
+		lc_bptree_map_remove( &map, &i );
+	}
+
+	assert( lc_bptree_map_is_empty(&map) && !lc_bptree_map_begin( &map, &iter ) );
+	lc_bptree_map_destroy( &map );
+	return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <pthread.h>
+#include <concurrent-hash-map.h>
+
+#define THREADS     8
+#define KEYS        4096
+#define ROUNDS      16
+
+static lc_concurrent_hash_map_t map;
+
+static size_t key_hash( const void *key )
+{
+	return (size_t) (uintptr_t) key;
+}
+
+static int key_compare( const void *left, const void *right )
+{
+	return (int) ((intptr_t) left - (intptr_t) right);
+}
+
+static bool key_destroy( void *key, void *value )
+{
+	return true;
+}
+
+static bool increment( const void *key, void **value, void *user_data )
+{
+	*value = (void*) ((uintptr_t) *value + 1);
+	return true;
+}
+
+static bool remove_odd( const void *key, void **value, void *user_data )
+{
+	return ((uintptr_t) key % 2) == 0;
+}
+
+static void* worker( void* arg )
+{
+	int round;
+
+	for( round = 0; round < ROUNDS; round++ )
+	{
+		uintptr_t key;
+
+		for( key = 1; key <= KEYS; key++ )
+		{
+			/* Only the first thread to get here adds the key. */
+			if( !lc_concurrent_hash_map_insert_if_absent( &map, (void*) key, (void*) (uintptr_t) 1 ) )
+			{
+				bool result = lc_concurrent_hash_map_compute_if_present( &map, (void*) key, increment, NULL );
+				assert( result );
+			}
+		}
+	}
+
+	return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+	pthread_t threads[ THREADS ];
+	uintptr_t key;
+	long i;
+	bool result = lc_concurrent_hash_map_create( &map, 0, 64, key_hash, key_destroy, key_compare, malloc, free );
+	assert( result );
+
+	for( i = 0; i < THREADS; i++ )
+	{
+		pthread_create( &threads[ i ], NULL, worker, (void*) i );
+	}
+
+	for( i = 0; i < THREADS; i++ )
+	{
+		pthread_join( threads[ i ], NULL );
+	}
+
+	assert( lc_concurrent_hash_map_size( &map ) == KEYS );
+
+	/* Every key was touched once per thread per round. */
+	for( key = 1; key <= KEYS; key++ )
+	{
+		void* value = NULL;
+		result = lc_concurrent_hash_map_find( &map, (void*) key, &value );
+		assert( result );
+		assert( (uintptr_t) value == THREADS * ROUNDS );
+	}
+
+	for( key = 1; key <= KEYS; key++ )
+	{
+		result = lc_concurrent_hash_map_compute_if_present( &map, (void*) key, remove_odd, NULL );
+		assert( result );
+	}
+
+	assert( lc_concurrent_hash_map_size( &map ) == KEYS / 2 );
+	assert( !lc_concurrent_hash_map_remove( &map, (void*) (uintptr_t) 1 ) );
+	assert( lc_concurrent_hash_map_remove( &map, (void*) (uintptr_t) 2 ) );
+
+	printf( "%lu keys in %lu shards, each counted to %d.\n",
+	        (unsigned long) KEYS, (unsigned long) lc_concurrent_hash_map_shard_count( &map ), THREADS * ROUNDS );
+
+	lc_concurrent_hash_map_clear( &map );
+	assert( lc_concurrent_hash_map_size( &map ) == 0 );
+	lc_concurrent_hash_map_destroy( &map );
+	return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <pthread.h>
+#include <concurrent-tree-map.h>
+
+#define WRITERS     4
+#define READERS     2
+#define KEYS        20000    /* per writer */
+#define ROUNDS      8
+
+static lc_concurrent_tree_map_t map;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t destroyed = 0;
+static bool writing = true;
+
+static int key_compare( const void *left, const void *right )
+{
+	int l = *(const int*) left;
+	int r = *(const int*) right;
+	return (l > r) - (l < r);
+}
+
+static bool key_destroy( void *key, void *value )
+{
+	free( key );
+	pthread_mutex_lock( &lock );
+	destroyed++;
+	pthread_mutex_unlock( &lock );
+	return true;
+}
+
+static int* key_create( int k )
+{
+	int* key = malloc( sizeof(int) );
+	*key = k;
+	return key;
+}
+
+/* Writer w owns the keys k with k % WRITERS == w. */
+static void* writer( void* arg )
+{
+	int w = (int) (intptr_t) arg;
+	int round;
+	int k;
+
+	for( round = 0; round < ROUNDS; round++ )
+	{
+		for( k = w; k < KEYS * WRITERS; k += WRITERS )
+		{
+			int* key = key_create( k );
+			bool result = lc_concurrent_tree_map_insert( &map, key, (void*) (intptr_t) k );
+			assert( result );
+			result = lc_concurrent_tree_map_insert( &map, key, NULL );
+			assert( !result );
+		}
+
+		/* Keep the even keys on the last round. */
+		for( k = w; k < KEYS * WRITERS; k += WRITERS )
+		{
+			if( round < ROUNDS - 1 || k % 2 )
+			{
+				bool result = lc_concurrent_tree_map_remove( &map, &k );
+				assert( result );
+				result = lc_concurrent_tree_map_remove( &map, &k );
+				assert( !result );
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static bool check_order( void *key, void *value, void *user_data )
+{
+	int* last = user_data;
+	int k = *(int*) key;
+
+	assert( k > *last );
+	assert( (intptr_t) value == k );
+	*last = k;
+	return true;
+}
+
+static bool is_writing( void )
+{
+	bool result;
+	pthread_mutex_lock( &lock );
+	result = writing;
+	pthread_mutex_unlock( &lock );
+	return result;
+}
+
+static void* reader( void* arg )
+{
+	int low = 1000;
+	int high = 2000;
+	size_t scans = 0;
+
+	while( is_writing( ) || scans == 0 )
+	{
+		int last = low - 1;
+		int k;
+		void* value;
+
+		lc_concurrent_tree_map_range( &map, &low, &high, check_order, &last );
+		assert( last < high );
+
+		for( k = low; k < high; k++ )
+		{
+			if( lc_concurrent_tree_map_find( &map, &k, &value ) )
+			{
+				assert( (intptr_t) value == k );
+			}
+		}
+
+		scans++;
+	}
+
+	return NULL;
+}
+
+static bool count_even( void *key, void *value, void *user_data )
+{
+	size_t* count = user_data;
+	assert( *(int*) key % 2 == 0 );
+	(*count)++;
+	return true;
+}
+
+int main( int argc, char* argv[] )
+{
+	pthread_t writers[ WRITERS ];
+	pthread_t readers[ READERS ];
+	size_t count = 0;
+	void* value;
+	int k;
+	int i;
+
+	lc_concurrent_tree_map_create( &map, key_destroy, key_compare, malloc, free );
+
+	for( i = 0; i < READERS; i++ )
+	{
+		pthread_create( &readers[ i ], NULL, reader, NULL );
+	}
+	for( i = 0; i < WRITERS; i++ )
+	{
+		pthread_create( &writers[ i ], NULL, writer, (void*) (intptr_t) i );
+	}
+	for( i = 0; i < WRITERS; i++ )
+	{
+		pthread_join( writers[ i ], NULL );
+	}
+
+	pthread_mutex_lock( &lock );
+	writing = false;
+	pthread_mutex_unlock( &lock );
+
+	for( i = 0; i < READERS; i++ )
+	{
+		pthread_join( readers[ i ], NULL );
+	}
+
+	assert( lc_concurrent_tree_map_size( &map ) == KEYS * WRITERS / 2 );
+	assert( lc_concurrent_tree_map_range( &map, NULL, NULL, count_even, &count ) == KEYS * WRITERS / 2 );
+	assert( count == KEYS * WRITERS / 2 );
+
+	k = 4242;
+	assert( lc_concurrent_tree_map_find( &map, &k, &value ) && (intptr_t) value == k );
+	k = 4243;
+	assert( !lc_concurrent_tree_map_find( &map, &k, &value ) );
+
+	lc_concurrent_tree_map_destroy( &map );
+	assert( destroyed == (size_t) KEYS * WRITERS * ROUNDS );
+
+	printf( "%d writers and %d readers, %zu entries left.\n", WRITERS, READERS, count );
+	return 0;
+}
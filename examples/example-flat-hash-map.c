@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2010-2022 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <flat-hash-map.h>
+
+#define MAX 100000
+
+size_t  int_hash     ( const void *data );
+int     int_compare  ( const void *left, const void *right );
+bool    int_destroy  ( void *key, void *value );
+
+int main( int argc, char *argv[] )
+{
+	lc_flat_hash_map_t map;
+	lc_flat_hash_map_iterator_t itr;
+	size_t count;
+	bool result;
+	int i;
+
+	result = lc_flat_hash_map_create( &map, 1, int_hash, int_destroy, int_compare, malloc, free );
+	assert( result );
+
+	for( i = 0; i < MAX; i++ )
+	{
+		int *key   = malloc( sizeof(int) );
+		int *value = malloc( sizeof(int) );
+		*key   = i;
+		*value = i * 2;
+
+		result = lc_flat_hash_map_insert( &map, key, value );
+		assert( result );
+	}
+
+	printf( "  Inserted: %ld (capacity = %ld, load = %.2f)\n", lc_flat_hash_map_size(&map), lc_flat_hash_map_capacity(&map), lc_flat_hash_map_load_factor(&map) );
+
+	{
+		int duplicate = 7;
+		result = lc_flat_hash_map_insert( &map, &duplicate, &duplicate );
+		assert( !result );
+	}
+
+	for( i = 0; i < MAX; i++ )
+	{
+		int *value = NULL;
+		result = lc_flat_hash_map_find( &map, &i, (void **) &value );
+		assert( result );
+		assert( *value == i * 2 );
+	}
+
+	/* Remove all of the odd keys */
+	for( i = 1; i < MAX; i += 2 )
+	{
+		result = lc_flat_hash_map_remove( &map, &i );
+		assert( result );
+	}
+
+	printf( "   Removed: %d (size = %ld)\n", MAX / 2, lc_flat_hash_map_size(&map) );
+
+	for( i = 0; i < MAX; i++ )
+	{
+		int *value = NULL;
+		result = lc_flat_hash_map_find( &map, &i, (void **) &value );
+		assert( result == ((i % 2) == 0) );
+	}
+
+	/* Churn through tombstones */
+	for( i = 1; i < MAX; i += 2 )
+	{
+		int *key   = malloc( sizeof(int) );
+		int *value = malloc( sizeof(int) );
+		*key   = i;
+		*value = i * 2;
+
+		result = lc_flat_hash_map_insert( &map, key, value );
+		assert( result );
+		result = lc_flat_hash_map_remove( &map, key );
+		assert( result );
+	}
+
+	lc_flat_hash_map_iterator( &map, &itr );
+	count = 0;
+
+	while( lc_flat_hash_map_iterator_next( &itr ) )
+	{
+		int key   = *((int*) lc_flat_hash_map_iterator_key(&itr));
+		int value = *((int*) lc_flat_hash_map_iterator_value(&itr));
+		assert( value == key * 2 );
+		assert( key % 2 == 0 );
+		count++;
+	}
+
+	printf( "  Iterated: %ld (capacity = %ld)\n", count, lc_flat_hash_map_capacity(&map) );
+	assert( count == lc_flat_hash_map_size(&map) );
+
+	lc_flat_hash_map_destroy( &map );
+	return 0;
+}
+
+size_t int_hash( const void *data )
+{
+	return *((const int*) data);
+}
+
+int int_compare( const void *left, const void *right )
+{
+	return *((const int*) left) - *((const int*) right);
+}
+
+bool int_destroy( void *key, void *value )
+{
+	free( key );
+	free( value );
+	return true;
+}
@@ -35,6 +35,7 @@
 
 size_t  ip_hash     ( const void *data );
 bool    ip_destroy  ( void *key, void *value );
+void    auto_grow   ( void );
 
 
 static const char *ips[] = {
@@ -151,9 +152,97 @@ int main( int argc, char *argv[] )
 
 
 	lc_hash_map_destroy( &map );
+
+	auto_grow( );
 	return 0;
 }
 
+static size_t int_hash( const void *data )
+{
+	return *((const int*) data);
+}
+
+static int int_compare( const void *left, const void *right )
+{
+	return *((const int*) left) - *((const int*) right);
+}
+
+static bool int_destroy( void *key, void *value )
+{
+	free( key );
+	return true;
+}
+
+void auto_grow( void )
+{
+	lc_hash_map_t map;
+	size_t rehashing = 0;
+	int i;
+
+	lc_hash_map_create( &map, LC_HASH_MAP_SIZE_SMALL, int_hash, int_destroy, int_compare, malloc, free );
+	lc_hash_map_auto_grow_set( &map, LOAD_FACTOR );
+
+	for( i = 0; i < 100000; i++ )
+	{
+		int *key = malloc( sizeof(int) );
+		void *value;
+		bool result;
+		*key = i;
+
+		result = lc_hash_map_insert( &map, key, key );
+		assert( result );
+
+		if( lc_hash_map_is_rehashing(&map) )
+		{
+			rehashing++;
+		}
+
+		/* Entries must be reachable while they are being moved */
+		result = lc_hash_map_find( &map, &i, &value );
+		assert( result && *((int*) value) == i );
+	}
+
+	printf( "   Auto Grow: size = %ld, table_size = %ld, load = %4.2f, %ld inserts while rehashing\n", lc_hash_map_size(&map), lc_hash_map_table_size(&map), lc_hash_map_load_factor(&map), rehashing );
+
+	/* Batched lookups; every other key is missing */
+	{
+		static int wanted[ 1000 ];
+		static const void* keys[ 1000 ];
+		static void* values[ 1000 ];
+		size_t found;
+
+		for( i = 0; i < 1000; i++ )
+		{
+			wanted[ i ] = i % 2 == 0 ? i * 50 : -i;
+			keys[ i ]   = &wanted[ i ];
+		}
+
+		found = lc_hash_map_find_many( &map, keys, 1000, values );
+		assert( found == 500 );
+
+		for( i = 0; i < 1000; i++ )
+		{
+			assert( i % 2 == 0 ? *((int*) values[ i ]) == i * 50 : values[ i ] == NULL );
+		}
+
+		printf( "   Find Many: %lu of 1000 found\n", (unsigned long) found );
+	}
+
+	for( i = 0; i < 100000; i++ )
+	{
+		void *value;
+		bool result;
+
+		result = lc_hash_map_find( &map, &i, &value );
+		assert( result );
+		result = lc_hash_map_remove( &map, &i );
+		assert( result );
+	}
+
+	assert( lc_hash_map_size(&map) == 0 );
+	lc_hash_map_destroy( &map );
+}
+
 size_t ip_hash( const void *data )
 {
 	unsigned short count = 0;
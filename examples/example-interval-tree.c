@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <interval-tree.h>
+
+#define INTERVALS   20000
+#define SPAN        1000000
+#define QUERIES     2000
+
+typedef struct interval {
+	intptr_t low;
+	intptr_t high;
+	bool     present;
+} interval_t;
+
+static interval_t intervals[ INTERVALS ];
+
+static int endpoint_compare( const void *left, const void *right )
+{
+	intptr_t l = (intptr_t) left;
+	intptr_t r = (intptr_t) right;
+	return (l > r) - (l < r);
+}
+
+static bool interval_destroy( void *low, void *high, void *value )
+{
+	return true;
+}
+
+typedef struct query {
+	intptr_t low;
+	intptr_t high;
+	intptr_t last_low;
+	size_t   count;
+} query_t;
+
+static bool check_overlap( void *low, void *high, void *value, void *user_data )
+{
+	query_t* q = user_data;
+	interval_t* i = value;
+
+	assert( (intptr_t) low == i->low && (intptr_t) high == i->high && i->present );
+	assert( i->low <= q->high && i->high >= q->low );
+	assert( i->low >= q->last_low );
+	q->last_low = i->low;
+	q->count++;
+	return true;
+}
+
+static size_t brute_force( intptr_t low, intptr_t high )
+{
+	size_t count = 0;
+	size_t i;
+
+	for( i = 0; i < INTERVALS; i++ )
+	{
+		if( intervals[ i ].present && intervals[ i ].low <= high && intervals[ i ].high >= low ) count++;
+	}
+
+	return count;
+}
+
+static bool stop_at_first( void *low, void *high, void *value, void *user_data )
+{
+	return false;
+}
+
+int main( int argc, char* argv[] )
+{
+	lc_interval_tree_t tree;
+	size_t total = 0;
+	size_t i;
+
+	lc_interval_tree_create( &tree, interval_destroy, endpoint_compare, malloc, free );
+	srand( 11 );
+
+	for( i = 0; i < INTERVALS; i++ )
+	{
+		interval_t* in = &intervals[ i ];
+
+		in->low     = rand( ) % SPAN;
+		in->high    = in->low + rand( ) % (i % 10 == 0 ? SPAN / 10 : SPAN / 1000);
+		in->present = true;
+
+		lc_interval_tree_insert( &tree, (void*) in->low, (void*) in->high, in );
+	}
+
+	/* Remove a third of them again. */
+	for( i = 0; i < INTERVALS; i += 3 )
+	{
+		interval_t* in = &intervals[ i ];
+		bool removed = lc_interval_tree_remove( &tree, (void*) in->low, (void*) in->high, in );
+		assert( removed );
+		in->present = false;
+	}
+	assert( !lc_interval_tree_remove( &tree, (void*) intervals[ 0 ].low, (void*) intervals[ 0 ].high, &intervals[ 0 ] ) );
+	assert( lc_interval_tree_size( &tree ) == INTERVALS - (INTERVALS + 2) / 3 );
+
+	for( i = 0; i < QUERIES; i++ )
+	{
+		query_t q;
+		size_t visited;
+
+		q.low      = rand( ) % SPAN;
+		q.high     = q.low + (i % 2 ? 0 : rand( ) % 5000);
+		q.last_low = -1;
+		q.count    = 0;
+
+		visited = lc_interval_tree_overlaps( &tree, (void*) q.low, (void*) q.high, check_overlap, &q );
+		assert( visited == q.count );
+		assert( q.count == brute_force( q.low, q.high ) );
+		assert( lc_interval_tree_overlaps( &tree, (void*) q.low, (void*) q.high, stop_at_first, NULL ) == (q.count > 0 ? 1 : 0) );
+		total += q.count;
+	}
+
+	printf( "%d queries over %zu intervals found %zu overlaps.\n", QUERIES, lc_interval_tree_size( &tree ), total );
+
+	lc_interval_tree_destroy( &tree );
+	return 0;
+}
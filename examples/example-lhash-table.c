@@ -56,6 +56,92 @@ static const char *IPs[] = {
 	NULL
 };
 
+static size_t number_hash( const void *number )
+{
+	return *(const size_t*) number * 2654435761u;
+}
+
+static int number_compare( const void *left, const void *right )
+{
+	size_t l = *(const size_t*) left;
+	size_t r = *(const size_t*) right;
+	return (l > r) - (l < r);
+}
+
+/* Insert and remove in a sliding window; no deleted markers build up. */
+static void robin_hood_churn( void )
+{
+	lc_lhash_table_t table;
+	size_t number;
+	bool result;
+
+	result = lc_lhash_table_create( &table, sizeof(size_t), 1031, number_hash, number_compare, malloc, free );
+	assert( result );
+	result = lc_lhash_table_robin_hood_set( &table, true );
+	assert( result );
+
+	for( number = 0; number < 100000; number++ )
+	{
+		void *found = NULL;
+
+		result = lc_lhash_table_insert( &table, &number );
+		assert( result );
+
+		if( number >= 700 )
+		{
+			size_t old = number - 700;
+
+			result = lc_lhash_table_remove( &table, &old );
+			assert( result );
+			assert( !lc_lhash_table_find( &table, &old, &found ) );
+		}
+
+		result = lc_lhash_table_find( &table, &number, &found );
+		assert( result && *(size_t*) found == number );
+	}
+
+	assert( lc_lhash_table_size(&table) == 700 );
+	printf( "Robin Hood churn: %lu elements in %lu buckets\n", (unsigned long) lc_lhash_table_size(&table), (unsigned long) lc_lhash_table_table_size(&table) );
+	lc_lhash_table_destroy( &table );
+}
+
+/* Start tiny and let the table grow and purge deleted markers itself. */
+static void auto_resize_churn( void )
+{
+	lc_lhash_table_t table;
+	size_t number;
+	bool result;
+
+	result = lc_lhash_table_create( &table, sizeof(size_t), 1, number_hash, number_compare, malloc, free );
+	assert( result );
+	lc_lhash_table_auto_resize_set( &table, LC_LHASH_TABLE_LOAD_FACTOR, LC_LHASH_TABLE_MAX_DELETED );
+
+	for( number = 0; number < 100000; number++ )
+	{
+		void *found = NULL;
+
+		result = lc_lhash_table_insert( &table, &number );
+		assert( result );
+
+		if( number >= 5000 )
+		{
+			size_t old = number - 5000;
+
+			result = lc_lhash_table_remove( &table, &old );
+			assert( result );
+		}
+
+		assert( lc_lhash_table_load_factor(&table) <= LC_LHASH_TABLE_LOAD_FACTOR );
+		assert( lc_lhash_table_deleted(&table) <= LC_LHASH_TABLE_MAX_DELETED * lc_lhash_table_table_size(&table) );
+		result = lc_lhash_table_find( &table, &number, &found );
+		assert( result && *(size_t*) found == number );
+	}
+
+	assert( lc_lhash_table_size(&table) == 5000 );
+	printf( "Auto resize churn: %lu elements in %lu buckets\n", (unsigned long) lc_lhash_table_size(&table), (unsigned long) lc_lhash_table_table_size(&table) );
+	lc_lhash_table_destroy( &table );
+}
+
 int main( int argc, char *argv[] )
 {
 	lc_lhash_table_t table;
@@ -91,6 +177,21 @@ int main( int argc, char *argv[] )
 			printf( "\n" );
 		}
 
+		{
+			const void *keys[ sizeof(IPs) / sizeof(IPs[0]) ];
+			void *found[ sizeof(IPs) / sizeof(IPs[0]) ];
+			size_t count;
+
+			for( i = 0; IPs[ i ]; i++ )
+			{
+				keys[ i ] = &IPs[ i ];
+			}
+
+			count = lc_lhash_table_find_many( &table, keys, i, found );
+			assert( count == (size_t) i );
+			printf( "   Found %lu of %d in one batch\n", (unsigned long) count, i );
+		}
+
 		for( i = 0; IPs[ i ]; i++ )
 		{
 			const char *ip = IPs[ i ];
@@ -117,6 +218,9 @@ int main( int argc, char *argv[] )
 	} /* end while */
 
 	lc_lhash_table_destroy( &table );
+
+	robin_hood_churn( );
+	auto_resize_churn( );
 	return 0;
 }
 #else
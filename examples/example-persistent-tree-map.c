@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <pthread.h>
+#include <persistent-tree-map.h>
+
+#define KEYS        20000
+#define VERSIONS    8
+
+static int int_compare( const void *left, const void *right )
+{
+	int l = *(const int*) left;
+	int r = *(const int*) right;
+	return (l > r) - (l < r);
+}
+
+/* Keys and values are owned by the map. */
+static bool key_value_destroy( void *key, void *value )
+{
+	free( key );
+	free( value );
+	return true;
+}
+
+static int* int_create( int number )
+{
+	int* p = (int*) malloc( sizeof(int) );
+	assert( p );
+	*p = number;
+	return p;
+}
+
+typedef struct reader {
+	lc_persistent_tree_map_snapshot_t snapshot;
+	int version;
+	int previous;
+	size_t count;
+} reader_t;
+
+static bool check_entry( void *key, void *value, void *user_data )
+{
+	reader_t* reader = user_data;
+
+	/* Every value in a snapshot comes from the same version. */
+	assert( *(int*) value == reader->version );
+	assert( *(int*) key > reader->previous );
+	reader->previous = *(int*) key;
+	return true;
+}
+
+/* Reads a snapshot without locks while the writer keeps going. */
+static void* read_snapshot( void *arg )
+{
+	reader_t* reader = arg;
+
+	reader->previous = -1;
+	reader->count    = lc_persistent_tree_map_snapshot_range( &reader->snapshot, NULL, NULL, check_entry, reader );
+	assert( reader->count == lc_persistent_tree_map_snapshot_size( &reader->snapshot ) );
+
+	lc_persistent_tree_map_snapshot_release( &reader->snapshot );
+	return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+	lc_persistent_tree_map_t map;
+	lc_persistent_tree_map_snapshot_t first;
+	pthread_t threads[ VERSIONS ];
+	reader_t readers[ VERSIONS ];
+	void *value;
+	int version;
+	int i;
+	bool result;
+
+	lc_persistent_tree_map_create( &map, key_value_destroy, int_compare, malloc, free );
+
+	for( i = 0; i < KEYS; i++ )
+	{
+		result = lc_persistent_tree_map_insert( &map, int_create( i ), int_create( 0 ) );
+		assert( result );
+	}
+
+	lc_persistent_tree_map_snapshot( &map, &first );
+
+	for( version = 0; version < VERSIONS; version++ )
+	{
+		readers[ version ].version = version;
+		lc_persistent_tree_map_snapshot( &map, &readers[ version ].snapshot );
+
+		result = pthread_create( &threads[ version ], NULL, read_snapshot, &readers[ version ] ) == 0;
+		assert( result );
+
+		/* Write the next version while the reader is busy. */
+		for( i = 0; i < KEYS; i++ )
+		{
+			result = lc_persistent_tree_map_insert( &map, int_create( i ), int_create( version + 1 ) );
+			assert( result );
+		}
+	}
+
+	for( version = 0; version < VERSIONS; version++ )
+	{
+		pthread_join( threads[ version ], NULL );
+		assert( readers[ version ].count == KEYS );
+	}
+
+	/* Remove the odd keys; the first snapshot still has all of them. */
+	for( i = 1; i < KEYS; i += 2 )
+	{
+		result = lc_persistent_tree_map_remove( &map, &i );
+		assert( result );
+	}
+
+	i = 1;
+	assert( !lc_persistent_tree_map_find( &map, &i, &value ) );
+	assert( lc_persistent_tree_map_snapshot_find( &first, &i, &value ) && *(int*) value == 0 );
+	assert( lc_persistent_tree_map_size( &map ) == KEYS / 2 );
+	assert( lc_persistent_tree_map_snapshot_size( &first ) == KEYS );
+
+	i = 2;
+	result = lc_persistent_tree_map_find( &map, &i, &value );
+	assert( result && *(int*) value == VERSIONS );
+
+	printf( "Read %d versions of %d keys; the live map has %ld keys.\n", VERSIONS, KEYS, lc_persistent_tree_map_size( &map ) );
+
+	lc_persistent_tree_map_snapshot_release( &first );
+	lc_persistent_tree_map_destroy( &map );
+	return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2010-2022 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <pool.h>
+
+#define THREADS     8
+#define ROUNDS      3
+#define ITERATIONS  200000
+#define HELD        256
+
+typedef struct message {
+	long owner;
+	long sequence;
+} message_t;
+
+LC_POOL_DECL( message, message_t )
+LC_POOL_IMPL( message, message_t )
+LC_POOL_MT_DECL( message, message_t )
+LC_POOL_MT_IMPL( message, message_t )
+
+static message_pool_mt_t* pool = NULL;
+
+/* Objects handed from one thread to the next; released by the receiver. */
+static message_t* mailbox[ THREADS ][ HELD ];
+static pthread_barrier_t barrier;
+
+static void* worker( void* arg )
+{
+	long id = (long) arg;
+	message_t* held[ HELD ];
+	int i;
+
+	memset( held, 0, sizeof(held) );
+
+	for( i = 0; i < ITERATIONS; i++ )
+	{
+		int slot = i % HELD;
+
+		if( held[ slot ] )
+		{
+			/* Nobody else may have been handed this object. */
+			assert( held[ slot ]->owner == id && held[ slot ]->sequence == i - HELD );
+			message_pool_mt_release( pool, &held[ slot ] );
+		}
+
+		held[ slot ] = message_pool_mt_obtain( pool );
+		assert( held[ slot ] );
+		held[ slot ]->owner    = id;
+		held[ slot ]->sequence = i;
+	}
+
+	/* Pass the held objects to the next thread, which releases them. */
+	memcpy( mailbox[ (id + 1) % THREADS ], held, sizeof(held) );
+	pthread_barrier_wait( &barrier );
+
+	for( i = 0; i < HELD; i++ )
+	{
+		message_pool_mt_release( pool, &mailbox[ id ][ i ] );
+	}
+
+	return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+	pthread_t threads[ THREADS ];
+	long i;
+	int round;
+
+	pool = message_pool_mt_create( 1024, LC_POOL_GROWTH_EXPONENTIAL );
+	assert( pool );
+	pthread_barrier_init( &barrier, NULL, THREADS );
+
+	/* Each round starts new threads; they reuse the cache slots of the
+	 * threads that exited, whose cached objects went back to the depot. */
+	for( round = 0; round < ROUNDS; round++ )
+	{
+		for( i = 0; i < THREADS; i++ )
+		{
+			pthread_create( &threads[ i ], NULL, worker, (void*) i );
+		}
+
+		for( i = 0; i < THREADS; i++ )
+		{
+			pthread_join( threads[ i ], NULL );
+		}
+
+		assert( message_pool_outstanding( pool->depot ) == 0 );
+	}
+
+	printf( "  Threads: %d rounds of %d x %d obtain/release pairs\n", ROUNDS, THREADS, ITERATIONS );
+	printf( " Capacity: %lu objects\n", (unsigned long) message_pool_capacity( pool->depot ) );
+
+	pthread_barrier_destroy( &barrier );
+	message_pool_mt_destroy( &pool );
+	return 0;
+}
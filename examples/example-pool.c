@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2010-2022 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <pool.h>
+#include <tree-map.h>
+
+#define MAX 10000
+
+typedef struct point {
+	int x;
+	int y;
+} point_t;
+
+LC_POOL_DECL( point, point_t )
+LC_POOL_IMPL( point, point_t )
+
+LC_POOL_DECL( node, lc_tree_map_node_t )
+LC_POOL_IMPL( node, lc_tree_map_node_t )
+
+int     int_compare  ( const void *left, const void *right );
+bool    nop_destroy  ( void *key, void *value );
+bool    free_destroy ( void *key, void *value );
+
+static point_t* points[ MAX ];
+static int keys[ MAX ];
+
+int main( int argc, char *argv[] )
+{
+	point_pool_t* pool = point_pool_create( 16, LC_POOL_GROWTH_EXPONENTIAL );
+	int i;
+
+	assert( pool );
+
+	/* Objects never move while the pool grows. */
+	for( i = 0; i < MAX; i++ )
+	{
+		points[ i ] = point_pool_obtain( pool );
+		assert( points[ i ] );
+		points[ i ]->x = i;
+		points[ i ]->y = -i;
+	}
+
+	for( i = 0; i < MAX; i++ )
+	{
+		assert( points[ i ]->x == i && points[ i ]->y == -i );
+	}
+	printf( "   Obtained: %d (capacity = %lu)\n", MAX, (unsigned long) point_pool_capacity(pool) );
+
+	/* Released objects are handed out again before the pool grows. */
+	for( i = 0; i < MAX; i += 2 )
+	{
+		point_pool_release( pool, &points[ i ] );
+		assert( points[ i ] == NULL );
+	}
+	{
+		size_t capacity = point_pool_capacity( pool );
+		for( i = 0; i < MAX; i += 2 )
+		{
+			points[ i ] = point_pool_obtain( pool );
+			assert( points[ i ] );
+		}
+		assert( point_pool_capacity(pool) == capacity );
+	}
+	printf( "   Recycled: %d\n", MAX / 2 );
+
+	for( i = 0; i < MAX; i++ )
+	{
+		point_pool_release( pool, &points[ i ] );
+	}
+	assert( point_pool_outstanding(pool) == 0 );
+	point_pool_shrink( pool );
+	printf( "     Shrunk: capacity = %lu\n", (unsigned long) point_pool_capacity(pool) );
+
+	point_pool_destroy( &pool );
+	assert( pool == NULL );
+
+	/* A pool as the node allocator of a tree map. */
+	{
+		node_pool_t* nodes = node_pool_create( 64, LC_POOL_GROWTH_LINEAR(256) );
+		lc_allocator_t allocator;
+		lc_tree_map_t map;
+		int round;
+
+		node_pool_allocator( nodes, &allocator );
+		lc_tree_map_create_with_allocator( &map, nop_destroy, int_compare, &allocator );
+
+		for( round = 0; round < 10; round++ )
+		{
+			for( i = 0; i < MAX; i++ )
+			{
+				keys[ i ] = i;
+				lc_tree_map_insert( &map, &keys[ i ], &keys[ i ] );
+			}
+			for( i = 0; i < MAX; i += 2 )
+			{
+				lc_tree_map_remove( &map, &keys[ i ] );
+			}
+			lc_tree_map_clear( &map );
+		}
+
+		assert( node_pool_outstanding(nodes) == 0 );
+		printf( "  Tree Map: 10 rounds of churn, %lu nodes pooled\n", (unsigned long) node_pool_capacity(nodes) );
+
+		lc_tree_map_destroy( &map );
+		node_pool_destroy( &nodes );
+	}
+
+	/* A pool-backed tree map can be unserialized; its keys and values
+	 * come from malloc(), only its nodes from the pool. */
+	{
+		node_pool_t* nodes = node_pool_create( 64, LC_POOL_GROWTH_EXPONENTIAL );
+		lc_allocator_t allocator;
+		lc_tree_map_t map;
+		FILE* file = tmpfile( );
+		lc_tree_map_iterator_t itr;
+
+		assert( file );
+		lc_tree_map_create( &map, nop_destroy, int_compare, malloc, free );
+		for( i = 0; i < MAX; i++ )
+		{
+			keys[ i ] = i;
+			lc_tree_map_insert( &map, &keys[ i ], &keys[ i ] );
+		}
+		assert( lc_tree_map_serialize( &map, sizeof(int), sizeof(int), file ) );
+		lc_tree_map_destroy( &map );
+		rewind( file );
+
+		node_pool_allocator( nodes, &allocator );
+		lc_tree_map_create_with_allocator( &map, free_destroy, int_compare, &allocator );
+		assert( lc_tree_map_unserialize( &map, sizeof(int), sizeof(int), file ) );
+		fclose( file );
+
+		assert( lc_tree_map_size( &map ) == MAX );
+		assert( node_pool_outstanding(nodes) == MAX );
+		i = MAX / 2;
+		itr = lc_tree_map_find( &map, &i );
+		assert( itr != lc_tree_map_end( ) && *(int*) itr->value == MAX / 2 );
+		printf( "Unserialize: %d entries, %lu nodes pooled\n", MAX, (unsigned long) node_pool_capacity(nodes) );
+
+		lc_tree_map_destroy( &map );
+		assert( node_pool_outstanding(nodes) == 0 );
+		node_pool_destroy( &nodes );
+	}
+
+	return 0;
+}
+
+int int_compare( const void *left, const void *right )
+{
+	return *(const int*) left - *(const int*) right;
+}
+
+bool nop_destroy( void *key, void *value )
+{
+	return true;
+}
+
+bool free_destroy( void *key, void *value )
+{
+	free( key );
+	free( value );
+	return true;
+}
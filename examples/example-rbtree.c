@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 #include <assert.h>
 #include <rbtree.h>
@@ -48,6 +49,31 @@ void print_tree( lc_rbtree_t *tree )
 
 #define RANDOMIZE 1
 
+static bool print_number( void *num, void *user_data )
+{
+	int *previous = user_data;
+	assert( *((int*) num) > *previous );
+	*previous = *((int*) num);
+	printf( " %d", *((int*) num) );
+	return true;
+}
+
+/* Returns the black height of the subtree or -1 if it is not a red-black tree. */
+static int black_height( lc_rbnode_t *node )
+{
+	int left, right;
+
+	if( node == lc_rbtree_end( ) ) return 1;
+
+	left  = black_height( node->left );
+	right = black_height( node->right );
+
+	if( left < 0 || left != right ) return -1;
+	if( lc_rbnode_is_red( node ) && (lc_rbnode_is_red( node->left ) || lc_rbnode_is_red( node->right )) ) return -1;
+
+	return left + (lc_rbnode_is_red( node ) ? 0 : 1);
+}
+
 
 int main( int argc, char *argv[] )
 {
@@ -95,6 +121,22 @@ int main( int argc, char *argv[] )
 		assert( size == lc_rbtree_size( &tree ) );
 		fclose( file );
 	}
+
+	/* A count larger than the file holds is refused before anything is
+	 * allocated for it. */
+	file = tmpfile( );
+	if( file )
+	{
+		size_t size = lc_rbtree_size( &tree );
+		size_t count = SIZE_MAX / 16;
+
+		fwrite( &count, sizeof(size_t), 1, file );
+		fwrite( &count, sizeof(size_t), 1, file );
+		fseek( file, 0, SEEK_SET );
+		assert( !lc_rbtree_unserialize( &tree, sizeof(int), file ) );
+		assert( size == lc_rbtree_size( &tree ) );
+		fclose( file );
+	}
 	printf("----------- DONE SERIALIZING ----------\n" );
 
 	//bool isGood = lc_rbtree_verify_tree( &tree );
@@ -138,10 +180,143 @@ int main( int argc, char *argv[] )
 	printf("------------- DONE REMOVING -----------\n" );
 
 
+	{
+		int low = 20, high = 60, previous = low - 1;
+		lc_rbtree_iterator_t first;
+		lc_rbtree_iterator_t last;
+		lc_rbtree_iterator_t itr;
+		size_t count = 0;
+
+		printf( "In [%d, %d):", low, high );
+		for( itr = lc_rbtree_lower_bound( &tree, &low ); itr != lc_rbtree_end( ) && *((int*) itr->data) < high; itr = lc_rbtree_next( itr ) )
+		{
+			count++;
+		}
+		assert( lc_rbtree_range( &tree, &low, &high, print_number, &previous ) == count );
+		printf( "\n" );
+
+		lc_rbtree_equal_range( &tree, &low, &first, &last );
+		assert( first == last || *((int*) first->data) == low );
+	}
+
 	printf( "Clearing the tree.\n" );
 	lc_rbtree_clear( &tree );
 	printf( "Tree size = %ld \n", tree.size );
 
+	{
+		void *numbers[ 500 ];
+		lc_rbtree_iterator_t itr;
+		bool result;
+
+		for( i = 0; i < 500; i++ )
+		{
+			int *num = (int*) malloc( sizeof(int) );
+			*num = 2 * i;
+			numbers[ i ] = num;
+		}
+
+		result = lc_rbtree_build_sorted( &tree, numbers, 500 );
+		assert( result );
+		assert( lc_rbtree_size( &tree ) == 500 );
+		assert( black_height( tree.root ) > 0 );
+
+		for( i = 1; i < 1000; i += 2 )
+		{
+			int *num = (int*) malloc( sizeof(int) );
+			*num = i;
+			lc_rbtree_insert( &tree, num );
+		}
+		for( i = 0; i < 1000; i += 3 )
+		{
+			lc_rbtree_remove( &tree, &i );
+		}
+		assert( black_height( tree.root ) > 0 );
+
+		for( i = 1, itr = lc_rbtree_begin( &tree ); itr != lc_rbtree_end( ); i++, itr = lc_rbtree_next( itr ) )
+		{
+			if( i % 3 == 0 ) i++;
+			assert( *((int*) itr->data) == i );
+		}
+		assert( lc_rbtree_size( &tree ) == 666 );
+
+		#ifdef LC_RBTREE_ORDER_STATISTICS
+		{
+			size_t k;
+			int p99;
+
+			for( k = 0, itr = lc_rbtree_begin( &tree ); itr != lc_rbtree_end( ); k++, itr = lc_rbtree_next( itr ) )
+			{
+				assert( lc_rbtree_select( &tree, k ) == itr );
+				assert( lc_rbtree_rank( &tree, itr->data ) == k );
+			}
+			assert( lc_rbtree_select( &tree, k ) == lc_rbtree_end( ) );
+
+			i = 3;
+			assert( lc_rbtree_rank( &tree, &i ) == 2 );
+
+			p99 = *((int*) lc_rbtree_select( &tree, lc_rbtree_size( &tree ) * 99 / 100 )->data);
+			printf( "The 99th percentile is %d.\n", p99 );
+		}
+		#endif
+		printf( "Built a tree of 500 sorted items; black height is %d.\n", black_height( tree.root ) );
+		(void) result;
+	}
+
+	{
+		/* Multiples of 2 and of 3 below 60000. */
+		lc_rbtree_t evens;
+		lc_rbtree_t threes;
+		lc_rbtree_t upper;
+		bool result;
+		int n;
+
+		lc_rbtree_create( &evens, destroy, compare, malloc, free );
+		lc_rbtree_create( &threes, destroy, compare, malloc, free );
+		lc_rbtree_create( &upper, destroy, compare, malloc, free );
+		lc_rbtree_threads_set( &evens, 4 );
+
+		for( n = 0; n < 60000; n++ )
+		{
+			int *num;
+			if( n % 2 == 0 ) { num = malloc( sizeof(int) ); *num = n; lc_rbtree_insert( &evens, num ); }
+			if( n % 3 == 0 ) { num = malloc( sizeof(int) ); *num = n; lc_rbtree_insert( &threes, num ); }
+		}
+
+		/* Multiples of 2 or 3. */
+		result = lc_rbtree_union( &evens, &threes );
+		assert( result );
+		assert( lc_rbtree_size( &evens ) == 40000 && lc_rbtree_size( &threes ) == 0 );
+		assert( black_height( evens.root ) > 0 );
+
+		/* ...without the multiples of 3, i.e. 2, 4, 8, 10, ... */
+		for( n = 0; n < 60000; n += 3 )
+		{
+			int *num = malloc( sizeof(int) );
+			*num = n;
+			lc_rbtree_insert( &threes, num );
+		}
+		result = lc_rbtree_difference( &evens, &threes );
+		assert( result );
+		assert( lc_rbtree_size( &evens ) == 20000 );
+
+		n = 30000;
+		result = lc_rbtree_split( &evens, &n, &upper );
+		assert( result );
+		assert( lc_rbtree_size( &evens ) == 10000 && lc_rbtree_size( &upper ) == 10000 );
+		assert( *((int*) lc_rbtree_begin( &upper )->data) == 30002 );
+		assert( black_height( evens.root ) > 0 && black_height( upper.root ) > 0 );
+
+		result = lc_rbtree_join( &evens, &upper );
+		assert( result );
+		assert( lc_rbtree_size( &evens ) == 20000 );
+		printf( "Set operations left %ld items; black height is %d.\n", lc_rbtree_size( &evens ), black_height( evens.root ) );
+
+		lc_rbtree_destroy( &upper );
+		lc_rbtree_destroy( &threes );
+		lc_rbtree_destroy( &evens );
+		(void) result;
+	}
+
 	lc_rbtree_destroy( &tree );
 	return 0;
 }
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <slab-rbtree.h>
+
+#define KEYS    50000
+
+typedef struct record {
+	uint32_t id;
+	char     name[ 12 ];
+} record_t;
+
+static int record_compare( const void *left, const void *right )
+{
+	const record_t* l = left;
+	const record_t* r = right;
+	return (l->id > r->id) - (l->id < r->id);
+}
+
+static bool check_tree( const lc_slab_rbtree_t* tree, const bool* present )
+{
+	lc_slab_rbtree_iterator_t it;
+	size_t count = 0;
+	long last = -1;
+
+	for( it = lc_slab_rbtree_begin( tree ); it != lc_slab_rbtree_end( ); it = lc_slab_rbtree_next( tree, it ) )
+	{
+		const record_t* r = lc_slab_rbtree_element( tree, it );
+		char name[ 12 ];
+
+		sprintf( name, "r%u", (unsigned) r->id );
+		if( (long) r->id <= last || !present[ r->id ] || strcmp( name, r->name ) != 0 ) return false;
+		last = r->id;
+		count++;
+	}
+
+	return count == lc_slab_rbtree_size( tree );
+}
+
+int main( int argc, char* argv[] )
+{
+	lc_slab_rbtree_t tree;
+	lc_slab_rbtree_t copy;
+	lc_slab_rbtree_iterator_t it;
+	bool* present = calloc( KEYS, sizeof(bool) );
+	const void* image;
+	size_t image_size;
+	record_t key;
+	record_t* found;
+	FILE* file;
+	uint32_t i;
+
+	lc_slab_rbtree_create( &tree, sizeof(record_t), NULL, record_compare, malloc, free );
+	srand( 7 );
+
+	for( i = 0; i < 4 * KEYS; i++ )
+	{
+		record_t r;
+
+		memset( &r, 0, sizeof(r) );
+		r.id = rand( ) % KEYS;
+		sprintf( r.name, "r%u", (unsigned) r.id );
+
+		if( rand( ) % 3 )
+		{
+			bool inserted = lc_slab_rbtree_insert( &tree, &r );
+			assert( inserted == !present[ r.id ] );
+			present[ r.id ] = true;
+		}
+		else
+		{
+			bool removed = lc_slab_rbtree_remove( &tree, &r );
+			assert( removed == present[ r.id ] );
+			present[ r.id ] = false;
+		}
+	}
+
+	assert( check_tree( &tree, present ) );
+
+	for( i = 0; i < KEYS; i++ )
+	{
+		key.id = i;
+		found  = lc_slab_rbtree_find( &tree, &key );
+		assert( (found != NULL) == present[ i ] );
+	}
+
+	key.id = KEYS / 2;
+	it = lc_slab_rbtree_lower_bound( &tree, &key );
+	assert( it != lc_slab_rbtree_end( ) && ((record_t*) lc_slab_rbtree_element( &tree, it ))->id >= key.id );
+
+	/* The slab is the whole tree: load it elsewhere with one copy... */
+	image = lc_slab_rbtree_image( &tree, &image_size );
+	lc_slab_rbtree_create( &copy, sizeof(record_t), NULL, record_compare, malloc, free );
+	assert( lc_slab_rbtree_load( &copy, image, image_size ) );
+	assert( lc_slab_rbtree_size( &copy ) == lc_slab_rbtree_size( &tree ) );
+	assert( check_tree( &copy, present ) );
+
+	/* ...or through a file. */
+	file = tmpfile( );
+	assert( file );
+	assert( lc_slab_rbtree_serialize( &tree, file ) );
+	rewind( file );
+	lc_slab_rbtree_clear( &copy );
+	assert( lc_slab_rbtree_unserialize( &copy, file ) );
+	fclose( file );
+	assert( check_tree( &copy, present ) );
+
+	/* An image with a link out of the slab is refused, and the tree
+	 * it was loaded into keeps what it had. */
+	{
+		uint8_t* bad = malloc( image_size );
+		lc_slab_rbnode_t* node;
+
+		assert( bad );
+		memcpy( bad, image, image_size );
+		node = (lc_slab_rbnode_t*) (bad + sizeof(lc_slab_rbtree_header_t) + tree.stride);
+		node->left = UINT32_MAX - 1;
+		assert( !lc_slab_rbtree_load( &copy, bad, image_size ) );
+		assert( check_tree( &copy, present ) );
+		free( bad );
+	}
+
+	/* A loaded tree is as good as the original, and removes don't move
+	 * the elements that stay. */
+	for( i = 1; !present[ i ]; i += 2 )
+	{
+	}
+	key.id = i;
+	found  = lc_slab_rbtree_find( &copy, &key );
+	assert( found );
+
+	for( i = 0; i < KEYS; i += 2 )
+	{
+		key.id = i;
+		assert( lc_slab_rbtree_remove( &copy, &key ) == present[ i ] );
+		present[ i ] = false;
+	}
+	assert( check_tree( &copy, present ) );
+	assert( lc_slab_rbtree_find( &copy, found ) == found );
+
+	printf( "%zu records in a %zu byte image, %zu nodes of %zu bytes.\n",
+	        lc_slab_rbtree_size( &tree ), image_size, tree.capacity, tree.stride );
+
+	lc_slab_rbtree_destroy( &copy );
+	lc_slab_rbtree_destroy( &tree );
+	free( present );
+	return 0;
+}
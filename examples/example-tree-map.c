@@ -29,6 +29,18 @@
 
 
 bool ip_destroy  ( void *key, void *value );
+static bool print_range_entry ( void *key, void *value, void *user_data );
+static int  compare_ips       ( const void *left, const void *right );
+
+/* Counts the tree map's live allocations through the allocator's context. */
+typedef struct counting_heap {
+	size_t allocations;
+	size_t live;
+} counting_heap_t;
+
+static void* counting_alloc   ( void *ctx, size_t size );
+static void* counting_realloc ( void *ctx, void *data, size_t old_size, size_t new_size );
+static void  counting_free    ( void *ctx, void *data );
 
 
 static const char *ips[] = {
@@ -60,10 +72,13 @@ int main( int argc, char *argv[] )
 	unsigned int i;
 	bool result;
 	lc_tree_map_iterator_t itr;
+	counting_heap_t heap = { 0, 0 };
+	lc_allocator_t allocator = { counting_alloc, counting_realloc, counting_free, NULL };
 
 	srand( time(NULL) );
 
-	lc_tree_map_create( &map, ip_destroy, (lc_tree_map_compare_fxn_t) strcmp, malloc, free );
+	allocator.ctx = &heap;
+	lc_tree_map_create_with_allocator( &map, ip_destroy, (lc_tree_map_compare_fxn_t) strcmp, &allocator );
 
 	for( i = 0; ips[ i ]; i++ )
 	{
@@ -115,6 +130,25 @@ int main( int argc, char *argv[] )
 	}
 	printf( "\n\n" );
 
+	{
+		/* Every address in 100.0.0.0 - 199.255.255.255 (as strings). */
+		size_t count = lc_tree_map_range( &map, "1", "2", print_range_entry, NULL );
+		lc_tree_map_iterator_t first;
+		lc_tree_map_iterator_t last;
+		size_t expected = 0;
+
+		for( i = 0; ips[ i ]; i++ )
+		{
+			if( ips[ i ][ 0 ] == '1' ) expected++;
+		}
+		assert( count == expected );
+
+		lc_tree_map_equal_range( &map, ips[ 0 ], &first, &last );
+		assert( first != lc_tree_map_end() && lc_tree_map_next( first ) == last );
+		assert( lc_tree_map_lower_bound( &map, "999" ) == lc_tree_map_end() );
+		printf( "\n\n" );
+	}
+
 	for( i = 0; ips[ i ]; i++ )
 	{
 		const char *ip = ips[ i ];
@@ -136,9 +170,44 @@ int main( int argc, char *argv[] )
 		printf( "\n" );
 	}
 
+	{
+		/* Bulk load the addresses in order. With an allocator each node
+		 * is still its own allocation, as the allocator may be a pool. */
+		void *keys[ sizeof(ips) / sizeof(ips[0]) ];
+		void *values[ sizeof(ips) / sizeof(ips[0]) ];
+		size_t allocations = heap.allocations;
+
+		for( i = 0; ips[ i ]; i++ )
+		{
+			keys[ i ]   = strdup( ips[ i ] );
+			values[ i ] = calloc( 1, sizeof(bool) );
+		}
+
+		result = lc_tree_map_build_sorted( &map, keys, values, i );
+		assert( !result ); /* not sorted */
+
+		qsort( keys, i, sizeof(void*), compare_ips );
+		result = lc_tree_map_build_sorted( &map, keys, values, i );
+		assert( result );
+		assert( lc_tree_map_size(&map) == i );
+		assert( heap.allocations == allocations + i );
 
+		for( itr = lc_tree_map_begin( &map ); lc_tree_map_next( itr ) != lc_tree_map_end( ); itr = lc_tree_map_next( itr ) )
+		{
+			assert( strcmp( itr->key, lc_tree_map_next( itr )->key ) < 0 );
+		}
+
+		result = lc_tree_map_remove( &map, ips[ 0 ] );
+		assert( result );
+		result = lc_tree_map_insert( &map, strdup( ips[ 0 ] ), calloc( 1, sizeof(bool) ) );
+		assert( result );
+		printf( "Bulk loaded %ld addresses.\n", lc_tree_map_size(&map) );
+	}
 
 	lc_tree_map_destroy( &map );
+
+	printf( "Allocations: %lu (%lu still live)\n", (unsigned long) heap.allocations, (unsigned long) heap.live );
+	assert( heap.live == 0 );
 	return 0;
 }
 
@@ -148,3 +217,36 @@ bool ip_destroy( void *key, void *value )
 	free( value );
 	return true;
 }
+
+static bool print_range_entry( void *key, void *value, void *user_data )
+{
+	printf( "  In range: %s\n", (char*) key );
+	return true;
+}
+
+static int compare_ips( const void *left, const void *right )
+{
+	return strcmp( *(const char* const*) left, *(const char* const*) right );
+}
+
+static void* counting_alloc( void *ctx, size_t size )
+{
+	counting_heap_t* heap = ctx;
+	heap->allocations++;
+	heap->live++;
+	return malloc( size );
+}
+
+static void* counting_realloc( void *ctx, void *data, size_t old_size, size_t new_size )
+{
+	(void) ctx;
+	(void) old_size;
+	return realloc( data, new_size );
+}
+
+static void counting_free( void *ctx, void *data )
+{
+	counting_heap_t* heap = ctx;
+	heap->live--;
+	free( data );
+}
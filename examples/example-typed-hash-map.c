@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <typed-hash-map.h>
+#include <hash-functions.h>
+
+#define COUNT   100000
+
+/* uint64_t -> uint64_t */
+LC_HASH_MAP_DECL( u64, uint64_t, uint64_t )
+LC_HASH_MAP_IMPL( u64, uint64_t, uint64_t, LC_HASH_MAP_IDENTITY_HASH, LC_HASH_MAP_EQUAL )
+
+/* const char* -> int */
+#define string_equal( left, right )   (strcmp( left, right ) == 0)
+LC_HASH_MAP_DECL( word, const char*, int )
+LC_HASH_MAP_IMPL( word, const char*, int, lc_string_hash, string_equal )
+
+/* Every key has the same hash, so every probe starts at the same entry. */
+#define constant_hash( key )   ((size_t) 42)
+LC_HASH_MAP_DECL( same, uint64_t, uint64_t )
+LC_HASH_MAP_IMPL( same, uint64_t, uint64_t, constant_hash, LC_HASH_MAP_EQUAL )
+
+static const char* words[] = {
+	"the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog",
+	"the", "end", NULL
+};
+
+int main( int argc, char *argv[] )
+{
+	u64_hash_map_t numbers;
+	word_hash_map_t counts;
+	same_hash_map_t collisions;
+	u64_hash_map_entry_t* entry;
+	uint64_t sum = 0;
+	uint64_t i;
+	size_t index;
+	int* count;
+	bool result;
+
+	result = u64_hash_map_create( &numbers, 0, NULL );
+	assert( result );
+
+	for( i = 0; i < COUNT; i++ )
+	{
+		result = u64_hash_map_insert( &numbers, i * 7, i );
+		assert( result );
+	}
+
+	assert( !u64_hash_map_insert( &numbers, 7, 0 ) );
+	assert( u64_hash_map_size( &numbers ) == COUNT );
+
+	for( i = 0; i < COUNT; i++ )
+	{
+		uint64_t* value = u64_hash_map_find( &numbers, i * 7 );
+		assert( value && *value == i );
+		assert( u64_hash_map_find( &numbers, i * 7 + 1 ) == NULL );
+	}
+
+	/* Remove the odd values. */
+	for( i = 1; i < COUNT; i += 2 )
+	{
+		result = u64_hash_map_remove( &numbers, i * 7 );
+		assert( result );
+	}
+
+	for( index = 0; (entry = u64_hash_map_next( &numbers, &index )) != NULL; )
+	{
+		assert( entry->value % 2 == 0 && entry->key == entry->value * 7 );
+		sum += entry->value;
+	}
+
+	assert( sum == (uint64_t) (COUNT / 2) * (COUNT / 2 - 1) );
+	printf( "%lu entries in %lu slots\n", (unsigned long) u64_hash_map_size( &numbers ), (unsigned long) numbers.capacity );
+	u64_hash_map_destroy( &numbers );
+
+	result = word_hash_map_create( &counts, 8, NULL );
+	assert( result );
+
+	for( index = 0; words[ index ]; index++ )
+	{
+		count = word_hash_map_find( &counts, words[ index ] );
+
+		if( count )
+		{
+			(*count)++;
+		}
+		else
+		{
+			result = word_hash_map_insert( &counts, words[ index ], 1 );
+			assert( result );
+		}
+	}
+
+	count = word_hash_map_find( &counts, "the" );
+	assert( count && *count == 3 );
+	result = word_hash_map_put( &counts, "the", 0 );
+	assert( result && *word_hash_map_find( &counts, "the" ) == 0 );
+	printf( "%lu distinct words\n", (unsigned long) word_hash_map_size( &counts ) );
+	word_hash_map_destroy( &counts );
+
+	/* 255 keys with one hash can't fit in the metadata byte's probe
+	 * distance at any capacity; the insert fails and the map keeps its
+	 * size rather than growing without end. */
+	result = same_hash_map_create( &collisions, 0, NULL );
+	assert( result );
+
+	for( i = 0; i < 300; i++ )
+	{
+		result = same_hash_map_insert( &collisions, i, i );
+		assert( result == (i < 255) );
+	}
+
+	assert( same_hash_map_size( &collisions ) == 255 );
+	assert( collisions.capacity <= 1024 );
+	for( i = 0; i < 255; i++ )
+	{
+		assert( *same_hash_map_find( &collisions, i ) == i );
+	}
+	printf( "%lu colliding keys in %lu slots\n", (unsigned long) same_hash_map_size( &collisions ), (unsigned long) collisions.capacity );
+	same_hash_map_destroy( &collisions );
+
+	return 0;
+}
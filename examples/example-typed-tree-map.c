@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <typed-tree-map.h>
+
+#define COUNT   20000
+
+/* An order book: price -> quantity */
+LC_TREE_MAP_DECL( book, int64_t, uint32_t )
+LC_TREE_MAP_IMPL( book, int64_t, uint32_t, LC_TREE_MAP_COMPARE )
+
+/* Returns the black height, or -1 if the tree isn't a valid red-black tree. */
+static int black_height( const book_tree_map_node_t* p_node )
+{
+	int left;
+	int right;
+
+	if( !p_node )
+	{
+		return 1;
+	}
+
+	if( p_node->is_red && ((p_node->left && p_node->left->is_red) || (p_node->right && p_node->right->is_red)) )
+	{
+		return -1;
+	}
+
+	left  = black_height( p_node->left );
+	right = black_height( p_node->right );
+
+	if( left < 0 || left != right )
+	{
+		return -1;
+	}
+
+	return left + (p_node->is_red ? 0 : 1);
+}
+
+int main( int argc, char *argv[] )
+{
+	book_tree_map_t bids;
+	book_tree_map_node_t* p_node;
+	int64_t previous;
+	size_t count;
+	int i;
+	bool result;
+
+	book_tree_map_create( &bids, NULL );
+	srand( 0 );
+
+	for( i = 0; i < COUNT; i++ )
+	{
+		int64_t price = rand() % (4 * COUNT);
+
+		if( !book_tree_map_insert( &bids, price, 100 ) )
+		{
+			/* Already in the book; add to the quantity. */
+			uint32_t* quantity = book_tree_map_find( &bids, price );
+			assert( quantity );
+			*quantity += 100;
+		}
+	}
+
+	assert( black_height( bids.root ) > 0 );
+
+	/* Pull every odd price level. */
+	for( i = 1; i < 4 * COUNT; i += 2 )
+	{
+		book_tree_map_remove( &bids, i );
+	}
+
+	assert( black_height( bids.root ) > 0 );
+
+	previous = -1;
+	count    = 0;
+	for( p_node = book_tree_map_first( &bids ); p_node; p_node = book_tree_map_next( p_node ) )
+	{
+		assert( p_node->key % 2 == 0 );
+		assert( p_node->key > previous );
+		previous = p_node->key;
+		count++;
+	}
+	assert( count == book_tree_map_size( &bids ) );
+
+	p_node = book_tree_map_last( &bids );
+	printf( "%lu price levels, best bid %ld x %u\n", (unsigned long) count, (long) p_node->key, p_node->value );
+
+	result = book_tree_map_put( &bids, p_node->key, 1 );
+	assert( result && *book_tree_map_find( &bids, p_node->key ) == 1 );
+	assert( book_tree_map_previous( book_tree_map_first( &bids ) ) == NULL );
+
+	book_tree_map_destroy( &bids );
+	assert( book_tree_map_size( &bids ) == 0 );
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "alloc.h"
+
+static void* std_alloc( void *ctx, size_t size )
+{
+	(void) ctx;
+	return malloc( size );
+}
+
+static void* std_realloc( void *ctx, void *data, size_t old_size, size_t new_size )
+{
+	(void) ctx;
+	(void) old_size;
+	return realloc( data, new_size );
+}
+
+static void std_free( void *ctx, void *data )
+{
+	(void) ctx;
+	free( data );
+}
+
+const lc_allocator_t lc_std_allocator = {
+	std_alloc,
+	std_realloc,
+	std_free,
+	NULL
+};
+
+void lc_allocator_init( lc_allocator_t* p_allocator, const lc_allocator_t* source )
+{
+	if( source )
+	{
+		assert( source->alloc && source->realloc && source->free );
+		*p_allocator = *source;
+	}
+	else
+	{
+		memset( p_allocator, 0, sizeof(lc_allocator_t) );
+	}
+}
@@ -24,6 +24,10 @@
 
 #include <stdlib.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @file alloc.h
  * @brief Memory allocation and deallocation interface functions and macros.
@@ -46,6 +50,52 @@ typedef void* (*lc_alloc_fxn_t) ( size_t size );
  */
 typedef void  (*lc_free_fxn_t)  ( void *data );
 
+/**
+ * lc_allocator_t is a memory allocator that passes a context pointer (an
+ * arena, a pool, a per-thread heap, etc.) to each of its functions.  The
+ * realloc function is told the old size of the block so that allocators
+ * which do not track block sizes can still copy the contents.
+ *
+ * Containers created with one of the *_create_with_allocator() functions
+ * use the allocator for all of their memory instead of their
+ * lc_alloc_fxn_t and lc_free_fxn_t callbacks.
+ */
+typedef void* (*lc_allocator_alloc_fxn_t)   ( void *ctx, size_t size );
+typedef void* (*lc_allocator_realloc_fxn_t) ( void *ctx, void *data, size_t old_size, size_t new_size );
+typedef void  (*lc_allocator_free_fxn_t)    ( void *ctx, void *data );
+
+typedef struct lc_allocator {
+	lc_allocator_alloc_fxn_t   alloc;
+	lc_allocator_realloc_fxn_t realloc;
+	lc_allocator_free_fxn_t    free;
+	void*                      ctx;
+} lc_allocator_t;
+
+/**
+ * An allocator that uses the standard C library's malloc(), realloc()
+ * and free().
+ */
+extern const lc_allocator_t lc_std_allocator;
+
+/**
+ * Copy an allocator into a container. Passing NULL leaves the container
+ * on its lc_alloc_fxn_t and lc_free_fxn_t callbacks.
+ */
+void lc_allocator_init ( lc_allocator_t* p_allocator, const lc_allocator_t* source );
+
+#define lc_allocator_is_set( p_allocator )  ((p_allocator)->alloc != NULL)
+
+/*
+ * These dispatch to the allocator when one is set and otherwise to the
+ * container's legacy callbacks.
+ */
+#define lc_allocator_alloc( p_allocator, fallback_alloc, size ) \
+	(lc_allocator_is_set(p_allocator) ? (p_allocator)->alloc( (p_allocator)->ctx, (size) ) : (fallback_alloc)( size ))
+#define lc_allocator_realloc( p_allocator, data, old_size, new_size ) \
+	(lc_allocator_is_set(p_allocator) ? (p_allocator)->realloc( (p_allocator)->ctx, (data), (old_size), (new_size) ) : realloc( (data), (new_size) ))
+#define lc_allocator_free( p_allocator, fallback_free, data ) \
+	(lc_allocator_is_set(p_allocator) ? (p_allocator)->free( (p_allocator)->ctx, (data) ) : (fallback_free)( data ))
+
 /**
  * lc_alloc_type(type) is a macro for allocating enough memory for the type
  * passed to lc_alloc_type().
@@ -62,5 +112,7 @@ typedef void  (*lc_free_fxn_t)  ( void *data );
 #define lc_destruct( var, ... )    var##_deinitialize( __VA_ARGS__ )
 #endif
 
-
+#ifdef __cplusplus
+}
+#endif
 #endif /* _LC_ALLOC_H_ */
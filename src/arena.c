@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "arena.h"
+
+struct lc_arena_chunk {
+	struct lc_arena_chunk* next;
+	size_t size; /* usable bytes after the header */
+};
+
+#define chunk_begin( p_chunk )          ((unsigned char*) ((p_chunk) + 1))
+#define chunk_end( p_chunk )            (chunk_begin(p_chunk) + (p_chunk)->size)
+#define arena_is_power_of_2( x )        (((x) & ((x) - 1)) == 0)
+#define arena_align_up( p, alignment )  (((uintptr_t) (p) + ((alignment) - 1)) & ~((uintptr_t) (alignment) - 1))
+
+static lc_arena_chunk_t* arena_chunk_create( lc_arena_t* p_arena, size_t size )
+{
+	lc_arena_chunk_t* p_chunk;
+
+	if( size < p_arena->chunk_size )
+	{
+		size = p_arena->chunk_size;
+	}
+
+	p_chunk = (lc_arena_chunk_t*) p_arena->alloc( sizeof(lc_arena_chunk_t) + size );
+
+	if( p_chunk )
+	{
+		p_chunk->next = NULL;
+		p_chunk->size = size;
+	}
+
+	return p_chunk;
+}
+
+static inline void arena_use_chunk( lc_arena_t* p_arena, lc_arena_chunk_t* p_chunk )
+{
+	p_arena->current = p_chunk;
+	p_arena->ptr     = chunk_begin( p_chunk );
+	p_arena->end     = chunk_end( p_chunk );
+}
+
+/*
+ * The current chunk is full. Move on to the next chunk if it is large
+ * enough, otherwise put a new chunk after the current one.
+ */
+static void* arena_alloc_slow( lc_arena_t* p_arena, size_t size, size_t alignment )
+{
+	lc_arena_chunk_t* p_next = p_arena->current->next;
+	size_t needed            = size + alignment - 1;
+	unsigned char* p;
+
+	if( needed < size )
+	{
+		return NULL; /* overflow */
+	}
+
+	if( !p_next || p_next->size < needed )
+	{
+		lc_arena_chunk_t* p_chunk = arena_chunk_create( p_arena, needed );
+
+		if( !p_chunk )
+		{
+			return NULL;
+		}
+
+		p_chunk->next          = p_next;
+		p_arena->current->next = p_chunk;
+		p_next                 = p_chunk;
+	}
+
+	arena_use_chunk( p_arena, p_next );
+
+	p            = (unsigned char*) arena_align_up( p_arena->ptr, alignment );
+	p_arena->ptr = p + size;
+	assert( p_arena->ptr <= p_arena->end );
+
+	return p;
+}
+
+bool lc_arena_create( lc_arena_t* p_arena, size_t chunk_size, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	lc_arena_chunk_t* p_chunk;
+
+	assert( p_arena );
+	assert( alloc );
+	assert( free );
+
+	p_arena->chunk_size = chunk_size > 0 ? chunk_size : LC_ARENA_CHUNK_SIZE;
+	p_arena->alloc      = alloc;
+	p_arena->free       = free;
+
+	p_chunk = arena_chunk_create( p_arena, p_arena->chunk_size );
+
+	if( p_chunk )
+	{
+		p_arena->first = p_chunk;
+		arena_use_chunk( p_arena, p_chunk );
+	}
+
+	return p_chunk != NULL;
+}
+
+void lc_arena_destroy( lc_arena_t* p_arena )
+{
+	lc_arena_chunk_t* p_chunk;
+
+	assert( p_arena );
+	p_chunk = p_arena->first;
+
+	while( p_chunk )
+	{
+		lc_arena_chunk_t* p_next = p_chunk->next;
+		p_arena->free( p_chunk );
+		p_chunk = p_next;
+	}
+
+	p_arena->first   = NULL;
+	p_arena->current = NULL;
+	p_arena->ptr     = NULL;
+	p_arena->end     = NULL;
+}
+
+void* lc_arena_alloc( lc_arena_t* p_arena, size_t size )
+{
+	return lc_arena_alloc_aligned( p_arena, size, LC_ARENA_ALIGNMENT );
+}
+
+void* lc_arena_alloc_aligned( lc_arena_t* p_arena, size_t size, size_t alignment )
+{
+	unsigned char* p;
+
+	assert( p_arena );
+	assert( alignment > 0 && arena_is_power_of_2(alignment) );
+
+	p = (unsigned char*) arena_align_up( p_arena->ptr, alignment );
+
+	if( p <= p_arena->end && size <= (size_t) (p_arena->end - p) )
+	{
+		p_arena->ptr = p + size;
+		return p;
+	}
+
+	return arena_alloc_slow( p_arena, size, alignment );
+}
+
+void* lc_arena_realloc( lc_arena_t* p_arena, void* data, size_t old_size, size_t new_size )
+{
+	unsigned char* p = data;
+	void* result;
+
+	assert( p_arena );
+
+	if( !p )
+	{
+		return lc_arena_alloc( p_arena, new_size );
+	}
+
+	if( p + old_size == p_arena->ptr && new_size <= (size_t) (p_arena->end - p) )
+	{
+		/* The last allocation can grow or shrink in place. */
+		p_arena->ptr = p + new_size;
+		return data;
+	}
+
+	if( new_size <= old_size )
+	{
+		return data;
+	}
+
+	result = lc_arena_alloc( p_arena, new_size );
+
+	if( result )
+	{
+		memcpy( result, data, old_size );
+	}
+
+	return result;
+}
+
+void lc_arena_reset( lc_arena_t* p_arena )
+{
+	assert( p_arena );
+	arena_use_chunk( p_arena, p_arena->first );
+}
+
+void lc_arena_trim( lc_arena_t* p_arena )
+{
+	lc_arena_chunk_t* p_chunk;
+
+	assert( p_arena );
+	p_chunk = p_arena->current->next;
+	p_arena->current->next = NULL;
+
+	while( p_chunk )
+	{
+		lc_arena_chunk_t* p_next = p_chunk->next;
+		p_arena->free( p_chunk );
+		p_chunk = p_next;
+	}
+}
+
+void lc_arena_rollback( lc_arena_t* p_arena, const lc_arena_checkpoint_t* p_checkpoint )
+{
+	assert( p_arena );
+	assert( p_checkpoint );
+	assert( p_checkpoint->ptr >= chunk_begin(p_checkpoint->chunk) && p_checkpoint->ptr <= chunk_end(p_checkpoint->chunk) );
+
+	p_arena->current = p_checkpoint->chunk;
+	p_arena->ptr     = p_checkpoint->ptr;
+	p_arena->end     = chunk_end( p_checkpoint->chunk );
+}
+
+static void* arena_allocator_alloc( void* ctx, size_t size )
+{
+	return lc_arena_alloc( (lc_arena_t*) ctx, size );
+}
+
+static void* arena_allocator_realloc( void* ctx, void* data, size_t old_size, size_t new_size )
+{
+	return lc_arena_realloc( (lc_arena_t*) ctx, data, old_size, new_size );
+}
+
+static void arena_allocator_free( void* ctx, void* data )
+{
+	/* Memory is released by lc_arena_reset() or lc_arena_rollback(). */
+	(void) ctx;
+	(void) data;
+}
+
+void lc_arena_allocator( lc_arena_t* p_arena, lc_allocator_t* p_allocator )
+{
+	assert( p_arena );
+	assert( p_allocator );
+
+	p_allocator->alloc   = arena_allocator_alloc;
+	p_allocator->realloc = arena_allocator_realloc;
+	p_allocator->free    = arena_allocator_free;
+	p_allocator->ctx     = p_arena;
+}
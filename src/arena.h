@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_ARENA_H_
+#define _LC_ARENA_H_
+/**
+ * @file arena.h
+ * @brief A region (arena) allocator.
+ *
+ * Memory is handed out by bumping a pointer through large chunks. Single
+ * allocations are never released; instead everything allocated since a
+ * checkpoint can be rolled back, or the whole arena can be reset in O(1).
+ * Chunks are kept across resets so a reused arena stops calling the
+ * underlying allocator altogether.
+ *
+ * Containers use an arena through lc_arena_allocator(), whose free
+ * function does nothing.
+ *
+ * @defgroup lc_arena Arena
+ * @ingroup Memory
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "alloc.h"
+
+#ifndef LC_ARENA_CHUNK_SIZE
+#define LC_ARENA_CHUNK_SIZE       (64 * 1024)
+#endif
+
+/* Alignment of lc_arena_alloc(); must be a power of two. */
+#ifndef LC_ARENA_ALIGNMENT
+#define LC_ARENA_ALIGNMENT        (2 * sizeof(void*))
+#endif
+
+struct lc_arena_chunk;
+typedef struct lc_arena_chunk lc_arena_chunk_t;
+
+/**
+ * lc_arena_t is a region allocator object.
+ */
+typedef struct lc_arena {
+	lc_arena_chunk_t* first;   /* chunks in the order they are used */
+	lc_arena_chunk_t* current;
+	unsigned char*    ptr;
+	unsigned char*    end;
+	size_t            chunk_size;
+
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+} lc_arena_t;
+
+/**
+ * lc_arena_checkpoint_t records the state of an arena so that everything
+ * allocated after it can be released with lc_arena_rollback().
+ */
+typedef struct lc_arena_checkpoint {
+	lc_arena_chunk_t* chunk;
+	unsigned char*    ptr;
+} lc_arena_checkpoint_t;
+
+/**
+ * Create an arena. Chunks are at least chunk_size bytes (or
+ * LC_ARENA_CHUNK_SIZE if zero) and are obtained from alloc and free.
+ */
+bool  lc_arena_create        ( lc_arena_t* p_arena, size_t chunk_size, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Destroy an arena and release every chunk.
+ */
+void  lc_arena_destroy       ( lc_arena_t* p_arena );
+/**
+ * Allocate size bytes aligned to LC_ARENA_ALIGNMENT.
+ */
+void* lc_arena_alloc         ( lc_arena_t* p_arena, size_t size );
+/**
+ * Allocate size bytes aligned to alignment, which must be a power of two.
+ */
+void* lc_arena_alloc_aligned ( lc_arena_t* p_arena, size_t size, size_t alignment );
+/**
+ * Resize the most recent allocation in place when possible, otherwise
+ * copy it to a new allocation.
+ */
+void* lc_arena_realloc       ( lc_arena_t* p_arena, void* data, size_t old_size, size_t new_size );
+/**
+ * Release everything that was allocated. The chunks are kept. O(1)
+ */
+void  lc_arena_reset         ( lc_arena_t* p_arena );
+/**
+ * Release the chunks that are not in use (e.g. after a reset).
+ */
+void  lc_arena_trim          ( lc_arena_t* p_arena );
+
+/**
+ * Get an lc_allocator_t that allocates from the arena. Pass it to the
+ * *_create_with_allocator() functions of the containers.
+ */
+void  lc_arena_allocator     ( lc_arena_t* p_arena, lc_allocator_t* p_allocator );
+
+#define lc_arena_checkpoint( p_arena, p_checkpoint ) \
+	do { (p_checkpoint)->chunk = (p_arena)->current; (p_checkpoint)->ptr = (p_arena)->ptr; } while( 0 )
+
+/**
+ * Release everything allocated since the checkpoint was taken. The
+ * checkpoint must not be older than the last reset or trim.
+ */
+void  lc_arena_rollback      ( lc_arena_t* p_arena, const lc_arena_checkpoint_t* p_checkpoint );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_ARENA_H_ */
@@ -27,7 +27,10 @@
 #include <string.h>
 #endif
 
-bool lc_array_create( lc_array_t* p_array, size_t element_size, size_t size, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+#define array_alloc( p_array, size )   lc_allocator_alloc( &(p_array)->allocator, (p_array)->alloc, size )
+#define array_free( p_array, ptr )     lc_allocator_free( &(p_array)->allocator, (p_array)->free, ptr )
+
+static bool array_create( lc_array_t* p_array, size_t element_size, size_t size, lc_alloc_fxn_t alloc, lc_free_fxn_t free, const lc_allocator_t* allocator )
 {
 	assert( p_array );
 
@@ -35,7 +38,8 @@ bool lc_array_create( lc_array_t* p_array, size_t element_size, size_t size, lc_
 	p_array->size         = size;
 	p_array->alloc        = alloc;
 	p_array->free         = free;
-	p_array->arr          = p_array->alloc( lc_array_element_size(p_array) * lc_array_size(p_array) );
+	lc_allocator_init( &p_array->allocator, allocator );
+	p_array->arr          = array_alloc( p_array, lc_array_element_size(p_array) * lc_array_size(p_array) );
 
 	#ifdef _DEBUG_VECTOR
 	memset( p_array->arr, 0, lc_array_element_size(p_array) * lc_array_size(p_array) );
@@ -46,11 +50,21 @@ bool lc_array_create( lc_array_t* p_array, size_t element_size, size_t size, lc_
 	return p_array->arr != NULL;
 }
 
+bool lc_array_create( lc_array_t* p_array, size_t element_size, size_t size, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	return array_create( p_array, element_size, size, alloc, free, NULL );
+}
+
+bool lc_array_create_with_allocator( lc_array_t* p_array, size_t element_size, size_t size, const lc_allocator_t* allocator )
+{
+	return array_create( p_array, element_size, size, malloc, free, allocator );
+}
+
 void lc_array_destroy( lc_array_t* p_array )
 {
 	assert( p_array );
 
-	p_array->free( p_array->arr );
+	array_free( p_array, p_array->arr );
 
 	#ifdef _DEBUG_VECTOR
 	p_array->element_size = 0L;
@@ -65,10 +79,17 @@ bool lc_array_resize( lc_array_t* p_array, size_t new_size )
 
 	if( lc_array_size(p_array) != new_size )
 	{
-		p_array->size  = new_size;
-		p_array->arr   = realloc( p_array->arr, p_array->element_size * lc_array_size(p_array) );
+		void* arr = lc_allocator_realloc( &p_array->allocator, p_array->arr,
+		                                  p_array->element_size * lc_array_size(p_array),
+		                                  p_array->element_size * new_size );
 
-		result = p_array->arr != NULL;
+		result = arr != NULL;
+
+		if( result )
+		{
+			p_array->arr  = arr;
+			p_array->size = new_size;
+		}
 	}
 
 	return result;
@@ -55,6 +55,7 @@ typedef bool (*lc_array_unserialize_fxn_t)( void *p_array );
 typedef struct lc_array {
 	lc_alloc_fxn_t alloc;
 	lc_free_fxn_t  free;
+	lc_allocator_t allocator;
 
 	uint8_t*  arr;
 	size_t element_size;
@@ -76,6 +77,19 @@ typedef struct lc_array {
  */
 bool lc_array_create ( lc_array_t* p_array, size_t element_size, size_t size, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
 
+/**
+ * Create a fixed-length array collection object whose memory comes from
+ * an allocator.
+ *
+ * @param p_array An lc_array_t object.
+ * @param element_size The size of each element in the array.
+ * @param size The length of the array.
+ * @param allocator The allocator to use for the array. If NULL, malloc()
+ *                  and free() are used.
+ * @return true on success, false on failure.
+ */
+bool lc_array_create_with_allocator ( lc_array_t* p_array, size_t element_size, size_t size, const lc_allocator_t* allocator );
+
 /**
  * Destroy a fixed-length array collection object.
  *
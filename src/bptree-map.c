@@ -0,0 +1,629 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "bptree-map.h"
+
+#if LC_BPTREE_MAP_MAX_KEYS < 3
+#error "LC_BPTREE_MAP_MAX_KEYS must be at least 3"
+#endif
+
+#if defined(LC_BPTREE_MAP_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
+	#define DESTROY_CHECK( code ) \
+		if( p_map->destroy ) \
+		{ \
+			code \
+		}
+#else
+	#define DESTROY_CHECK( code ) \
+		code
+#endif
+
+#define BPT_MAX     LC_BPTREE_MAP_MAX_KEYS
+#define BPT_MIN     ((LC_BPTREE_MAP_MAX_KEYS - 1) / 2) /* except for the root */
+
+#define bpt_alloc( p_map, size )  lc_allocator_alloc( &(p_map)->allocator, (p_map)->alloc, size )
+#define bpt_free( p_map, ptr )    lc_allocator_free( &(p_map)->allocator, (p_map)->free, ptr )
+
+/*
+ * Branches hold count keys and count + 1 children; child i holds the keys
+ * k with keys[i - 1] <= k < keys[i]. A branch key is always a pointer to
+ * a key that is still stored in some leaf.
+ */
+struct lc_bptree_map_node {
+	size_t count;
+	bool   is_leaf;
+	void*  keys[ BPT_MAX ];
+};
+
+typedef struct bpt_leaf {
+	lc_bptree_map_node_t base;
+	void*  values[ BPT_MAX ];
+	struct bpt_leaf* next;
+} bpt_leaf_t;
+
+typedef struct bpt_branch {
+	lc_bptree_map_node_t  base;
+	lc_bptree_map_node_t* children[ BPT_MAX + 1 ];
+} bpt_branch_t;
+
+#define bpt_as_leaf( p_node )     ((bpt_leaf_t*) (p_node))
+#define bpt_as_branch( p_node )   ((bpt_branch_t*) (p_node))
+
+
+static inline bpt_leaf_t* bpt_leaf_create( lc_bptree_map_t* p_map )
+{
+	bpt_leaf_t* leaf = (bpt_leaf_t*) bpt_alloc( p_map, sizeof(bpt_leaf_t) );
+
+	if( leaf )
+	{
+		leaf->base.count   = 0;
+		leaf->base.is_leaf = true;
+		leaf->next         = NULL;
+	}
+
+	return leaf;
+}
+
+static inline bpt_branch_t* bpt_branch_create( lc_bptree_map_t* p_map )
+{
+	bpt_branch_t* branch = (bpt_branch_t*) bpt_alloc( p_map, sizeof(bpt_branch_t) );
+
+	if( branch )
+	{
+		branch->base.count   = 0;
+		branch->base.is_leaf = false;
+	}
+
+	return branch;
+}
+
+/* Index of the first key that is not less than key. */
+static inline size_t bpt_lower_bound( const lc_bptree_map_t* p_map, const lc_bptree_map_node_t* p_node, const void *key )
+{
+	size_t low  = 0;
+	size_t high = p_node->count;
+
+	while( low < high )
+	{
+		size_t mid = low + (high - low) / 2;
+
+		if( p_map->compare( p_node->keys[ mid ], key ) < 0 )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+/* Index of the child whose range holds key (the number of keys <= key). */
+static inline size_t bpt_child_index( const lc_bptree_map_t* p_map, const lc_bptree_map_node_t* p_node, const void *key )
+{
+	size_t low  = 0;
+	size_t high = p_node->count;
+
+	while( low < high )
+	{
+		size_t mid = low + (high - low) / 2;
+
+		if( p_map->compare( key, p_node->keys[ mid ] ) < 0 )
+		{
+			high = mid;
+		}
+		else
+		{
+			low = mid + 1;
+		}
+	}
+
+	return low;
+}
+
+static inline lc_bptree_map_node_t* bpt_find_leaf( const lc_bptree_map_t* p_map, const void *key )
+{
+	lc_bptree_map_node_t* p_node = p_map->root;
+
+	while( p_node && !p_node->is_leaf )
+	{
+		p_node = bpt_as_branch(p_node)->children[ bpt_child_index( p_map, p_node, key ) ];
+	}
+
+	return p_node;
+}
+
+/* Split the full child i of parent in two. */
+static bool bpt_split_child( lc_bptree_map_t* p_map, bpt_branch_t* parent, size_t i )
+{
+	lc_bptree_map_node_t* child = parent->children[ i ];
+	lc_bptree_map_node_t* right;
+	void* separator;
+
+	assert( child->count == BPT_MAX );
+
+	if( child->is_leaf )
+	{
+		bpt_leaf_t* left     = bpt_as_leaf( child );
+		bpt_leaf_t* new_leaf = bpt_leaf_create( p_map );
+		size_t keep          = (BPT_MAX + 1) / 2;
+
+		if( !new_leaf )
+		{
+			return false;
+		}
+
+		new_leaf->base.count = BPT_MAX - keep;
+		memcpy( new_leaf->base.keys, left->base.keys + keep, new_leaf->base.count * sizeof(void*) );
+		memcpy( new_leaf->values, left->values + keep, new_leaf->base.count * sizeof(void*) );
+		new_leaf->next   = left->next;
+		left->next       = new_leaf;
+		left->base.count = keep;
+
+		/* Leaves keep all of their keys; the first key of the new leaf is copied up. */
+		separator = new_leaf->base.keys[ 0 ];
+		right     = &new_leaf->base;
+	}
+	else
+	{
+		bpt_branch_t* left       = bpt_as_branch( child );
+		bpt_branch_t* new_branch = bpt_branch_create( p_map );
+		size_t mid               = BPT_MAX / 2;
+
+		if( !new_branch )
+		{
+			return false;
+		}
+
+		new_branch->base.count = BPT_MAX - mid - 1;
+		memcpy( new_branch->base.keys, left->base.keys + mid + 1, new_branch->base.count * sizeof(void*) );
+		memcpy( new_branch->children, left->children + mid + 1, (new_branch->base.count + 1) * sizeof(lc_bptree_map_node_t*) );
+		left->base.count = mid;
+
+		/* The middle key moves up. */
+		separator = left->base.keys[ mid ];
+		right     = &new_branch->base;
+	}
+
+	memmove( parent->base.keys + i + 1, parent->base.keys + i, (parent->base.count - i) * sizeof(void*) );
+	memmove( parent->children + i + 2, parent->children + i + 1, (parent->base.count - i) * sizeof(lc_bptree_map_node_t*) );
+	parent->base.keys[ i ]    = separator;
+	parent->children[ i + 1 ] = right;
+	parent->base.count++;
+
+	return true;
+}
+
+static void bpt_borrow_from_left( bpt_branch_t* parent, size_t i )
+{
+	lc_bptree_map_node_t* child = parent->children[ i ];
+	lc_bptree_map_node_t* left  = parent->children[ i - 1 ];
+
+	memmove( child->keys + 1, child->keys, child->count * sizeof(void*) );
+
+	if( child->is_leaf )
+	{
+		memmove( bpt_as_leaf(child)->values + 1, bpt_as_leaf(child)->values, child->count * sizeof(void*) );
+		child->keys[ 0 ]                 = left->keys[ left->count - 1 ];
+		bpt_as_leaf(child)->values[ 0 ]  = bpt_as_leaf(left)->values[ left->count - 1 ];
+		parent->base.keys[ i - 1 ]       = child->keys[ 0 ];
+	}
+	else
+	{
+		memmove( bpt_as_branch(child)->children + 1, bpt_as_branch(child)->children, (child->count + 1) * sizeof(lc_bptree_map_node_t*) );
+		child->keys[ 0 ]                  = parent->base.keys[ i - 1 ];
+		bpt_as_branch(child)->children[ 0 ] = bpt_as_branch(left)->children[ left->count ];
+		parent->base.keys[ i - 1 ]        = left->keys[ left->count - 1 ];
+	}
+
+	left->count--;
+	child->count++;
+}
+
+static void bpt_borrow_from_right( bpt_branch_t* parent, size_t i )
+{
+	lc_bptree_map_node_t* child = parent->children[ i ];
+	lc_bptree_map_node_t* right = parent->children[ i + 1 ];
+
+	if( child->is_leaf )
+	{
+		child->keys[ child->count ]                = right->keys[ 0 ];
+		bpt_as_leaf(child)->values[ child->count ] = bpt_as_leaf(right)->values[ 0 ];
+		memmove( bpt_as_leaf(right)->values, bpt_as_leaf(right)->values + 1, (right->count - 1) * sizeof(void*) );
+		memmove( right->keys, right->keys + 1, (right->count - 1) * sizeof(void*) );
+		parent->base.keys[ i ] = right->keys[ 0 ];
+	}
+	else
+	{
+		child->keys[ child->count ]                       = parent->base.keys[ i ];
+		bpt_as_branch(child)->children[ child->count + 1 ] = bpt_as_branch(right)->children[ 0 ];
+		parent->base.keys[ i ] = right->keys[ 0 ];
+		memmove( right->keys, right->keys + 1, (right->count - 1) * sizeof(void*) );
+		memmove( bpt_as_branch(right)->children, bpt_as_branch(right)->children + 1, right->count * sizeof(lc_bptree_map_node_t*) );
+	}
+
+	right->count--;
+	child->count++;
+}
+
+/* Merge child i + 1 of parent into child i. */
+static void bpt_merge( lc_bptree_map_t* p_map, bpt_branch_t* parent, size_t i )
+{
+	lc_bptree_map_node_t* left  = parent->children[ i ];
+	lc_bptree_map_node_t* right = parent->children[ i + 1 ];
+
+	if( left->is_leaf )
+	{
+		memcpy( left->keys + left->count, right->keys, right->count * sizeof(void*) );
+		memcpy( bpt_as_leaf(left)->values + left->count, bpt_as_leaf(right)->values, right->count * sizeof(void*) );
+		left->count += right->count;
+		bpt_as_leaf(left)->next = bpt_as_leaf(right)->next;
+	}
+	else
+	{
+		left->keys[ left->count ] = parent->base.keys[ i ];
+		memcpy( left->keys + left->count + 1, right->keys, right->count * sizeof(void*) );
+		memcpy( bpt_as_branch(left)->children + left->count + 1, bpt_as_branch(right)->children, (right->count + 1) * sizeof(lc_bptree_map_node_t*) );
+		left->count += right->count + 1;
+	}
+
+	assert( left->count <= BPT_MAX );
+
+	memmove( parent->base.keys + i, parent->base.keys + i + 1, (parent->base.count - i - 1) * sizeof(void*) );
+	memmove( parent->children + i + 1, parent->children + i + 2, (parent->base.count - i - 1) * sizeof(lc_bptree_map_node_t*) );
+	parent->base.count--;
+
+	bpt_free( p_map, right );
+}
+
+/*
+ * Make sure child i of parent has more than the minimum number of keys
+ * before descending into it. Returns the index of the child that now
+ * holds the range that child i held.
+ */
+static size_t bpt_fill_child( lc_bptree_map_t* p_map, bpt_branch_t* parent, size_t i )
+{
+	if( i > 0 && parent->children[ i - 1 ]->count > BPT_MIN )
+	{
+		bpt_borrow_from_left( parent, i );
+	}
+	else if( i < parent->base.count && parent->children[ i + 1 ]->count > BPT_MIN )
+	{
+		bpt_borrow_from_right( parent, i );
+	}
+	else if( i > 0 )
+	{
+		bpt_merge( p_map, parent, --i );
+	}
+	else
+	{
+		bpt_merge( p_map, parent, i );
+	}
+
+	return i;
+}
+
+static void bpt_node_destroy( lc_bptree_map_t* p_map, lc_bptree_map_node_t* p_node )
+{
+	size_t i;
+
+	if( p_node->is_leaf )
+	{
+		for( i = 0; i < p_node->count; i++ )
+		{
+			DESTROY_CHECK(
+				p_map->destroy( p_node->keys[ i ], bpt_as_leaf(p_node)->values[ i ] );
+			);
+		}
+	}
+	else
+	{
+		for( i = 0; i <= p_node->count; i++ )
+		{
+			bpt_node_destroy( p_map, bpt_as_branch(p_node)->children[ i ] );
+		}
+	}
+
+	bpt_free( p_map, p_node );
+}
+
+void lc_bptree_map_create( lc_bptree_map_t* p_map, lc_bptree_map_element_fxn_t destroy, lc_bptree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	assert( p_map );
+#ifndef LC_BPTREE_MAP_DESTROY_CHECK
+	assert( destroy );
+#endif
+	assert( compare );
+	p_map->root    = NULL;
+	p_map->first   = NULL;
+	p_map->size    = 0;
+	p_map->height  = 0;
+	p_map->compare = compare;
+	p_map->destroy = destroy;
+	p_map->alloc   = alloc;
+	p_map->free    = free;
+	lc_allocator_init( &p_map->allocator, NULL );
+}
+
+void lc_bptree_map_create_with_allocator( lc_bptree_map_t* p_map, lc_bptree_map_element_fxn_t destroy, lc_bptree_map_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	lc_bptree_map_create( p_map, destroy, compare, malloc, free );
+	lc_allocator_init( &p_map->allocator, allocator );
+}
+
+void lc_bptree_map_destroy( lc_bptree_map_t* p_map )
+{
+	lc_bptree_map_clear( p_map );
+}
+
+bool lc_bptree_map_insert( lc_bptree_map_t* p_map, const void *key, const void *value )
+{
+	lc_bptree_map_node_t* p_node;
+	size_t index;
+
+	assert( p_map );
+
+	if( !p_map->root )
+	{
+		bpt_leaf_t* leaf = bpt_leaf_create( p_map );
+
+		if( !leaf )
+		{
+			return false;
+		}
+
+		p_map->root   = &leaf->base;
+		p_map->first  = &leaf->base;
+		p_map->height = 1;
+	}
+
+	/* Full nodes are split on the way down so a split never has to go back up. */
+	if( p_map->root->count == BPT_MAX )
+	{
+		bpt_branch_t* root = bpt_branch_create( p_map );
+
+		if( !root )
+		{
+			return false;
+		}
+
+		root->children[ 0 ] = p_map->root;
+
+		if( !bpt_split_child( p_map, root, 0 ) )
+		{
+			bpt_free( p_map, root );
+			return false;
+		}
+
+		p_map->root = &root->base;
+		p_map->height++;
+	}
+
+	p_node = p_map->root;
+
+	while( !p_node->is_leaf )
+	{
+		bpt_branch_t* branch = bpt_as_branch( p_node );
+
+		index = bpt_child_index( p_map, p_node, key );
+
+		if( branch->children[ index ]->count == BPT_MAX )
+		{
+			if( !bpt_split_child( p_map, branch, index ) )
+			{
+				return false;
+			}
+
+			if( p_map->compare( key, p_node->keys[ index ] ) >= 0 )
+			{
+				index++;
+			}
+		}
+
+		p_node = branch->children[ index ];
+	}
+
+	index = bpt_lower_bound( p_map, p_node, key );
+
+	if( index < p_node->count && p_map->compare( p_node->keys[ index ], key ) == 0 )
+	{
+		return false;
+	}
+
+	memmove( p_node->keys + index + 1, p_node->keys + index, (p_node->count - index) * sizeof(void*) );
+	memmove( bpt_as_leaf(p_node)->values + index + 1, bpt_as_leaf(p_node)->values + index, (p_node->count - index) * sizeof(void*) );
+	p_node->keys[ index ]                = (void*) key;
+	bpt_as_leaf(p_node)->values[ index ] = (void*) value;
+	p_node->count++;
+	p_map->size++;
+
+	return true;
+}
+
+bool lc_bptree_map_remove( lc_bptree_map_t* p_map, const void *key )
+{
+	lc_bptree_map_node_t* p_node;
+	lc_bptree_map_node_t* separator_node = NULL;
+	size_t separator_index = 0;
+	size_t index;
+	void* old_key;
+	void* old_value;
+
+	assert( p_map );
+
+	p_node = p_map->root;
+
+	if( !p_node )
+	{
+		return false;
+	}
+
+	/* Children are refilled on the way down so a remove never has to go back up. */
+	while( !p_node->is_leaf )
+	{
+		bpt_branch_t* branch = bpt_as_branch( p_node );
+
+		index = bpt_child_index( p_map, p_node, key );
+
+		if( branch->children[ index ]->count <= BPT_MIN )
+		{
+			index = bpt_fill_child( p_map, branch, index );
+
+			if( p_node->count == 0 )
+			{
+				/* The root's last two children were merged. */
+				assert( p_node == p_map->root );
+				p_map->root = branch->children[ 0 ];
+				p_map->height--;
+				bpt_free( p_map, p_node );
+				p_node = p_map->root;
+				continue;
+			}
+		}
+
+		/* Remember where the key is used as a separator; it must be replaced. */
+		if( index > 0 && p_map->compare( p_node->keys[ index - 1 ], key ) == 0 )
+		{
+			separator_node  = p_node;
+			separator_index = index - 1;
+		}
+
+		p_node = branch->children[ index ];
+	}
+
+	index = bpt_lower_bound( p_map, p_node, key );
+
+	if( index >= p_node->count || p_map->compare( p_node->keys[ index ], key ) != 0 )
+	{
+		return false;
+	}
+
+	old_key   = p_node->keys[ index ];
+	old_value = bpt_as_leaf(p_node)->values[ index ];
+
+	memmove( p_node->keys + index, p_node->keys + index + 1, (p_node->count - index - 1) * sizeof(void*) );
+	memmove( bpt_as_leaf(p_node)->values + index, bpt_as_leaf(p_node)->values + index + 1, (p_node->count - index - 1) * sizeof(void*) );
+	p_node->count--;
+
+	if( separator_node )
+	{
+		/* The separator becomes the removed key's successor. */
+		separator_node->keys[ separator_index ] = index < p_node->count ? p_node->keys[ index ] : bpt_as_leaf(p_node)->next->base.keys[ 0 ];
+	}
+
+	if( p_node->count == 0 )
+	{
+		assert( p_node == p_map->root );
+		bpt_free( p_map, p_node );
+		p_map->root   = NULL;
+		p_map->first  = NULL;
+		p_map->height = 0;
+	}
+
+	p_map->size--;
+
+	DESTROY_CHECK(
+		p_map->destroy( old_key, old_value );
+	);
+
+	return true;
+}
+
+bool lc_bptree_map_find( const lc_bptree_map_t* p_map, const void *key, lc_bptree_map_iterator_t* iter )
+{
+	lc_bptree_map_node_t* leaf;
+	size_t index;
+
+	assert( p_map );
+	assert( iter );
+
+	leaf = bpt_find_leaf( p_map, key );
+
+	if( leaf )
+	{
+		index = bpt_lower_bound( p_map, leaf, key );
+
+		if( index < leaf->count && p_map->compare( leaf->keys[ index ], key ) == 0 )
+		{
+			iter->leaf  = leaf;
+			iter->index = index;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void lc_bptree_map_clear( lc_bptree_map_t* p_map )
+{
+	assert( p_map );
+
+	if( p_map->root )
+	{
+		bpt_node_destroy( p_map, p_map->root );
+	}
+
+	p_map->root   = NULL;
+	p_map->first  = NULL;
+	p_map->size   = 0;
+	p_map->height = 0;
+}
+
+bool lc_bptree_map_begin( const lc_bptree_map_t* p_map, lc_bptree_map_iterator_t* iter )
+{
+	assert( p_map );
+	assert( iter );
+
+	iter->leaf  = p_map->first;
+	iter->index = 0;
+
+	return iter->leaf != NULL;
+}
+
+bool lc_bptree_map_next( lc_bptree_map_iterator_t* iter )
+{
+	assert( iter && iter->leaf );
+
+	if( ++iter->index >= iter->leaf->count )
+	{
+		bpt_leaf_t* next = bpt_as_leaf(iter->leaf)->next;
+
+		iter->leaf  = next ? &next->base : NULL;
+		iter->index = 0;
+	}
+
+	return iter->leaf != NULL;
+}
+
+void* lc_bptree_map_iterator_key( const lc_bptree_map_iterator_t* iter )
+{
+	return iter->leaf->keys[ iter->index ];
+}
+
+void* lc_bptree_map_iterator_value( const lc_bptree_map_iterator_t* iter )
+{
+	return bpt_as_leaf(iter->leaf)->values[ iter->index ];
+}
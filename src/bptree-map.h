@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_BPTREE_MAP_H_
+#define _LC_BPTREE_MAP_H_
+/**
+ * @file bptree-map.h
+ * @brief An ordered map built on a B+tree.
+ *
+ * Every node holds up to LC_BPTREE_MAP_MAX_KEYS keys in a sorted array,
+ * so a lookup visits log(n) / log(LC_BPTREE_MAP_MAX_KEYS) nodes instead
+ * of the 2 * log2(n) scattered nodes of lc_tree_map_t, and each entry
+ * costs two pointers instead of a whole tree node. Keys and values live
+ * in the leaves, which are linked so that in-order scans walk arrays.
+ *
+ * Keys are unique. Iterators are invalidated by inserts and removes.
+ *
+ * @defgroup lc_bptree_map B+Tree Map
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "alloc.h"
+
+/*
+ * Keys per node. A search in a node reads only its key array, which is
+ * 256 bytes for 32 keys on 64-bit targets: four or five 64 byte cache
+ * lines, since nodes are not cache line aligned. The values of a leaf or
+ * the children of a branch take about as much again.
+ */
+#ifndef LC_BPTREE_MAP_MAX_KEYS
+#define LC_BPTREE_MAP_MAX_KEYS    (32)
+#endif
+
+typedef int     (*lc_bptree_map_compare_fxn_t) ( const void *p_key_left, const void *p_key_right );
+typedef bool    (*lc_bptree_map_element_fxn_t) ( void *p_key, void *p_value );
+
+struct lc_bptree_map_node;
+typedef struct lc_bptree_map_node lc_bptree_map_node_t;
+
+/**
+ * lc_bptree_map_t is an ordered map collection object.
+ */
+typedef struct lc_bptree_map {
+	lc_bptree_map_node_t* root;
+	lc_bptree_map_node_t* first; /* left most leaf */
+	size_t size;
+	size_t height;
+	lc_bptree_map_compare_fxn_t compare;
+	lc_bptree_map_element_fxn_t destroy;
+
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
+} lc_bptree_map_t;
+
+/**
+ * A position in the map.
+ */
+typedef struct lc_bptree_map_iterator {
+	lc_bptree_map_node_t* leaf;
+	size_t index;
+} lc_bptree_map_iterator_t;
+
+/**
+ * Create a B+tree map. No memory is allocated until the first insert.
+ */
+void   lc_bptree_map_create   ( lc_bptree_map_t* p_map, lc_bptree_map_element_fxn_t destroy, lc_bptree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create a B+tree map whose nodes come from an allocator. If allocator is
+ * NULL, malloc() and free() are used.
+ */
+void   lc_bptree_map_create_with_allocator ( lc_bptree_map_t* p_map, lc_bptree_map_element_fxn_t destroy, lc_bptree_map_compare_fxn_t compare, const lc_allocator_t* allocator );
+/**
+ * Destroy a B+tree map. The destroy callback is called on every entry.
+ */
+void   lc_bptree_map_destroy  ( lc_bptree_map_t* p_map );
+/**
+ * Insert a key and value. Returns false if the key is already in the map
+ * or memory could not be allocated.
+ */
+bool   lc_bptree_map_insert   ( lc_bptree_map_t* p_map, const void *key, const void *value );
+/**
+ * Remove a key (and its value) from the map.
+ */
+bool   lc_bptree_map_remove   ( lc_bptree_map_t* p_map, const void *key );
+/**
+ * Find a key. On success the iterator is positioned on it.
+ */
+bool   lc_bptree_map_find     ( const lc_bptree_map_t* p_map, const void *key, lc_bptree_map_iterator_t* iter );
+/**
+ * Remove every entry from the map.
+ */
+void   lc_bptree_map_clear    ( lc_bptree_map_t* p_map );
+/**
+ * Position the iterator on the smallest key. Returns false if the map is
+ * empty.
+ */
+bool   lc_bptree_map_begin    ( const lc_bptree_map_t* p_map, lc_bptree_map_iterator_t* iter );
+/**
+ * Move the iterator to the next key. Returns false past the largest key.
+ */
+bool   lc_bptree_map_next     ( lc_bptree_map_iterator_t* iter );
+void*  lc_bptree_map_iterator_key   ( const lc_bptree_map_iterator_t* iter );
+void*  lc_bptree_map_iterator_value ( const lc_bptree_map_iterator_t* iter );
+
+#define lc_bptree_map_size( p_map )        ((p_map)->size)
+#define lc_bptree_map_is_empty( p_map )    ((p_map)->size <= 0)
+#define lc_bptree_map_height( p_map )      ((p_map)->height)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_BPTREE_MAP_H_ */
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+/* pthread_rwlock_t is hidden by strict ISO C modes such as -std=c99. */
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "concurrent-hash-map.h"
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK chm_lock_t;
+#define chm_lock_create( p_lock )     (InitializeSRWLock( p_lock ), true)
+#define chm_lock_destroy( p_lock )
+#define chm_read_lock( p_lock )       AcquireSRWLockShared( p_lock )
+#define chm_read_unlock( p_lock )     ReleaseSRWLockShared( p_lock )
+#define chm_write_lock( p_lock )      AcquireSRWLockExclusive( p_lock )
+#define chm_write_unlock( p_lock )    ReleaseSRWLockExclusive( p_lock )
+#else
+#include <pthread.h>
+typedef pthread_rwlock_t chm_lock_t;
+#define chm_lock_create( p_lock )     (pthread_rwlock_init( p_lock, NULL ) == 0)
+#define chm_lock_destroy( p_lock )    pthread_rwlock_destroy( p_lock )
+#define chm_read_lock( p_lock )       pthread_rwlock_rdlock( p_lock )
+#define chm_read_unlock( p_lock )     pthread_rwlock_unlock( p_lock )
+#define chm_write_lock( p_lock )      pthread_rwlock_wrlock( p_lock )
+#define chm_write_unlock( p_lock )    pthread_rwlock_unlock( p_lock )
+#endif
+
+struct lc_concurrent_hash_map_shard {
+	chm_lock_t    lock;
+	lc_hash_map_t map;
+};
+
+/* Shards are laid out on cache line boundaries so that no two share a line. */
+#define CHM_LINE             LC_CONCURRENT_HASH_MAP_CACHE_LINE
+#define CHM_SHARD_STRIDE     (((sizeof(struct lc_concurrent_hash_map_shard) + CHM_LINE - 1) / CHM_LINE) * CHM_LINE)
+
+#define chm_shard( p_map, index ) \
+	((struct lc_concurrent_hash_map_shard*) ((unsigned char*) (p_map)->shards + (index) * CHM_SHARD_STRIDE))
+
+/*
+ * Pick a shard from the top bits of the (Fibonacci) scrambled hash; the
+ * shard's own table uses the hash modulo its size, i.e. the low bits.
+ */
+static inline struct lc_concurrent_hash_map_shard* chm_shard_for( const lc_concurrent_hash_map_t* p_map, const void *key )
+{
+	uint64_t h = (uint64_t) p_map->hash( key ) * 0x9E3779B97F4A7C15ULL;
+	size_t index = p_map->shard_bits > 0 ? (size_t) (h >> (64 - p_map->shard_bits)) : 0;
+
+	return chm_shard( p_map, index );
+}
+
+bool lc_concurrent_hash_map_create( lc_concurrent_hash_map_t* p_map, size_t shard_count, size_t table_size,
+                                    lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy,
+                                    lc_hash_map_compare_fxn_t compare,
+                                    lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	size_t i;
+
+	assert( p_map );
+	assert( hash_function );
+	assert( compare );
+
+	if( shard_count == 0 )
+	{
+		shard_count = LC_CONCURRENT_HASH_MAP_SHARDS;
+	}
+
+	p_map->shard_count = 1;
+	p_map->shard_bits  = 0;
+
+	while( p_map->shard_count < shard_count )
+	{
+		p_map->shard_count <<= 1;
+		p_map->shard_bits++;
+	}
+
+	p_map->hash   = hash_function;
+	p_map->alloc  = alloc;
+	p_map->free   = free;
+	p_map->memory = p_map->alloc( p_map->shard_count * CHM_SHARD_STRIDE + CHM_LINE - 1 );
+
+	if( !p_map->memory )
+	{
+		return false;
+	}
+
+	p_map->shards = (struct lc_concurrent_hash_map_shard*) (((uintptr_t) p_map->memory + CHM_LINE - 1) & ~((uintptr_t) CHM_LINE - 1));
+
+	for( i = 0; i < p_map->shard_count; i++ )
+	{
+		struct lc_concurrent_hash_map_shard* p_shard = chm_shard( p_map, i );
+
+		if( !lc_hash_map_create( &p_shard->map, table_size, hash_function, destroy, compare, alloc, free ) )
+		{
+			goto failed;
+		}
+
+		if( !chm_lock_create( &p_shard->lock ) )
+		{
+			lc_hash_map_destroy( &p_shard->map );
+			goto failed;
+		}
+
+		/* Nobody can call lc_hash_map_rehash() safely so shards grow by themselves. */
+		lc_hash_map_auto_grow_set( &p_shard->map, LC_HASH_MAP_DEFAULT_LOAD_FACTOR );
+	}
+
+	return true;
+
+failed:
+	while( i-- > 0 )
+	{
+		struct lc_concurrent_hash_map_shard* p_shard = chm_shard( p_map, i );
+		chm_lock_destroy( &p_shard->lock );
+		lc_hash_map_destroy( &p_shard->map );
+	}
+
+	p_map->free( p_map->memory );
+	p_map->memory = NULL;
+	p_map->shards = NULL;
+	return false;
+}
+
+void lc_concurrent_hash_map_destroy( lc_concurrent_hash_map_t* p_map )
+{
+	size_t i;
+
+	assert( p_map );
+
+	for( i = 0; i < p_map->shard_count; i++ )
+	{
+		struct lc_concurrent_hash_map_shard* p_shard = chm_shard( p_map, i );
+		chm_lock_destroy( &p_shard->lock );
+		lc_hash_map_destroy( &p_shard->map );
+	}
+
+	p_map->free( p_map->memory );
+	p_map->memory = NULL;
+	p_map->shards = NULL;
+}
+
+bool lc_concurrent_hash_map_insert( lc_concurrent_hash_map_t* p_map, const void *key, const void *value )
+{
+	struct lc_concurrent_hash_map_shard* p_shard = chm_shard_for( p_map, key );
+	bool result;
+
+	chm_write_lock( &p_shard->lock );
+	result = lc_hash_map_insert( &p_shard->map, key, value );
+	chm_write_unlock( &p_shard->lock );
+
+	return result;
+}
+
+bool lc_concurrent_hash_map_insert_if_absent( lc_concurrent_hash_map_t* p_map, const void *key, const void *value )
+{
+	struct lc_concurrent_hash_map_shard* p_shard = chm_shard_for( p_map, key );
+	bool result = false;
+
+	chm_write_lock( &p_shard->lock );
+	if( lc_hash_map_find_ref( &p_shard->map, key ) == NULL )
+	{
+		result = lc_hash_map_insert( &p_shard->map, key, value );
+	}
+	chm_write_unlock( &p_shard->lock );
+
+	return result;
+}
+
+bool lc_concurrent_hash_map_remove( lc_concurrent_hash_map_t* p_map, const void *key )
+{
+	struct lc_concurrent_hash_map_shard* p_shard = chm_shard_for( p_map, key );
+	bool result;
+
+	chm_write_lock( &p_shard->lock );
+	result = lc_hash_map_remove( &p_shard->map, key );
+	chm_write_unlock( &p_shard->lock );
+
+	return result;
+}
+
+bool lc_concurrent_hash_map_find( lc_concurrent_hash_map_t* p_map, const void *key, void **value )
+{
+	struct lc_concurrent_hash_map_shard* p_shard = chm_shard_for( p_map, key );
+	bool result;
+
+	/* lc_hash_map_find() never moves entries, even while rehashing. */
+	chm_read_lock( &p_shard->lock );
+	result = lc_hash_map_find( &p_shard->map, key, value );
+	chm_read_unlock( &p_shard->lock );
+
+	return result;
+}
+
+bool lc_concurrent_hash_map_compute_if_present( lc_concurrent_hash_map_t* p_map, const void *key, lc_concurrent_hash_map_compute_fxn_t compute, void *user_data )
+{
+	struct lc_concurrent_hash_map_shard* p_shard = chm_shard_for( p_map, key );
+	void** p_value;
+	bool result = false;
+
+	assert( compute );
+
+	chm_write_lock( &p_shard->lock );
+	p_value = lc_hash_map_find_ref( &p_shard->map, key );
+
+	if( p_value )
+	{
+		if( !compute( key, p_value, user_data ) )
+		{
+			lc_hash_map_remove( &p_shard->map, key );
+		}
+
+		result = true;
+	}
+	chm_write_unlock( &p_shard->lock );
+
+	return result;
+}
+
+void lc_concurrent_hash_map_clear( lc_concurrent_hash_map_t* p_map )
+{
+	size_t i;
+
+	assert( p_map );
+
+	for( i = 0; i < p_map->shard_count; i++ )
+	{
+		struct lc_concurrent_hash_map_shard* p_shard = chm_shard( p_map, i );
+
+		chm_write_lock( &p_shard->lock );
+		lc_hash_map_clear( &p_shard->map );
+		chm_write_unlock( &p_shard->lock );
+	}
+}
+
+size_t lc_concurrent_hash_map_size( lc_concurrent_hash_map_t* p_map )
+{
+	size_t size = 0;
+	size_t i;
+
+	assert( p_map );
+
+	for( i = 0; i < p_map->shard_count; i++ )
+	{
+		struct lc_concurrent_hash_map_shard* p_shard = chm_shard( p_map, i );
+
+		chm_read_lock( &p_shard->lock );
+		size += lc_hash_map_size( &p_shard->map );
+		chm_read_unlock( &p_shard->lock );
+	}
+
+	return size;
+}
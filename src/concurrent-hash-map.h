@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_CONCURRENT_HASH_MAP_H_
+#define _LC_CONCURRENT_HASH_MAP_H_
+/**
+ * @file concurrent-hash-map.h
+ * @brief A thread-safe hash map.
+ *
+ * The key space is split across a power of two number of shards. Each
+ * shard is an lc_hash_map_t with its own reader-writer lock and sits on
+ * its own cache lines, so threads working on different shards never
+ * contend. Shards grow incrementally (see lc_hash_map_auto_grow_set()).
+ *
+ * Values returned by lc_concurrent_hash_map_find() are not protected once
+ * the shard is unlocked; use lc_concurrent_hash_map_compute_if_present()
+ * to read or update a value while other threads may remove it.
+ *
+ * @defgroup lc_concurrent_hash_map Concurrent Hash Map
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "alloc.h"
+#include "hash-map.h"
+
+#ifndef LC_CONCURRENT_HASH_MAP_SHARDS
+#define LC_CONCURRENT_HASH_MAP_SHARDS       (64)
+#endif
+
+#ifndef LC_CONCURRENT_HASH_MAP_CACHE_LINE
+#define LC_CONCURRENT_HASH_MAP_CACHE_LINE   (64)
+#endif
+
+/**
+ * Called by lc_concurrent_hash_map_compute_if_present() with the shard
+ * locked for writing. The callback may change *value. Returning false
+ * removes the entry (the destroy callback receives the key and *value).
+ */
+typedef bool (*lc_concurrent_hash_map_compute_fxn_t) ( const void *key, void **value, void *user_data );
+
+struct lc_concurrent_hash_map_shard;
+
+/**
+ * lc_concurrent_hash_map_t is a thread-safe hash map collection object.
+ */
+typedef struct lc_concurrent_hash_map {
+	size_t shard_count;
+	unsigned int shard_bits;
+	struct lc_concurrent_hash_map_shard* shards;
+	void* memory;
+
+	lc_hash_map_hash_fxn_t hash;
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+} lc_concurrent_hash_map_t;
+
+/**
+ * Create a concurrent hash map. The shard count is rounded up to a power
+ * of two (LC_CONCURRENT_HASH_MAP_SHARDS if zero) and each shard starts
+ * with table_size buckets. The callbacks must be thread-safe.
+ */
+bool   lc_concurrent_hash_map_create  ( lc_concurrent_hash_map_t* p_map, size_t shard_count, size_t table_size,
+                                        lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy,
+                                        lc_hash_map_compare_fxn_t compare,
+                                        lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Destroy a concurrent hash map. No other thread may be using it.
+ */
+void   lc_concurrent_hash_map_destroy ( lc_concurrent_hash_map_t* p_map );
+/**
+ * Insert a key and value (like lc_hash_map_insert(), duplicates are not
+ * checked).
+ */
+bool   lc_concurrent_hash_map_insert  ( lc_concurrent_hash_map_t* p_map, const void *key, const void *value );
+/**
+ * Atomically insert a key and value if the key is not already in the map.
+ * Returns false, without taking ownership, if the key was present.
+ */
+bool   lc_concurrent_hash_map_insert_if_absent ( lc_concurrent_hash_map_t* p_map, const void *key, const void *value );
+/**
+ * Remove a key (and its value) from the map.
+ */
+bool   lc_concurrent_hash_map_remove  ( lc_concurrent_hash_map_t* p_map, const void *key );
+/**
+ * Find the value for a key. Only a shared (read) lock is taken.
+ */
+bool   lc_concurrent_hash_map_find    ( lc_concurrent_hash_map_t* p_map, const void *key, void **value );
+/**
+ * Atomically read, update or remove the value of a key that is in the
+ * map. Returns false if the key was not present.
+ */
+bool   lc_concurrent_hash_map_compute_if_present ( lc_concurrent_hash_map_t* p_map, const void *key, lc_concurrent_hash_map_compute_fxn_t compute, void *user_data );
+/**
+ * Remove every entry from the map.
+ */
+void   lc_concurrent_hash_map_clear   ( lc_concurrent_hash_map_t* p_map );
+/**
+ * The number of entries. Each shard is counted under its lock but the
+ * total is only a snapshot when other threads are writing.
+ */
+size_t lc_concurrent_hash_map_size    ( lc_concurrent_hash_map_t* p_map );
+
+#define lc_concurrent_hash_map_shard_count(p_map)   ((p_map)->shard_count)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_CONCURRENT_HASH_MAP_H_ */
@@ -0,0 +1,778 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#include "concurrent-tree-map.h"
+
+#if !defined(__STDC_VERSION__) || (__STDC_VERSION__ < 201112L) || defined(__STDC_NO_ATOMICS__)
+#error "lc_concurrent_tree_map_t needs C11 atomics and thread-local storage."
+#endif
+#include <stdatomic.h>
+
+/*
+ * Node locks block instead of spinning: with more threads than processors
+ * a spinning writer only burns the time slice that a preempted lock
+ * holder needs to finish.
+ */
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK ctm_lock_t;
+#define ctm_lock_create( p_lock )     (InitializeSRWLock( p_lock ), true)
+#define ctm_lock_destroy( p_lock )
+#define ctm_lock( p_lock )            AcquireSRWLockExclusive( p_lock )
+#define ctm_unlock( p_lock )          ReleaseSRWLockExclusive( p_lock )
+#define ctm_yield( )                  SwitchToThread( )
+#else
+#include <pthread.h>
+#include <sched.h>
+typedef pthread_mutex_t ctm_lock_t;
+#define ctm_lock_create( p_lock )     (pthread_mutex_init( p_lock, NULL ) == 0)
+#define ctm_lock_destroy( p_lock )    pthread_mutex_destroy( p_lock )
+#define ctm_lock( p_lock )            pthread_mutex_lock( p_lock )
+#define ctm_unlock( p_lock )          pthread_mutex_unlock( p_lock )
+#define ctm_yield( )                  sched_yield( )
+#endif
+
+#if defined(LC_CONCURRENT_TREE_MAP_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
+	#define DESTROY_CHECK( code ) \
+		if( p_map->destroy ) \
+		{ \
+			code \
+		}
+#else
+	#define DESTROY_CHECK( code ) \
+		code
+#endif
+
+#define CTM_MAX_LEVEL   LC_CONCURRENT_TREE_MAP_MAX_LEVEL
+
+#define ctm_alloc( p_map, size )  lc_allocator_alloc( &(p_map)->allocator, (p_map)->alloc, size )
+#define ctm_free( p_map, ptr )    lc_allocator_free( &(p_map)->allocator, (p_map)->free, ptr )
+
+typedef struct lc_concurrent_tree_map_node ctm_node_t;
+
+/*
+ * A node is in the map once fully_linked is set and until marked is set.
+ * The head node has no key and sorts before every other node.
+ */
+struct lc_concurrent_tree_map_node {
+	void*        key;
+	void*        value;
+	ctm_lock_t   lock;
+	atomic_bool  marked;
+	atomic_bool  fully_linked;
+	int          top_level;      /* number of levels the node is linked on */
+	ctm_node_t*  retired_next;   /* limbo list, once unlinked */
+	size_t       retired_epoch;
+	_Atomic(ctm_node_t*) next[];
+};
+
+/*
+ * Every thread that touches a map gets a record. A record's epoch is 0
+ * while the thread is outside of the map and otherwise the global epoch
+ * it saw on the way in. Records are never freed before the map.
+ */
+typedef struct ctm_record {
+	atomic_size_t      epoch;
+	size_t             nesting;
+	const void*        owner;    /* address of the owning thread's token */
+	uint64_t           random;
+	struct ctm_record* next;
+} ctm_record_t;
+
+struct lc_concurrent_tree_map_shared {
+	atomic_size_t  size;
+	atomic_size_t  epoch;
+	size_t         id;
+	_Atomic(ctm_record_t*) records;
+
+	/* Unlinked nodes waiting for two epochs to pass, oldest first. */
+	ctm_lock_t     limbo_lock;
+	ctm_node_t*    limbo_head;
+	ctm_node_t*    limbo_tail;
+	size_t         limbo_count;
+};
+
+static atomic_size_t ctm_next_id = 1;
+static _Thread_local char ctm_thread_token;
+static _Thread_local struct {
+	size_t        id;
+	ctm_record_t* record;
+} ctm_thread_cache;
+
+
+
+static ctm_record_t* ctm_record( lc_concurrent_tree_map_t* p_map )
+{
+	struct lc_concurrent_tree_map_shared* shared = p_map->shared;
+	ctm_record_t* record;
+
+	if( ctm_thread_cache.id == shared->id )
+	{
+		return ctm_thread_cache.record;
+	}
+
+	for( record = atomic_load_explicit( &shared->records, memory_order_acquire ); record; record = record->next )
+	{
+		if( record->owner == &ctm_thread_token )
+		{
+			break;
+		}
+	}
+
+	if( !record )
+	{
+		record = (ctm_record_t*) ctm_alloc( p_map, sizeof(ctm_record_t) );
+		if( !record ) return NULL;
+
+		atomic_init( &record->epoch, 0 );
+		record->nesting = 0;
+		record->owner   = &ctm_thread_token;
+		record->random  = (uint64_t) (uintptr_t) record * 0x9E3779B97F4A7C15ULL | 1;
+		record->next    = atomic_load_explicit( &shared->records, memory_order_relaxed );
+
+		while( !atomic_compare_exchange_weak_explicit( &shared->records, &record->next, record, memory_order_release, memory_order_relaxed ) )
+		{
+		}
+	}
+
+	ctm_thread_cache.id     = shared->id;
+	ctm_thread_cache.record = record;
+	return record;
+}
+
+static inline void ctm_enter( lc_concurrent_tree_map_t* p_map, ctm_record_t* record )
+{
+	if( record->nesting++ == 0 )
+	{
+		atomic_store_explicit( &record->epoch, atomic_load_explicit( &p_map->shared->epoch, memory_order_relaxed ), memory_order_relaxed );
+		/* The epoch must be visible before any node is read. */
+		atomic_thread_fence( memory_order_seq_cst );
+	}
+}
+
+static inline void ctm_exit( ctm_record_t* record )
+{
+	if( --record->nesting == 0 )
+	{
+		atomic_store_explicit( &record->epoch, 0, memory_order_release );
+	}
+}
+
+static void ctm_node_free( lc_concurrent_tree_map_t* p_map, ctm_node_t* node )
+{
+	DESTROY_CHECK(
+		p_map->destroy( node->key, node->value );
+	);
+
+	ctm_lock_destroy( &node->lock );
+	ctm_free( p_map, node );
+}
+
+/*
+ * The epoch can move on once every thread inside the map has seen it.
+ * A node retired in epoch e is unreachable for every thread that entered
+ * in e + 1 or later, so it can be freed once the epoch reaches e + 2.
+ * Those nodes are taken off the limbo list and returned; the caller frees
+ * them after releasing the limbo lock, so that the destroy callback and
+ * the allocator never run under it.
+ */
+static ctm_node_t* ctm_reclaim( lc_concurrent_tree_map_t* p_map )
+{
+	struct lc_concurrent_tree_map_shared* shared = p_map->shared;
+	size_t epoch = atomic_load_explicit( &shared->epoch, memory_order_relaxed );
+	ctm_node_t* expired = shared->limbo_head;
+	ctm_node_t* last = NULL;
+	ctm_record_t* record;
+	bool quiescent = true;
+
+	atomic_thread_fence( memory_order_seq_cst );
+
+	for( record = atomic_load_explicit( &shared->records, memory_order_acquire ); record && quiescent; record = record->next )
+	{
+		size_t seen = atomic_load_explicit( &record->epoch, memory_order_acquire );
+		quiescent = seen == 0 || seen == epoch;
+	}
+
+	if( quiescent )
+	{
+		epoch++;
+		atomic_store_explicit( &shared->epoch, epoch, memory_order_release );
+	}
+
+	while( shared->limbo_head && shared->limbo_head->retired_epoch + 2 <= epoch )
+	{
+		last = shared->limbo_head;
+		shared->limbo_head = last->retired_next;
+		shared->limbo_count--;
+	}
+
+	if( !last )
+	{
+		return NULL;
+	}
+
+	last->retired_next = NULL;
+
+	if( !shared->limbo_head )
+	{
+		shared->limbo_tail = NULL;
+	}
+
+	return expired;
+}
+
+static void ctm_retire( lc_concurrent_tree_map_t* p_map, ctm_node_t* node )
+{
+	struct lc_concurrent_tree_map_shared* shared = p_map->shared;
+	ctm_node_t* expired = NULL;
+
+	ctm_lock( &shared->limbo_lock );
+
+	node->retired_next  = NULL;
+	node->retired_epoch = atomic_load_explicit( &shared->epoch, memory_order_relaxed );
+
+	if( shared->limbo_tail )
+	{
+		shared->limbo_tail->retired_next = node;
+	}
+	else
+	{
+		shared->limbo_head = node;
+	}
+	shared->limbo_tail = node;
+
+	if( ++shared->limbo_count >= LC_CONCURRENT_TREE_MAP_RECLAIM_BATCH )
+	{
+		expired = ctm_reclaim( p_map );
+	}
+
+	ctm_unlock( &shared->limbo_lock );
+
+	while( expired )
+	{
+		ctm_node_t* next = expired->retired_next;
+		ctm_node_free( p_map, expired );
+		expired = next;
+	}
+}
+
+static ctm_node_t* ctm_node_create( lc_concurrent_tree_map_t* p_map, const void *key, const void *value, int top_level )
+{
+	ctm_node_t* node = (ctm_node_t*) ctm_alloc( p_map, sizeof(ctm_node_t) + top_level * sizeof(_Atomic(ctm_node_t*)) );
+	int level;
+
+	if( node )
+	{
+		node->key       = (void*) key;
+		node->value     = (void*) value;
+		node->top_level = top_level;
+		if( !ctm_lock_create( &node->lock ) )
+		{
+			ctm_free( p_map, node );
+			return NULL;
+		}
+
+		node->retired_next  = NULL;
+		node->retired_epoch = 0;
+		atomic_init( &node->marked, false );
+		atomic_init( &node->fully_linked, false );
+
+		for( level = 0; level < top_level; level++ )
+		{
+			atomic_init( &node->next[ level ], NULL );
+		}
+	}
+
+	return node;
+}
+
+/* A level with probability 1/4 of each level above the first. */
+static inline int ctm_random_level( ctm_record_t* record )
+{
+	uint64_t x = record->random;
+	int level = 1;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	record->random = x;
+
+	while( level < CTM_MAX_LEVEL && (x & 3) == 0 )
+	{
+		level++;
+		x >>= 2;
+	}
+
+	return level;
+}
+
+/*
+ * Fill in the last node before key (preds) and the one after it (succs)
+ * on every level. Returns the highest level on which key was found, or -1.
+ */
+static int ctm_find( lc_concurrent_tree_map_t* p_map, const void *key, ctm_node_t** preds, ctm_node_t** succs )
+{
+	ctm_node_t* pred = p_map->head;
+	int found = -1;
+	int level;
+
+	for( level = CTM_MAX_LEVEL - 1; level >= 0; level-- )
+	{
+		ctm_node_t* curr = atomic_load_explicit( &pred->next[ level ], memory_order_acquire );
+		int c = -1;
+
+		while( curr && (c = p_map->compare( curr->key, key )) < 0 )
+		{
+			pred = curr;
+			curr = atomic_load_explicit( &pred->next[ level ], memory_order_acquire );
+		}
+
+		if( found == -1 && curr && c == 0 )
+		{
+			found = level;
+		}
+
+		preds[ level ] = pred;
+		succs[ level ] = curr;
+	}
+
+	return found;
+}
+
+static inline void ctm_unlock_preds( ctm_node_t** preds, int highest_locked )
+{
+	int level;
+
+	for( level = 0; level <= highest_locked; level++ )
+	{
+		if( level == 0 || preds[ level ] != preds[ level - 1 ] )
+		{
+			ctm_unlock( &preds[ level ]->lock );
+		}
+	}
+}
+
+#define ctm_is_marked( p_node )        atomic_load_explicit( &(p_node)->marked, memory_order_acquire )
+#define ctm_is_fully_linked( p_node )  atomic_load_explicit( &(p_node)->fully_linked, memory_order_acquire )
+
+
+static bool ctm_init( lc_concurrent_tree_map_t* p_map )
+{
+	struct lc_concurrent_tree_map_shared* shared;
+
+	p_map->head   = ctm_node_create( p_map, NULL, NULL, CTM_MAX_LEVEL );
+	p_map->shared = (struct lc_concurrent_tree_map_shared*) ctm_alloc( p_map, sizeof(struct lc_concurrent_tree_map_shared) );
+
+	if( !p_map->head || !p_map->shared || !ctm_lock_create( &p_map->shared->limbo_lock ) )
+	{
+		if( p_map->head )
+		{
+			ctm_lock_destroy( &p_map->head->lock );
+			ctm_free( p_map, p_map->head );
+		}
+		if( p_map->shared ) ctm_free( p_map, p_map->shared );
+		p_map->head   = NULL;
+		p_map->shared = NULL;
+		return false;
+	}
+
+	shared = p_map->shared;
+	atomic_init( &shared->size, 0 );
+	atomic_init( &shared->epoch, 1 );
+	atomic_init( &shared->records, NULL );
+	shared->id          = atomic_fetch_add_explicit( &ctm_next_id, 1, memory_order_relaxed );
+	shared->limbo_head  = NULL;
+	shared->limbo_tail  = NULL;
+	shared->limbo_count = 0;
+
+	atomic_store( &p_map->head->fully_linked, true );
+	return true;
+}
+
+bool lc_concurrent_tree_map_create( lc_concurrent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	assert( p_map );
+	#if !defined(LC_CONCURRENT_TREE_MAP_DESTROY_CHECK) && !defined(DESTROY_CHECK_ALL)
+	assert( destroy );
+	#endif
+	assert( compare );
+	assert( alloc );
+	assert( free );
+
+	p_map->compare = compare;
+	p_map->destroy = destroy;
+	p_map->alloc   = alloc;
+	p_map->free    = free;
+	lc_allocator_init( &p_map->allocator, NULL );
+
+	return ctm_init( p_map );
+}
+
+bool lc_concurrent_tree_map_create_with_allocator( lc_concurrent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	assert( p_map );
+	#if !defined(LC_CONCURRENT_TREE_MAP_DESTROY_CHECK) && !defined(DESTROY_CHECK_ALL)
+	assert( destroy );
+	#endif
+	assert( compare );
+
+	p_map->compare = compare;
+	p_map->destroy = destroy;
+	p_map->alloc   = malloc;
+	p_map->free    = free;
+	lc_allocator_init( &p_map->allocator, allocator );
+
+	return ctm_init( p_map );
+}
+
+void lc_concurrent_tree_map_destroy( lc_concurrent_tree_map_t* p_map )
+{
+	ctm_node_t* node;
+	ctm_record_t* record;
+
+	assert( p_map );
+
+	if( !p_map->shared )
+	{
+		return;
+	}
+
+	node = atomic_load_explicit( &p_map->head->next[ 0 ], memory_order_relaxed );
+
+	while( node )
+	{
+		ctm_node_t* next = atomic_load_explicit( &node->next[ 0 ], memory_order_relaxed );
+		ctm_node_free( p_map, node );
+		node = next;
+	}
+
+	node = p_map->shared->limbo_head;
+
+	while( node )
+	{
+		ctm_node_t* next = node->retired_next;
+		ctm_node_free( p_map, node );
+		node = next;
+	}
+
+	record = atomic_load_explicit( &p_map->shared->records, memory_order_relaxed );
+
+	while( record )
+	{
+		ctm_record_t* next = record->next;
+		ctm_free( p_map, record );
+		record = next;
+	}
+
+	ctm_lock_destroy( &p_map->head->lock );
+	ctm_lock_destroy( &p_map->shared->limbo_lock );
+	ctm_free( p_map, p_map->head );
+	ctm_free( p_map, p_map->shared );
+	p_map->head   = NULL;
+	p_map->shared = NULL;
+}
+
+bool lc_concurrent_tree_map_insert( lc_concurrent_tree_map_t* p_map, const void *key, const void *value )
+{
+	ctm_node_t* preds[ CTM_MAX_LEVEL ];
+	ctm_node_t* succs[ CTM_MAX_LEVEL ];
+	ctm_record_t* record;
+	bool result = false;
+	int top_level;
+
+	assert( p_map );
+	record = ctm_record( p_map );
+	if( !record ) return false;
+
+	ctm_enter( p_map, record );
+	top_level = ctm_random_level( record );
+
+	for( ;; )
+	{
+		ctm_node_t* prev_pred = NULL;
+		ctm_node_t* node;
+		int found = ctm_find( p_map, key, preds, succs );
+		int highest_locked = -1;
+		bool valid = true;
+		int level;
+
+		if( found != -1 )
+		{
+			node = succs[ found ];
+
+			if( !ctm_is_marked( node ) )
+			{
+				/* Someone else is adding the key; let them finish. */
+				while( !ctm_is_fully_linked( node ) )
+				{
+					ctm_yield( );
+				}
+				break;
+			}
+
+			/* The key is being removed; try again once it is gone. */
+			continue;
+		}
+
+		for( level = 0; valid && level < top_level; level++ )
+		{
+			ctm_node_t* pred = preds[ level ];
+			ctm_node_t* succ = succs[ level ];
+
+			if( pred != prev_pred )
+			{
+				ctm_lock( &pred->lock );
+				highest_locked = level;
+				prev_pred      = pred;
+			}
+
+			valid = !ctm_is_marked( pred ) &&
+			        (!succ || !ctm_is_marked( succ )) &&
+			        atomic_load_explicit( &pred->next[ level ], memory_order_acquire ) == succ;
+		}
+
+		if( !valid )
+		{
+			ctm_unlock_preds( preds, highest_locked );
+			continue;
+		}
+
+		node = ctm_node_create( p_map, key, value, top_level );
+
+		if( node )
+		{
+			for( level = 0; level < top_level; level++ )
+			{
+				atomic_store_explicit( &node->next[ level ], succs[ level ], memory_order_relaxed );
+			}
+
+			for( level = 0; level < top_level; level++ )
+			{
+				atomic_store_explicit( &preds[ level ]->next[ level ], node, memory_order_release );
+			}
+
+			atomic_store_explicit( &node->fully_linked, true, memory_order_release );
+			atomic_fetch_add_explicit( &p_map->shared->size, 1, memory_order_relaxed );
+			result = true;
+		}
+
+		ctm_unlock_preds( preds, highest_locked );
+		break;
+	}
+
+	ctm_exit( record );
+	return result;
+}
+
+bool lc_concurrent_tree_map_remove( lc_concurrent_tree_map_t* p_map, const void *key )
+{
+	ctm_node_t* preds[ CTM_MAX_LEVEL ];
+	ctm_node_t* succs[ CTM_MAX_LEVEL ];
+	ctm_node_t* victim = NULL;
+	ctm_record_t* record;
+	bool is_marked = false;
+	bool result = false;
+	int top_level = -1;
+
+	assert( p_map );
+	record = ctm_record( p_map );
+	if( !record ) return false;
+
+	ctm_enter( p_map, record );
+
+	for( ;; )
+	{
+		ctm_node_t* prev_pred = NULL;
+		int found = ctm_find( p_map, key, preds, succs );
+		int highest_locked = -1;
+		bool valid = true;
+		int level;
+
+		if( !is_marked )
+		{
+			if( found == -1 )
+			{
+				break;
+			}
+
+			victim = succs[ found ];
+
+			/* Only remove a node that is fully in the map (and found on its top level). */
+			if( !ctm_is_fully_linked( victim ) || victim->top_level - 1 != found || ctm_is_marked( victim ) )
+			{
+				break;
+			}
+
+			top_level = victim->top_level;
+			ctm_lock( &victim->lock );
+
+			if( ctm_is_marked( victim ) )
+			{
+				ctm_unlock( &victim->lock );
+				break;
+			}
+
+			atomic_store_explicit( &victim->marked, true, memory_order_release );
+			is_marked = true;
+		}
+
+		for( level = 0; valid && level < top_level; level++ )
+		{
+			ctm_node_t* pred = preds[ level ];
+
+			if( pred != prev_pred )
+			{
+				ctm_lock( &pred->lock );
+				highest_locked = level;
+				prev_pred      = pred;
+			}
+
+			valid = !ctm_is_marked( pred ) &&
+			        atomic_load_explicit( &pred->next[ level ], memory_order_acquire ) == victim;
+		}
+
+		if( !valid )
+		{
+			ctm_unlock_preds( preds, highest_locked );
+			continue;
+		}
+
+		for( level = top_level - 1; level >= 0; level-- )
+		{
+			atomic_store_explicit( &preds[ level ]->next[ level ],
+			                       atomic_load_explicit( &victim->next[ level ], memory_order_acquire ),
+			                       memory_order_release );
+		}
+
+		ctm_unlock( &victim->lock );
+		ctm_unlock_preds( preds, highest_locked );
+
+		atomic_fetch_sub_explicit( &p_map->shared->size, 1, memory_order_relaxed );
+		ctm_retire( p_map, victim );
+		result = true;
+		break;
+	}
+
+	ctm_exit( record );
+	return result;
+}
+
+bool lc_concurrent_tree_map_find( lc_concurrent_tree_map_t* p_map, const void *key, void **value )
+{
+	ctm_node_t* pred;
+	ctm_node_t* curr = NULL;
+	ctm_record_t* record;
+	bool result = false;
+	int level;
+	int c = -1;
+
+	assert( p_map );
+	record = ctm_record( p_map );
+	if( !record ) return false;
+
+	ctm_enter( p_map, record );
+	pred = p_map->head;
+
+	for( level = CTM_MAX_LEVEL - 1; level >= 0; level-- )
+	{
+		curr = atomic_load_explicit( &pred->next[ level ], memory_order_acquire );
+
+		while( curr && (c = p_map->compare( curr->key, key )) < 0 )
+		{
+			pred = curr;
+			curr = atomic_load_explicit( &pred->next[ level ], memory_order_acquire );
+		}
+
+		if( curr && c == 0 )
+		{
+			break;
+		}
+	}
+
+	if( curr && c == 0 && ctm_is_fully_linked( curr ) && !ctm_is_marked( curr ) )
+	{
+		if( value )
+		{
+			*value = curr->value;
+		}
+		result = true;
+	}
+
+	ctm_exit( record );
+	return result;
+}
+
+size_t lc_concurrent_tree_map_range( lc_concurrent_tree_map_t* p_map, const void *low, const void *high, lc_tree_map_range_fxn_t visit, void *user_data )
+{
+	ctm_node_t* pred;
+	ctm_node_t* curr;
+	ctm_record_t* record;
+	size_t count = 0;
+	int level;
+
+	assert( p_map );
+	assert( visit );
+	record = ctm_record( p_map );
+	if( !record ) return 0;
+
+	ctm_enter( p_map, record );
+	pred = p_map->head;
+
+	/* Find the last node before low. */
+	for( level = CTM_MAX_LEVEL - 1; low && level >= 0; level-- )
+	{
+		curr = atomic_load_explicit( &pred->next[ level ], memory_order_acquire );
+
+		while( curr && p_map->compare( curr->key, low ) < 0 )
+		{
+			pred = curr;
+			curr = atomic_load_explicit( &pred->next[ level ], memory_order_acquire );
+		}
+	}
+
+	for( curr = atomic_load_explicit( &pred->next[ 0 ], memory_order_acquire );
+	     curr && (!high || p_map->compare( curr->key, high ) < 0);
+	     curr = atomic_load_explicit( &curr->next[ 0 ], memory_order_acquire ) )
+	{
+		if( ctm_is_fully_linked( curr ) && !ctm_is_marked( curr ) )
+		{
+			count++;
+
+			if( !visit( curr->key, curr->value, user_data ) )
+			{
+				break;
+			}
+		}
+	}
+
+	ctm_exit( record );
+	return count;
+}
+
+size_t lc_concurrent_tree_map_size( const lc_concurrent_tree_map_t* p_map )
+{
+	assert( p_map );
+	return atomic_load_explicit( &p_map->shared->size, memory_order_relaxed );
+}
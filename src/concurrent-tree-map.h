@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_CONCURRENT_TREE_MAP_H_
+#define _LC_CONCURRENT_TREE_MAP_H_
+/**
+ * @file concurrent-tree-map.h
+ * @brief A thread-safe ordered map.
+ *
+ * The map is a lazy skip list (Herlihy, Lev, Luchangco and Shavit). Finds
+ * and range scans take no locks. Writers lock only the nodes in front of
+ * the key they change, and block rather than spin while waiting for them.
+ * A removed node is unlinked at once. It is freed, and the destroy callback
+ * called on its key and value, only after every thread that could still be
+ * reading it has finished: epoch based reclamation. The destroy callback
+ * and the allocator are never called with a lock of the map held.
+ *
+ * Range scans see each entry that is in the map for the whole scan, in
+ * order; entries added or removed meanwhile may or may not be visited.
+ * A value returned by lc_concurrent_tree_map_find() stays valid until
+ * another thread removes its key. The allocator must be thread safe.
+ * The callbacks are the same ones used by lc_tree_map_t.
+ *
+ * The map needs C11 atomics and thread-local storage; it is left out of
+ * the library when configure does not find them.
+ *
+ * @defgroup lc_concurrent_tree_map Concurrent Tree Map
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "alloc.h"
+#include "tree-map.h"
+
+/* Levels of the skip list; each level holds about a quarter of the one below. */
+#ifndef LC_CONCURRENT_TREE_MAP_MAX_LEVEL
+#define LC_CONCURRENT_TREE_MAP_MAX_LEVEL     (20)
+#endif
+
+/* Removed nodes collected before trying to free them. */
+#ifndef LC_CONCURRENT_TREE_MAP_RECLAIM_BATCH
+#define LC_CONCURRENT_TREE_MAP_RECLAIM_BATCH (64)
+#endif
+
+struct lc_concurrent_tree_map_node;
+struct lc_concurrent_tree_map_shared;
+
+/**
+ * lc_concurrent_tree_map_t is a thread-safe ordered map collection object.
+ */
+typedef struct lc_concurrent_tree_map {
+	struct lc_concurrent_tree_map_node*   head;
+	struct lc_concurrent_tree_map_shared* shared; /* size and reclamation */
+
+	lc_tree_map_compare_fxn_t compare;
+	lc_tree_map_element_fxn_t destroy;
+
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
+} lc_concurrent_tree_map_t;
+
+bool   lc_concurrent_tree_map_create  ( lc_concurrent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create a map whose memory comes from an allocator. If allocator is
+ * NULL, malloc() and free() are used.
+ */
+bool   lc_concurrent_tree_map_create_with_allocator ( lc_concurrent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, const lc_allocator_t* allocator );
+/**
+ * Destroy the map. No other thread may be using it. The destroy callback
+ * is called on every entry, including removed ones not yet reclaimed.
+ */
+void   lc_concurrent_tree_map_destroy ( lc_concurrent_tree_map_t* p_map );
+/**
+ * Insert a key and value. Returns false if the key is already in the map
+ * or memory could not be allocated.
+ */
+bool   lc_concurrent_tree_map_insert  ( lc_concurrent_tree_map_t* p_map, const void *key, const void *value );
+/**
+ * Remove a key (and its value) from the map.
+ */
+bool   lc_concurrent_tree_map_remove  ( lc_concurrent_tree_map_t* p_map, const void *key );
+/**
+ * Find the value for a key without taking any locks.
+ */
+bool   lc_concurrent_tree_map_find    ( lc_concurrent_tree_map_t* p_map, const void *key, void **value );
+/**
+ * Visit the entries with low <= key < high in order without taking any
+ * locks. A NULL low or high leaves that end of the range open. Returns
+ * the number of entries visited.
+ */
+size_t lc_concurrent_tree_map_range   ( lc_concurrent_tree_map_t* p_map, const void *low, const void *high, lc_tree_map_range_fxn_t visit, void *user_data );
+size_t lc_concurrent_tree_map_size    ( const lc_concurrent_tree_map_t* p_map );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_CONCURRENT_TREE_MAP_H_ */
@@ -35,6 +35,10 @@
 #endif
 
 
+#define dlist_alloc( p_list, size )   lc_allocator_alloc( &(p_list)->allocator, (p_list)->alloc, size )
+#define dlist_free( p_list, ptr )     lc_allocator_free( &(p_list)->allocator, (p_list)->free, ptr )
+
+
 void lc_dlist_create( lc_dlist_t* p_list, lc_dlist_element_fxn_t destroy_callback, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
 {
 	assert( p_list );
@@ -46,6 +50,13 @@ void lc_dlist_create( lc_dlist_t* p_list, lc_dlist_element_fxn_t destroy_callbac
 
 	p_list->alloc = alloc;
 	p_list->free  = free;
+	lc_allocator_init( &p_list->allocator, NULL );
+}
+
+void lc_dlist_create_with_allocator( lc_dlist_t* p_list, lc_dlist_element_fxn_t destroy_callback, const lc_allocator_t* allocator )
+{
+	lc_dlist_create( p_list, destroy_callback, malloc, free );
+	lc_allocator_init( &p_list->allocator, allocator );
 }
 
 void lc_dlist_destroy( lc_dlist_t* p_list )
@@ -65,7 +76,7 @@ bool lc_dlist_insert_front( lc_dlist_t* p_list, const void *data ) /* O(1) */
 	lc_dlist_node_t* p_node;
 	assert( p_list );
 
-	p_node = p_list->alloc( sizeof(lc_dlist_node_t) );
+	p_node = dlist_alloc( p_list, sizeof(lc_dlist_node_t) );
 	assert( p_node );
 
 	if( p_node != NULL )
@@ -120,7 +131,7 @@ bool lc_dlist_remove_front( lc_dlist_t* p_list ) /* O(1) */
 		result = p_list->destroy( p_list->head->data );
 	);
 
-	p_list->free( p_list->head );
+	dlist_free( p_list, p_list->head );
 
 	p_list->head = p_node;
 	p_list->size--;
@@ -133,7 +144,7 @@ bool lc_dlist_insert_back( lc_dlist_t* p_list, const void *data ) /* O(1) */
 	lc_dlist_node_t* p_node;
 	assert( p_list );
 
-	p_node = p_list->alloc( sizeof(lc_dlist_node_t) );
+	p_node = dlist_alloc( p_list, sizeof(lc_dlist_node_t) );
 	assert( p_node );
 
 	if( p_node != NULL )
@@ -187,7 +198,7 @@ bool lc_dlist_remove_back( lc_dlist_t* p_list ) /* O(1) */
 		result = p_list->destroy( p_list->tail->data );
 	);
 
-	p_list->free( p_list->tail );
+	dlist_free( p_list, p_list->tail );
 
 	p_list->tail = p_node;
 	p_list->size--;
@@ -202,7 +213,7 @@ bool lc_dlist_insert_next( lc_dlist_t* p_list, lc_dlist_node_t* p_front_node, co
 
 	if( p_front_node )
 	{
-		lc_dlist_node_t* p_node = p_list->alloc( sizeof(lc_dlist_node_t) );
+		lc_dlist_node_t* p_node = dlist_alloc( p_list, sizeof(lc_dlist_node_t) );
 		assert( p_node );
 
 		if( p_node != NULL )
@@ -259,7 +270,7 @@ bool lc_dlist_remove_next( lc_dlist_t* p_list, lc_dlist_node_t* p_front_node ) /
 			result = p_list->destroy( p_node->data );
 		);
 
-		p_list->free( p_node );
+		dlist_free( p_list, p_node );
 
 		p_front_node->next = p_new_next;
 		p_list->size--;
@@ -65,6 +65,7 @@ typedef struct dlist {
 
 	lc_alloc_fxn_t  alloc;
 	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
 } lc_dlist_t;
 
 /**
@@ -77,6 +78,11 @@ typedef lc_dlist_node_t* lc_dlist_iterator_t;
  * Create a doubly linked-list collection.
  */
 void lc_dlist_create        ( lc_dlist_t* p_list, lc_dlist_element_fxn_t destroy_callback, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create a doubly linked-list collection whose nodes come from an
+ * allocator. If allocator is NULL, malloc() and free() are used.
+ */
+void lc_dlist_create_with_allocator ( lc_dlist_t* p_list, lc_dlist_element_fxn_t destroy_callback, const lc_allocator_t* allocator );
 /**
  * Destroy a doubly linked-list collection.
  */
@@ -112,12 +118,12 @@ void lc_dlist_clear         ( lc_dlist_t* p_list ); /* O(N) */
 
 /**
  * Set the allocation callback that should be used for allocating
- * memory.
+ * memory. It is not used by lists created with an allocator.
  */
 void lc_dlist_alloc_set  ( lc_dlist_t* p_list, lc_alloc_fxn_t alloc );
 /**
  * Set the deallocation callback that should be used for releasing
- * memory.
+ * memory. It is not used by lists created with an allocator.
  */
 void lc_dlist_free_set   ( lc_dlist_t* p_list, lc_free_fxn_t free );
 
@@ -0,0 +1,538 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "flat-hash-map.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FHM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(LC_FLAT_HASH_MAP_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
+	#define DESTROY_CHECK( code ) \
+		if( p_map->destroy ) \
+		{ \
+			code \
+		}
+#else
+	#define DESTROY_CHECK( code ) \
+		code
+#endif
+
+struct lc_flat_hash_map_slot {
+	void *key;
+	void *value;
+};
+
+/*
+ * Control bytes. A full slot stores the low 7 bits of the hash
+ * (a non-negative value) so all of the special states are negative.
+ */
+#define FHM_EMPTY       ((int8_t) -128)
+#define FHM_DELETED     ((int8_t) -2)
+#define FHM_WIDTH       LC_FLAT_HASH_MAP_GROUP_WIDTH
+
+#define fhm_is_full( c )              ((c) >= 0)
+#define fhm_h1( hash )                ((hash) >> 7)
+#define fhm_h2( hash )                ((int8_t) ((hash) & 0x7F))
+#define fhm_max_growth( capacity )    ((capacity) - (capacity) / 8)
+#define fhm_is_power_of_2( x )        (((x) & ((x) - 1)) == 0)
+#define fhm_alloc( p_map, size )      lc_allocator_alloc( &(p_map)->allocator, (p_map)->alloc, size )
+#define fhm_free( p_map, ptr )        lc_allocator_free( &(p_map)->allocator, (p_map)->free, ptr )
+
+typedef uint32_t fhm_mask_t;
+
+static inline size_t     fhm_hash                   ( const lc_flat_hash_map_t* p_map, const void *key );
+static inline fhm_mask_t fhm_group_match            ( const int8_t* group, int8_t h2 );
+static inline fhm_mask_t fhm_group_match_empty      ( const int8_t* group );
+static inline fhm_mask_t fhm_group_match_available  ( const int8_t* group );
+static inline unsigned   fhm_trailing_zeros         ( fhm_mask_t mask );
+static inline unsigned   fhm_leading_zeros          ( fhm_mask_t mask );
+static inline void       fhm_set_ctrl               ( lc_flat_hash_map_t* p_map, size_t index, int8_t c );
+static inline size_t     fhm_find_available         ( const lc_flat_hash_map_t* p_map, size_t hash );
+static bool              fhm_find_index             ( const lc_flat_hash_map_t* p_map, const void *key, size_t hash, size_t* p_index );
+static bool              fhm_resize                 ( lc_flat_hash_map_t* p_map, size_t new_capacity );
+static bool              fhm_allocate               ( lc_flat_hash_map_t* p_map, size_t capacity );
+static inline size_t     fhm_capacity_for           ( size_t count );
+
+
+/*
+ * The user supplied hash functions are often weak in their lower bits
+ * (e.g. pointer hashes) so the result is mixed before it is split into
+ * the probe position (h1) and the control byte tag (h2).
+ */
+static inline size_t fhm_hash( const lc_flat_hash_map_t* p_map, const void *key )
+{
+	uint64_t h = (uint64_t) p_map->hash( key );
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return (size_t) h;
+}
+
+#ifdef FHM_USE_SSE2
+static inline fhm_mask_t fhm_group_match( const int8_t* group, int8_t h2 )
+{
+	__m128i ctrl = _mm_loadu_si128( (const __m128i*) group );
+	return (fhm_mask_t) _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_set1_epi8( h2 ), ctrl ) );
+}
+
+static inline fhm_mask_t fhm_group_match_empty( const int8_t* group )
+{
+	__m128i ctrl = _mm_loadu_si128( (const __m128i*) group );
+	return (fhm_mask_t) _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_set1_epi8( FHM_EMPTY ), ctrl ) );
+}
+
+static inline fhm_mask_t fhm_group_match_available( const int8_t* group )
+{
+	/* Empty and deleted are the only control bytes less than -1. */
+	__m128i ctrl = _mm_loadu_si128( (const __m128i*) group );
+	return (fhm_mask_t) _mm_movemask_epi8( _mm_cmpgt_epi8( _mm_set1_epi8( -1 ), ctrl ) );
+}
+#else
+static inline fhm_mask_t fhm_group_match( const int8_t* group, int8_t h2 )
+{
+	fhm_mask_t mask = 0;
+	int i;
+	for( i = 0; i < FHM_WIDTH; i++ )
+	{
+		mask |= (fhm_mask_t) (group[ i ] == h2) << i;
+	}
+	return mask;
+}
+
+static inline fhm_mask_t fhm_group_match_empty( const int8_t* group )
+{
+	return fhm_group_match( group, FHM_EMPTY );
+}
+
+static inline fhm_mask_t fhm_group_match_available( const int8_t* group )
+{
+	fhm_mask_t mask = 0;
+	int i;
+	for( i = 0; i < FHM_WIDTH; i++ )
+	{
+		mask |= (fhm_mask_t) (group[ i ] < -1) << i;
+	}
+	return mask;
+}
+#endif
+
+static inline unsigned fhm_trailing_zeros( fhm_mask_t mask )
+{
+	#if defined(__GNUC__) || defined(__clang__)
+	return mask ? (unsigned) __builtin_ctz( mask ) : FHM_WIDTH;
+	#else
+	unsigned n = 0;
+	while( n < FHM_WIDTH && !(mask & (1u << n)) ) n++;
+	return n;
+	#endif
+}
+
+static inline unsigned fhm_leading_zeros( fhm_mask_t mask )
+{
+	unsigned n = 0;
+	while( n < FHM_WIDTH && !(mask & (1u << (FHM_WIDTH - 1 - n))) ) n++;
+	return n;
+}
+
+/*
+ * The first FHM_WIDTH control bytes are cloned after the end of the
+ * control array so that a group can be loaded at any index without
+ * having to wrap around.
+ */
+static inline void fhm_set_ctrl( lc_flat_hash_map_t* p_map, size_t index, int8_t c )
+{
+	p_map->ctrl[ index ] = c;
+
+	if( index < FHM_WIDTH )
+	{
+		p_map->ctrl[ p_map->capacity + index ] = c;
+	}
+}
+
+static inline size_t fhm_find_available( const lc_flat_hash_map_t* p_map, size_t hash )
+{
+	size_t mask = p_map->capacity - 1;
+	size_t pos  = fhm_h1( hash ) & mask;
+	size_t step = 0;
+
+	for( ;; )
+	{
+		fhm_mask_t available = fhm_group_match_available( p_map->ctrl + pos );
+
+		if( available )
+		{
+			return (pos + fhm_trailing_zeros( available )) & mask;
+		}
+
+		/* Triangular probing visits every group when the capacity is a power of two. */
+		step += FHM_WIDTH;
+		pos   = (pos + step) & mask;
+	}
+}
+
+static bool fhm_find_index( const lc_flat_hash_map_t* p_map, const void *key, size_t hash, size_t* p_index )
+{
+	size_t mask = p_map->capacity - 1;
+	size_t pos  = fhm_h1( hash ) & mask;
+	size_t step = 0;
+	int8_t h2   = fhm_h2( hash );
+
+	for( ;; )
+	{
+		const int8_t* group = p_map->ctrl + pos;
+		fhm_mask_t matches  = fhm_group_match( group, h2 );
+
+		while( matches )
+		{
+			size_t index = (pos + fhm_trailing_zeros( matches )) & mask;
+
+			if( p_map->compare( p_map->slots[ index ].key, key ) == 0 )
+			{
+				*p_index = index;
+				return true;
+			}
+
+			matches &= matches - 1;
+		}
+
+		/* An empty slot ends every probe sequence that passes through it. */
+		if( fhm_group_match_empty( group ) )
+		{
+			return false;
+		}
+
+		step += FHM_WIDTH;
+		pos   = (pos + step) & mask;
+	}
+}
+
+static bool fhm_allocate( lc_flat_hash_map_t* p_map, size_t capacity )
+{
+	size_t slots_size = capacity * sizeof(lc_flat_hash_map_slot_t);
+	size_t ctrl_size  = capacity + FHM_WIDTH;
+	unsigned char* memory;
+
+	assert( fhm_is_power_of_2( capacity ) );
+
+	/* Slots and control bytes live in a single block. */
+	memory = (unsigned char*) fhm_alloc( p_map, slots_size + ctrl_size );
+
+	if( !memory )
+	{
+		return false;
+	}
+
+	p_map->slots       = (lc_flat_hash_map_slot_t*) memory;
+	p_map->ctrl        = (int8_t*) (memory + slots_size);
+	p_map->capacity    = capacity;
+	p_map->growth_left = fhm_max_growth( capacity ) - p_map->size;
+
+	memset( p_map->ctrl, FHM_EMPTY, ctrl_size );
+
+	return true;
+}
+
+static bool fhm_resize( lc_flat_hash_map_t* p_map, size_t new_capacity )
+{
+	lc_flat_hash_map_slot_t* old_slots = p_map->slots;
+	int8_t* old_ctrl                   = p_map->ctrl;
+	size_t old_capacity                = p_map->capacity;
+	size_t i;
+
+	assert( fhm_max_growth( new_capacity ) >= p_map->size );
+
+	if( !fhm_allocate( p_map, new_capacity ) )
+	{
+		return false;
+	}
+
+	for( i = 0; i < old_capacity; i++ )
+	{
+		if( fhm_is_full( old_ctrl[ i ] ) )
+		{
+			size_t hash  = fhm_hash( p_map, old_slots[ i ].key );
+			size_t index = fhm_find_available( p_map, hash );
+
+			fhm_set_ctrl( p_map, index, fhm_h2( hash ) );
+			p_map->slots[ index ] = old_slots[ i ];
+		}
+	}
+
+	fhm_free( p_map, old_slots );
+
+	return true;
+}
+
+static inline size_t fhm_capacity_for( size_t count )
+{
+	size_t capacity = LC_FLAT_HASH_MAP_MIN_CAPACITY;
+
+	while( fhm_max_growth( capacity ) < count )
+	{
+		capacity <<= 1;
+	}
+
+	return capacity;
+}
+
+static bool fhm_create( lc_flat_hash_map_t* p_map, size_t capacity, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free, const lc_allocator_t* allocator )
+{
+	size_t actual_capacity = LC_FLAT_HASH_MAP_MIN_CAPACITY;
+
+	assert( p_map );
+	assert( hash_function );
+	assert( compare );
+
+	while( actual_capacity < capacity )
+	{
+		actual_capacity <<= 1;
+	}
+
+	p_map->alloc   = alloc;
+	p_map->free    = free;
+	lc_allocator_init( &p_map->allocator, allocator );
+	p_map->hash    = hash_function;
+	p_map->compare = compare;
+	p_map->destroy = destroy;
+	p_map->size    = 0;
+
+	return fhm_allocate( p_map, actual_capacity );
+}
+
+bool lc_flat_hash_map_create( lc_flat_hash_map_t* p_map, size_t capacity, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	return fhm_create( p_map, capacity, hash_function, destroy, compare, alloc, free, NULL );
+}
+
+bool lc_flat_hash_map_create_with_allocator( lc_flat_hash_map_t* p_map, size_t capacity, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	return fhm_create( p_map, capacity, hash_function, destroy, compare, malloc, free, allocator );
+}
+
+void lc_flat_hash_map_destroy( lc_flat_hash_map_t* p_map )
+{
+	assert( p_map );
+
+	lc_flat_hash_map_clear( p_map );
+	fhm_free( p_map, p_map->slots );
+
+	#ifdef _LC_FLAT_HASH_MAP_DEBUG
+	p_map->slots    = NULL;
+	p_map->ctrl     = NULL;
+	p_map->capacity = 0;
+	#endif
+}
+
+bool lc_flat_hash_map_insert( lc_flat_hash_map_t* __restrict p_map, const void* __restrict key, const void* __restrict value )
+{
+	size_t hash;
+	size_t index;
+
+	assert( p_map );
+
+	hash = fhm_hash( p_map, key );
+
+	if( fhm_find_index( p_map, key, hash, &index ) )
+	{
+		/* key is already in the map */
+		return false;
+	}
+
+	index = fhm_find_available( p_map, hash );
+
+	if( p_map->growth_left == 0 && p_map->ctrl[ index ] != FHM_DELETED )
+	{
+		/* Mostly tombstones? Then rehash in place rather than grow. */
+		size_t new_capacity = p_map->size <= fhm_max_growth( p_map->capacity ) / 2 ?
+		                      p_map->capacity : p_map->capacity * 2;
+
+		if( !fhm_resize( p_map, new_capacity ) )
+		{
+			return false;
+		}
+
+		index = fhm_find_available( p_map, hash );
+	}
+
+	if( p_map->ctrl[ index ] == FHM_EMPTY )
+	{
+		p_map->growth_left--;
+	}
+
+	fhm_set_ctrl( p_map, index, fhm_h2( hash ) );
+	p_map->slots[ index ].key   = (void *) key;
+	p_map->slots[ index ].value = (void *) value;
+	p_map->size++;
+
+	return true;
+}
+
+bool lc_flat_hash_map_remove( lc_flat_hash_map_t* __restrict p_map, const void* __restrict key )
+{
+	bool result = true;
+	size_t index;
+	size_t mask;
+	fhm_mask_t empty_before;
+	fhm_mask_t empty_after;
+
+	assert( p_map );
+
+	if( !fhm_find_index( p_map, key, fhm_hash( p_map, key ), &index ) )
+	{
+		/* nothing found */
+		return false;
+	}
+
+	DESTROY_CHECK(
+		result = p_map->destroy( p_map->slots[ index ].key, p_map->slots[ index ].value );
+	);
+
+	/* If every group that contains this slot also has an empty slot,
+	 * then no probe sequence could have continued past it and the slot
+	 * can be marked as empty instead of leaving a tombstone.
+	 */
+	mask         = p_map->capacity - 1;
+	empty_before = fhm_group_match_empty( p_map->ctrl + ((index - FHM_WIDTH) & mask) );
+	empty_after  = fhm_group_match_empty( p_map->ctrl + index );
+
+	if( empty_before && empty_after &&
+	    fhm_trailing_zeros( empty_after ) + fhm_leading_zeros( empty_before ) < FHM_WIDTH )
+	{
+		fhm_set_ctrl( p_map, index, FHM_EMPTY );
+		p_map->growth_left++;
+	}
+	else
+	{
+		fhm_set_ctrl( p_map, index, FHM_DELETED );
+	}
+
+	p_map->size--;
+
+	return result;
+}
+
+bool lc_flat_hash_map_find( const lc_flat_hash_map_t* __restrict p_map, const void* __restrict key, void** __restrict value )
+{
+	size_t index;
+
+	assert( p_map );
+
+	if( fhm_find_index( p_map, key, fhm_hash( p_map, key ), &index ) )
+	{
+		*value = p_map->slots[ index ].value;
+		return true;
+	}
+
+	/* nothing found */
+	*value = NULL;
+	return false;
+}
+
+void lc_flat_hash_map_clear( lc_flat_hash_map_t* p_map )
+{
+	size_t i;
+
+	assert( p_map );
+
+	for( i = 0; i < p_map->capacity && p_map->size > 0; i++ )
+	{
+		if( fhm_is_full( p_map->ctrl[ i ] ) )
+		{
+			DESTROY_CHECK(
+				p_map->destroy( p_map->slots[ i ].key, p_map->slots[ i ].value );
+			);
+			p_map->size--;
+		}
+	}
+
+	memset( p_map->ctrl, FHM_EMPTY, p_map->capacity + FHM_WIDTH );
+	p_map->size        = 0;
+	p_map->growth_left = fhm_max_growth( p_map->capacity );
+}
+
+bool lc_flat_hash_map_reserve( lc_flat_hash_map_t* p_map, size_t count )
+{
+	size_t capacity;
+
+	assert( p_map );
+
+	capacity = fhm_capacity_for( count );
+
+	if( capacity > p_map->capacity )
+	{
+		return fhm_resize( p_map, capacity );
+	}
+
+	return true;
+}
+
+void lc_flat_hash_map_iterator( const lc_flat_hash_map_t* p_map, lc_flat_hash_map_iterator_t* iter )
+{
+	assert( p_map );
+	assert( iter );
+
+	iter->map   = p_map;
+	iter->index = 0;
+	iter->key   = NULL;
+	iter->value = NULL;
+}
+
+bool lc_flat_hash_map_iterator_next( lc_flat_hash_map_iterator_t* iter )
+{
+	const lc_flat_hash_map_t* p_map;
+
+	assert( iter );
+	p_map = iter->map;
+
+	while( iter->index < p_map->capacity )
+	{
+		size_t index = iter->index++;
+
+		if( fhm_is_full( p_map->ctrl[ index ] ) )
+		{
+			iter->key   = p_map->slots[ index ].key;
+			iter->value = p_map->slots[ index ].value;
+			return true;
+		}
+	}
+
+	iter->key   = NULL;
+	iter->value = NULL;
+
+	return false;
+}
+
+void* lc_flat_hash_map_iterator_key( lc_flat_hash_map_iterator_t* iter )
+{
+	assert( iter );
+	return iter->key;
+}
+
+void* lc_flat_hash_map_iterator_value( lc_flat_hash_map_iterator_t* iter )
+{
+	assert( iter );
+	return iter->value;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_FLAT_HASH_MAP_H_
+#define _LC_FLAT_HASH_MAP_H_
+/**
+ * @file flat-hash-map.h
+ * @brief An open addressing hash map.
+ *
+ * Keys and values are stored directly in a flat array of slots alongside
+ * an array of control bytes (one per slot). Each control byte holds the
+ * state of the slot and 7 bits of the key's hash so that a group of 16
+ * slots can be probed at once (with SSE2 when available) before any key
+ * is compared.  The hash, compare and destroy callbacks are the same ones
+ * used by lc_hash_map_t.
+ *
+ * @defgroup lc_flat_hash_map Flat Hash Map
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "alloc.h"
+#include "hash-map.h"
+
+/* Number of slots probed at once. */
+#define LC_FLAT_HASH_MAP_GROUP_WIDTH        (16)
+
+/* Every capacity is a power of two and never less than a group. */
+#ifndef LC_FLAT_HASH_MAP_MIN_CAPACITY
+#define LC_FLAT_HASH_MAP_MIN_CAPACITY       LC_FLAT_HASH_MAP_GROUP_WIDTH
+#endif
+
+struct lc_flat_hash_map_slot;
+typedef struct lc_flat_hash_map_slot lc_flat_hash_map_slot_t;
+
+/**
+ * lc_flat_hash_map_t is an open addressing hash map collection object.
+ */
+typedef struct lc_flat_hash_map {
+	size_t   size;
+	size_t   capacity;
+	size_t   growth_left;
+	int8_t*  ctrl;
+	lc_flat_hash_map_slot_t* slots;
+
+	lc_hash_map_hash_fxn_t    hash;
+	lc_hash_map_compare_fxn_t compare;
+	lc_hash_map_element_fxn_t destroy;
+
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
+} lc_flat_hash_map_t;
+
+/**
+ * Create a flat hash map. The capacity is rounded up to a power of two.
+ */
+bool lc_flat_hash_map_create  ( lc_flat_hash_map_t* p_map, size_t capacity,
+                                lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy,
+                                lc_hash_map_compare_fxn_t compare,
+                                lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create a flat hash map whose memory comes from an allocator. If
+ * allocator is NULL, malloc() and free() are used.
+ */
+bool lc_flat_hash_map_create_with_allocator ( lc_flat_hash_map_t* p_map, size_t capacity,
+                                lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy,
+                                lc_hash_map_compare_fxn_t compare,
+                                const lc_allocator_t* allocator );
+/**
+ * Destroy a flat hash map. The destroy callback is called on every entry.
+ */
+void lc_flat_hash_map_destroy ( lc_flat_hash_map_t* p_map );
+/**
+ * Insert a key and value. Returns false if the key is already in the map
+ * or memory could not be allocated.  The map grows as needed.
+ */
+bool lc_flat_hash_map_insert  ( lc_flat_hash_map_t* __restrict p_map, const void* __restrict key, const void* __restrict value );
+/**
+ * Remove a key (and its value) from the map.
+ */
+bool lc_flat_hash_map_remove  ( lc_flat_hash_map_t* __restrict p_map, const void* __restrict key );
+/**
+ * Find the value for a key.
+ */
+bool lc_flat_hash_map_find    ( const lc_flat_hash_map_t* __restrict p_map, const void* __restrict key, void** __restrict value );
+/**
+ * Remove every entry from the map. No memory is released.
+ */
+void lc_flat_hash_map_clear   ( lc_flat_hash_map_t* p_map );
+/**
+ * Grow the map so that it can hold at least count entries without
+ * having to grow again.
+ */
+bool lc_flat_hash_map_reserve ( lc_flat_hash_map_t* p_map, size_t count );
+
+#define lc_flat_hash_map_size(p_map)          ((p_map)->size)
+#define lc_flat_hash_map_capacity(p_map)      ((p_map)->capacity)
+#define lc_flat_hash_map_load_factor(p_map)   (lc_flat_hash_map_size(p_map) / ((float) lc_flat_hash_map_capacity(p_map)))
+
+
+typedef struct lc_flat_hash_map_iter {
+	const lc_flat_hash_map_t* map;
+	size_t index;
+	void*  key;
+	void*  value;
+} lc_flat_hash_map_iterator_t;
+
+void    lc_flat_hash_map_iterator       ( const lc_flat_hash_map_t* p_map, lc_flat_hash_map_iterator_t* iter );
+bool    lc_flat_hash_map_iterator_next  ( lc_flat_hash_map_iterator_t* iter );
+void*   lc_flat_hash_map_iterator_key   ( lc_flat_hash_map_iterator_t* iter );
+void*   lc_flat_hash_map_iterator_value ( lc_flat_hash_map_iterator_t* iter );
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_FLAT_HASH_MAP_H_ */
@@ -68,34 +68,155 @@ size_t lc_pointer_hash( const void *data )
 }
 
 
-size_t lc_string_hash( const void *string_addr )
+/*
+ * 64-bit multiply-mix hashing (wyhash style).
+ */
+static uint64_t lc_hash_seed_value = 0;
+
+static const uint64_t hash_secret[ 4 ] = {
+	0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+	0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+/* 64x64 -> 128 bit multiply; a and b receive the low and high halves. */
+static inline void hash_mum( uint64_t *a, uint64_t *b )
 {
-	const char *str  = (const char*) string_addr;
-	size_t hash_code = 0;
-	size_t length    = strlen( str );
-	size_t i;
+#if defined(__SIZEOF_INT128__)
+	__extension__ __uint128_t r = (__uint128_t) *a * *b;
+	*a = (uint64_t) r;
+	*b = (uint64_t) (r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t) *a, lb = (uint32_t) *b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t  = rl + (rm0 << 32);
+	uint64_t lo = t + (rm1 << 32);
+	uint64_t c  = (t < rl) + (lo < t);
+	uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	*a = lo;
+	*b = hi;
+#endif
+}
 
-	for( i = 0; i < length; i++ )
-	{
-		hash_code = 31 * hash_code + str[ i ];
-	}
+static inline uint64_t hash_mix( uint64_t a, uint64_t b )
+{
+	hash_mum( &a, &b );
+	return a ^ b;
+}
 
-	return hash_code;
+static inline uint64_t hash_read8( const unsigned char *p )
+{
+	uint64_t v;
+	memcpy( &v, p, sizeof(v) );
+	return v;
 }
 
+static inline uint64_t hash_read4( const unsigned char *p )
+{
+	uint32_t v;
+	memcpy( &v, p, sizeof(v) );
+	return v;
+}
 
-size_t lc_memory_hash( const void *p_memory, size_t size )
+static inline uint64_t hash_read3( const unsigned char *p, size_t k )
+{
+	return (((uint64_t) p[ 0 ]) << 16) | (((uint64_t) p[ k >> 1 ]) << 8) | p[ k - 1 ];
+}
+
+static inline uint64_t hash_bytes( const void *key, size_t length, uint64_t seed )
 {
-	const unsigned char *bytes = (const unsigned char*) p_memory;
-	size_t hash_code           = 0;
-	size_t i;
+	const unsigned char *p = (const unsigned char *) key;
+	uint64_t a;
+	uint64_t b;
 
-	for( i = 0; i < size; i++ )
+	seed ^= hash_mix( seed ^ hash_secret[ 0 ], hash_secret[ 1 ] );
+
+	if( length <= 16 )
 	{
-		hash_code = 31 * hash_code + bytes[ i ];
+		if( length >= 4 )
+		{
+			a = (hash_read4( p ) << 32) | hash_read4( p + ((length >> 3) << 2) );
+			b = (hash_read4( p + length - 4 ) << 32) | hash_read4( p + length - 4 - ((length >> 3) << 2) );
+		}
+		else if( length > 0 )
+		{
+			a = hash_read3( p, length );
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
 	}
+	else
+	{
+		size_t i = length;
+
+		if( i >= 48 )
+		{
+			/* Three independent lanes of 16 bytes each. */
+			uint64_t see1 = seed;
+			uint64_t see2 = seed;
+
+			do {
+				seed = hash_mix( hash_read8( p ) ^ hash_secret[ 1 ], hash_read8( p + 8 ) ^ seed );
+				see1 = hash_mix( hash_read8( p + 16 ) ^ hash_secret[ 2 ], hash_read8( p + 24 ) ^ see1 );
+				see2 = hash_mix( hash_read8( p + 32 ) ^ hash_secret[ 3 ], hash_read8( p + 40 ) ^ see2 );
+				p += 48;
+				i -= 48;
+			} while( i >= 48 );
+
+			seed ^= see1 ^ see2;
+		}
+
+		while( i > 16 )
+		{
+			seed = hash_mix( hash_read8( p ) ^ hash_secret[ 1 ], hash_read8( p + 8 ) ^ seed );
+			i -= 16;
+			p += 16;
+		}
 
-	return hash_code;
+		/* The last 16 bytes (which may overlap the ones above) */
+		a = hash_read8( p + i - 16 );
+		b = hash_read8( p + i - 8 );
+	}
+
+	a ^= hash_secret[ 1 ];
+	b ^= seed;
+	hash_mum( &a, &b );
+
+	return hash_mix( a ^ hash_secret[ 0 ] ^ length, b ^ hash_secret[ 1 ] );
+}
+
+void lc_hash_seed_set( uint64_t seed )
+{
+	lc_hash_seed_value = seed;
+}
+
+uint64_t lc_hash_seed( void )
+{
+	return lc_hash_seed_value;
+}
+
+size_t lc_string_hash( const void *string_addr )
+{
+	const char *str = (const char*) string_addr;
+
+	return (size_t) hash_bytes( str, strlen( str ), lc_hash_seed_value );
+}
+
+size_t lc_string_hash_n( const char *string, size_t length )
+{
+	return (size_t) hash_bytes( string, length, lc_hash_seed_value );
+}
+
+size_t lc_memory_hash( const void *p_memory, size_t size )
+{
+	return (size_t) hash_bytes( p_memory, size, lc_hash_seed_value );
+}
+
+size_t lc_memory_hash_seeded( const void *p_memory, size_t size, uint64_t seed )
+{
+	return (size_t) hash_bytes( p_memory, size, seed );
 }
 
 size_t lc_ip_address_hash( const void *data )
@@ -24,13 +24,28 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+
+#include <stddef.h>
+#include <stdint.h>
+
 /*
  *   Hash Functions
+ *
+ *   The string and memory hashes are 64-bit multiply-mix hashes (in the
+ *   style of wyhash) that consume up to 48 bytes per step. They mix in a
+ *   per-process seed which is zero until lc_hash_seed_set() is called.
+ *   Setting a random seed at startup, before any table is filled, keeps
+ *   keys taken from outside the process from being chosen to collide.
  */
-size_t lc_pointer_hash    ( const void *data );
-size_t lc_string_hash     ( const void *string );
-size_t lc_memory_hash     ( const void *p_memory, size_t size );
-size_t lc_ip_address_hash ( const void *p_ip_string );
+size_t lc_pointer_hash       ( const void *data );
+size_t lc_string_hash        ( const void *string );
+size_t lc_string_hash_n      ( const char *string, size_t length );
+size_t lc_memory_hash        ( const void *p_memory, size_t size );
+size_t lc_memory_hash_seeded ( const void *p_memory, size_t size, uint64_t seed );
+size_t lc_ip_address_hash    ( const void *p_ip_string );
+
+void     lc_hash_seed_set ( uint64_t seed );
+uint64_t lc_hash_seed     ( void );
 
 #ifdef __cplusplus
 }
@@ -32,6 +32,7 @@
 struct lc_hash_map_node {
 	void *key;
 	void *value;
+	size_t hash; /* cached so that resizing never calls hash() */
 	struct lc_hash_map_node* next;
 };
 
@@ -52,12 +53,26 @@ struct lc_hash_map_list {
 		code
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define hm_prefetch( addr )       __builtin_prefetch( (addr), 0, 3 )
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define hm_prefetch( addr )       _mm_prefetch( (const char*) (addr), _MM_HINT_T0 )
+#else
+#define hm_prefetch( addr )
+#endif
+
+#define hm_alloc( p_map, size )   lc_allocator_alloc( &(p_map)->allocator, (p_map)->alloc, size )
+#define hm_free( p_map, ptr )     lc_allocator_free( &(p_map)->allocator, (p_map)->free, ptr )
+
 static inline void    hm_list_create        ( lc_hash_map_list_t *p_list, lc_hash_map_element_fxn_t destroy );
 static inline void    hm_list_destroy       ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list );
-static inline bool    hm_list_insert_front  ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, const void *key, const void *value ); /* O(1) */
+static inline bool    hm_list_insert_front  ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, const void *key, const void *value, size_t hash ); /* O(1) */
 static inline bool    hm_list_remove_front  ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list ); /* O(1) */
 static inline bool    hm_list_remove_next   ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, lc_hash_map_node_t *p_front_node ); /* O(1) */
 static inline void    hm_list_clear         ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list ); /* O(N) */
+static inline void    hm_list_append_node   ( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, lc_hash_map_node_t *p_node ); /* O(N) */
+static inline lc_hash_map_node_t* hm_list_find( const lc_hash_map_t *p_map, const lc_hash_map_list_t *p_list, const void *key, size_t hash, lc_hash_map_node_t **p_prev ); /* O(N) */
 #define hm_list_head(p_list)       ((p_list)->head)
 #define hm_list_size(p_list)       ((p_list)->size)
 #define hm_list_is_empty(p_list)   ((p_list)->size <= 0)
@@ -80,18 +95,19 @@ static inline void hm_list_destroy( lc_hash_map_t *p_map, lc_hash_map_list_t *p_
 	#endif
 }
 
-static inline bool hm_list_insert_front( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, const void *key, const void *value ) /* O(1) */
+static inline bool hm_list_insert_front( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, const void *key, const void *value, size_t hash ) /* O(1) */
 {
 	lc_hash_map_node_t *p_node;
 	assert( p_list );
 
-	p_node = (lc_hash_map_node_t *) p_map->alloc( sizeof(lc_hash_map_node_t) );
+	p_node = (lc_hash_map_node_t *) hm_alloc( p_map, sizeof(lc_hash_map_node_t) );
 	assert( p_node );
 
 	if( p_node != NULL )
 	{
 		p_node->key   = (void *) key;
 		p_node->value = (void *) value;
+		p_node->hash  = hash;
 		p_node->next  = p_list->head;
 
 		p_list->head = p_node;
@@ -115,7 +131,7 @@ static inline bool hm_list_remove_front( lc_hash_map_t *p_map, lc_hash_map_list_
 		result = p_list->destroy( p_list->head->key, p_list->head->value );
 	);
 
-	p_map->free( p_list->head );
+	hm_free( p_map, p_list->head );
 
 	p_list->head = p_node;
 
@@ -136,7 +152,7 @@ static inline bool hm_list_remove_next( lc_hash_map_t *p_map, lc_hash_map_list_t
 			result = p_list->destroy( p_node->key, p_node->value );
 		);
 
-		p_map->free( p_node );
+		hm_free( p_map, p_node );
 
 		p_front_node->next = p_new_next;
 
@@ -154,11 +170,189 @@ static inline void hm_list_clear( lc_hash_map_t *p_map, lc_hash_map_list_t *p_li
 	}
 }
 
+static inline void hm_list_append_node( lc_hash_map_t *p_map, lc_hash_map_list_t *p_list, lc_hash_map_node_t *p_node )
+{
+	lc_hash_map_node_t **pp_next;
+
+	#ifndef LC_HASH_MAP_PREALLOC
+	if( !p_list->head )
+	{
+		hm_list_create( p_list, p_map->destroy );
+	}
+	#endif
+
+	/* Appending keeps newer duplicates of a key in front of older ones. */
+	pp_next = &p_list->head;
+
+	while( *pp_next )
+	{
+		pp_next = &(*pp_next)->next;
+	}
+
+	p_node->next = NULL;
+	*pp_next     = p_node;
+}
+
+static inline lc_hash_map_node_t* hm_list_find( const lc_hash_map_t *p_map, const lc_hash_map_list_t *p_list, const void *key, size_t hash, lc_hash_map_node_t **p_prev )
+{
+	lc_hash_map_node_t *p_node = p_list->head;
+
+	*p_prev = NULL;
+
+	while( p_node != NULL )
+	{
+		/* Most mismatches are rejected without calling compare() */
+		if( p_node->hash == hash && p_map->compare(p_node->key, key) == 0 )
+		{
+			return p_node;
+		}
+
+		*p_prev = p_node;
+		p_node  = p_node->next;
+	}
+
+	return NULL;
+}
+
+/*
+ * Incremental Rehashing Functions
+ */
+static inline void hm_table_destroy( lc_hash_map_t *p_map, lc_hash_map_list_t *table, size_t table_size )
+{
+	size_t i;
+
+	for( i = 0; i < table_size; i++ )
+	{
+		#ifdef LC_HASH_MAP_PREALLOC
+		hm_list_destroy( p_map, &table[ i ] );
+		#else
+		lc_hash_map_list_t *p_list = &table[ i ];
+		if( p_list )
+		{
+			hm_list_destroy( p_map, p_list );
+		}
+		#endif
+	}
+
+	hm_free( p_map, table );
+}
+
+static inline bool hm_table_create( lc_hash_map_t *p_map, lc_hash_map_list_t **p_table, size_t table_size )
+{
+	*p_table = (lc_hash_map_list_t *) hm_alloc( p_map, table_size * sizeof(lc_hash_map_list_t) );
+
+	if( *p_table )
+	{
+		#ifdef LC_HASH_MAP_PREALLOC
+		size_t i;
+		for( i = 0; i < table_size; i++ )
+		{
+			hm_list_create( &(*p_table)[ i ], p_map->destroy );
+		}
+		#else
+		memset( *p_table, 0, table_size * sizeof(lc_hash_map_list_t) );
+		#endif
+	}
+
+	return *p_table != NULL;
+}
+
+static void hm_rehash_start( lc_hash_map_t *p_map, size_t new_size )
+{
+	lc_hash_map_list_t *p_new_table;
+
+	assert( !lc_hash_map_is_rehashing(p_map) );
+
+	if( hm_table_create( p_map, &p_new_table, new_size ) )
+	{
+		p_map->old_table      = p_map->table;
+		p_map->old_table_size = p_map->table_size;
+		p_map->rehash_index   = 0;
+		p_map->table          = p_new_table;
+		p_map->table_size     = new_size;
+	}
+	/* Otherwise we will try again on the next insert. */
+}
+
+/*
+ * Move up to `steps` buckets from the old table into the new table. So
+ * that a sparse table does not stall an operation, only a bounded number
+ * of empty buckets are visited.
+ */
+static void hm_rehash_step( lc_hash_map_t *p_map, size_t steps )
+{
+	size_t empty_visits = steps * 10;
+
+	while( steps > 0 && p_map->rehash_index < p_map->old_table_size )
+	{
+		lc_hash_map_list_t *p_old_list = &p_map->old_table[ p_map->rehash_index ];
+		lc_hash_map_node_t *p_node     = p_old_list->head;
+
+		p_map->rehash_index++;
+
+		if( !p_node )
+		{
+			if( --empty_visits == 0 )
+			{
+				break;
+			}
+			continue;
+		}
+
+		while( p_node )
+		{
+			lc_hash_map_node_t *p_next = p_node->next;
+			size_t index               = p_node->hash % lc_hash_map_table_size(p_map);
+
+			hm_list_append_node( p_map, &p_map->table[ index ], p_node );
+			p_node = p_next;
+		}
+
+		p_old_list->head = NULL;
+		steps--;
+	}
+
+	if( p_map->rehash_index >= p_map->old_table_size )
+	{
+		hm_free( p_map, p_map->old_table );
+		p_map->old_table      = NULL;
+		p_map->old_table_size = 0;
+		p_map->rehash_index   = 0;
+	}
+}
+
+static inline void hm_rehash_finish( lc_hash_map_t *p_map )
+{
+	while( lc_hash_map_is_rehashing(p_map) )
+	{
+		hm_rehash_step( p_map, p_map->old_table_size );
+	}
+}
+
+/*
+ * While rehashing, the buckets of the new table are followed by the
+ * buckets of the old table.
+ */
+static inline lc_hash_map_list_t* hm_bucket( const lc_hash_map_t *p_map, size_t index )
+{
+	if( index < lc_hash_map_table_size(p_map) )
+	{
+		return &p_map->table[ index ];
+	}
+
+	index -= lc_hash_map_table_size(p_map);
+	assert( index < p_map->old_table_size );
+
+	return &p_map->old_table[ index ];
+}
+
+#define hm_bucket_count(p_map)    (lc_hash_map_table_size(p_map) + (p_map)->old_table_size)
+
 
 /*
  * Hash Map Functions
  */
-bool lc_hash_map_create( lc_hash_map_t *p_map, size_t table_size, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+static bool hm_create( lc_hash_map_t *p_map, size_t table_size, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free, const lc_allocator_t* allocator )
 {
 	assert( p_map );
 	#ifdef LC_HASH_MAP_PREALLOC
@@ -167,14 +361,20 @@ bool lc_hash_map_create( lc_hash_map_t *p_map, size_t table_size, lc_hash_map_ha
 
 	p_map->alloc = alloc;
 	p_map->free  = free;
+	lc_allocator_init( &p_map->allocator, allocator );
 
 	p_map->size       = 0;
 	p_map->table_size = table_size;
-	p_map->table      = (lc_hash_map_list_t *) p_map->alloc( lc_hash_map_table_size(p_map) * sizeof(lc_hash_map_list_t) );
+	p_map->table      = (lc_hash_map_list_t *) hm_alloc( p_map, lc_hash_map_table_size(p_map) * sizeof(lc_hash_map_list_t) );
 	p_map->hash       = hash_function;
 	p_map->compare    = compare;
 	p_map->destroy    = destroy;
 
+	p_map->old_table       = NULL;
+	p_map->old_table_size  = 0;
+	p_map->rehash_index    = 0;
+	p_map->max_load_factor = 0.0f;
+
 	assert( p_map->table );
 
 	if( p_map->table )
@@ -192,36 +392,43 @@ bool lc_hash_map_create( lc_hash_map_t *p_map, size_t table_size, lc_hash_map_ha
 	return p_map->table != NULL;
 }
 
+bool lc_hash_map_create( lc_hash_map_t *p_map, size_t table_size, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	return hm_create( p_map, table_size, hash_function, destroy, compare, alloc, free, NULL );
+}
+
+bool lc_hash_map_create_with_allocator( lc_hash_map_t *p_map, size_t table_size, lc_hash_map_hash_fxn_t hash_function, lc_hash_map_element_fxn_t destroy, lc_hash_map_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	return hm_create( p_map, table_size, hash_function, destroy, compare, malloc, free, allocator );
+}
+
 void lc_hash_map_destroy( lc_hash_map_t *p_map )
 {
-	size_t i;
 	assert( p_map );
 
-	for( i = 0; i < lc_hash_map_table_size(p_map); i++ )
+	hm_table_destroy( p_map, p_map->table, lc_hash_map_table_size(p_map) );
+
+	if( lc_hash_map_is_rehashing(p_map) )
 	{
-		#ifdef LC_HASH_MAP_PREALLOC
-		hm_list_destroy( p_map, &p_map->table[ i ] );
-		#else
-		lc_hash_map_list_t *p_list = &p_map->table[ i ];
-		if( p_list )
-		{
-			hm_list_destroy( p_map, p_list );
-		}
-		#endif
+		hm_table_destroy( p_map, p_map->old_table, p_map->old_table_size );
+		p_map->old_table = NULL;
 	}
-
-	p_map->free( p_map->table );
 }
 
 bool lc_hash_map_insert( lc_hash_map_t* __restrict p_map, const void* __restrict key, const void* __restrict value )
 {
-	size_t index;
+	size_t hash;
 	lc_hash_map_list_t *p_list;
 
 	assert( p_map );
 
-	index   = p_map->hash( key ) % lc_hash_map_table_size(p_map);
-	p_list  = &p_map->table[ index ];
+	if( lc_hash_map_is_rehashing(p_map) )
+	{
+		hm_rehash_step( p_map, LC_HASH_MAP_REHASH_STEP );
+	}
+
+	hash    = p_map->hash( key );
+	p_list  = &p_map->table[ hash % lc_hash_map_table_size(p_map) ];
 
 	#ifndef LC_HASH_MAP_PREALLOC
 	if( !p_list->head )
@@ -231,9 +438,17 @@ bool lc_hash_map_insert( lc_hash_map_t* __restrict p_map, const void* __restrict
 	#endif
 
 
-	if( hm_list_insert_front( p_map, p_list, key, value ) )
+	if( hm_list_insert_front( p_map, p_list, key, value, hash ) )
 	{
 		p_map->size++;
+
+		if( p_map->max_load_factor > 0.0f &&
+		    !lc_hash_map_is_rehashing(p_map) &&
+		    lc_hash_map_load_factor(p_map) > p_map->max_load_factor )
+		{
+			hm_rehash_start( p_map, 2 * lc_hash_map_table_size(p_map) + 1 );
+		}
+
 		return true;
 	}
 
@@ -242,39 +457,42 @@ bool lc_hash_map_insert( lc_hash_map_t* __restrict p_map, const void* __restrict
 
 bool lc_hash_map_remove( lc_hash_map_t* __restrict p_map, const void* __restrict key )
 {
-	size_t index;
+	size_t hash;
 	lc_hash_map_node_t *p_prev;
 	lc_hash_map_list_t *p_list;
 	lc_hash_map_node_t *p_node;
 
 	assert( p_map );
 
-	index  = p_map->hash( key ) % lc_hash_map_table_size(p_map);
-	p_prev = NULL;
-	p_list = &p_map->table[ index ];
+	if( lc_hash_map_is_rehashing(p_map) )
+	{
+		hm_rehash_step( p_map, LC_HASH_MAP_REHASH_STEP );
+	}
 
-	assert( p_list );
-	p_node = p_list->head;
+	hash   = p_map->hash( key );
+	p_list = &p_map->table[ hash % lc_hash_map_table_size(p_map) ];
+	p_node = hm_list_find( p_map, p_list, key, hash, &p_prev );
 
-	while( p_node != NULL )
+	if( !p_node && lc_hash_map_is_rehashing(p_map) )
 	{
-		if( p_map->compare(p_node->key, key) == 0 )
+		/* Not migrated yet */
+		p_list = &p_map->old_table[ hash % p_map->old_table_size ];
+		p_node = hm_list_find( p_map, p_list, key, hash, &p_prev );
+	}
+
+	if( p_node != NULL )
+	{
+		/* Usually this returns true */
+		if( hm_list_remove_next( p_map, p_list, p_prev ) )
 		{
-			/* Usually this returns true */
-			if( hm_list_remove_next( p_map, p_list, p_prev ) )
-			{
-				p_map->size--;
-				return true;
-			}
-			else
-			{
-				assert( false );
-				return false;
-			}
+			p_map->size--;
+			return true;
+		}
+		else
+		{
+			assert( false );
+			return false;
 		}
-
-		p_prev = p_node;
-		p_node = p_node->next;
 	}
 
 	/* nothing found */
@@ -283,27 +501,25 @@ bool lc_hash_map_remove( lc_hash_map_t* __restrict p_map, const void* __restrict
 
 bool lc_hash_map_find( const lc_hash_map_t* __restrict p_map, const void* __restrict key, void** __restrict value )
 {
-	size_t index;
-	lc_hash_map_list_t* __restrict p_list;
+	size_t hash;
+	lc_hash_map_node_t* p_prev;
 	lc_hash_map_node_t* __restrict p_node;
 
 	assert( p_map );
 
-	index  = p_map->hash( key ) % lc_hash_map_table_size(p_map);
-	p_list = &p_map->table[ index ];
-
-	assert( p_list );
-	p_node = p_list->head;
+	hash   = p_map->hash( key );
+	p_node = hm_list_find( p_map, &p_map->table[ hash % lc_hash_map_table_size(p_map) ], key, hash, &p_prev );
 
-	while( p_node != NULL )
+	if( !p_node && lc_hash_map_is_rehashing(p_map) )
 	{
-		if( p_map->compare(p_node->key, key) == 0 )
-		{
-			*value = p_node->value;
-			return true;
-		}
+		/* Not migrated yet */
+		p_node = hm_list_find( p_map, &p_map->old_table[ hash % p_map->old_table_size ], key, hash, &p_prev );
+	}
 
-		p_node = p_node->next;
+	if( p_node != NULL )
+	{
+		*value = p_node->value;
+		return true;
 	}
 
 	/* nothing found */
@@ -311,17 +527,96 @@ bool lc_hash_map_find( const lc_hash_map_t* __restrict p_map, const void* __rest
 	return false;
 }
 
+void** lc_hash_map_find_ref( lc_hash_map_t* __restrict p_map, const void* __restrict key )
+{
+	size_t hash;
+	lc_hash_map_node_t* p_prev;
+	lc_hash_map_node_t* p_node;
+
+	assert( p_map );
+
+	hash   = p_map->hash( key );
+	p_node = hm_list_find( p_map, &p_map->table[ hash % lc_hash_map_table_size(p_map) ], key, hash, &p_prev );
+
+	if( !p_node && lc_hash_map_is_rehashing(p_map) )
+	{
+		/* Not migrated yet */
+		p_node = hm_list_find( p_map, &p_map->old_table[ hash % p_map->old_table_size ], key, hash, &p_prev );
+	}
+
+	return p_node ? &p_node->value : NULL;
+}
+
+size_t lc_hash_map_find_many( const lc_hash_map_t* __restrict p_map, const void* const* __restrict keys, size_t count, void** __restrict values )
+{
+	size_t hashes[ LC_HASH_MAP_FIND_BATCH ];
+	const lc_hash_map_list_t* lists[ LC_HASH_MAP_FIND_BATCH ];
+	size_t found = 0;
+	size_t start;
+
+	assert( p_map );
+	assert( keys || count == 0 );
+	assert( values || count == 0 );
+
+	for( start = 0; start < count; start += LC_HASH_MAP_FIND_BATCH )
+	{
+		size_t n = count - start < LC_HASH_MAP_FIND_BATCH ? count - start : LC_HASH_MAP_FIND_BATCH;
+		size_t i;
+
+		/* Hash the whole batch and prefetch every bucket */
+		for( i = 0; i < n; i++ )
+		{
+			hashes[ i ] = p_map->hash( keys[ start + i ] );
+			lists[ i ]  = &p_map->table[ hashes[ i ] % lc_hash_map_table_size(p_map) ];
+			hm_prefetch( lists[ i ] );
+		}
+
+		/* Then the first node of every chain */
+		for( i = 0; i < n; i++ )
+		{
+			if( lists[ i ]->head )
+			{
+				hm_prefetch( lists[ i ]->head );
+			}
+		}
+
+		for( i = 0; i < n; i++ )
+		{
+			lc_hash_map_node_t* p_prev;
+			lc_hash_map_node_t* p_node = hm_list_find( p_map, lists[ i ], keys[ start + i ], hashes[ i ], &p_prev );
+
+			if( !p_node && lc_hash_map_is_rehashing(p_map) )
+			{
+				/* Not migrated yet */
+				p_node = hm_list_find( p_map, &p_map->old_table[ hashes[ i ] % p_map->old_table_size ], keys[ start + i ], hashes[ i ], &p_prev );
+			}
+
+			if( p_node != NULL )
+			{
+				values[ start + i ] = p_node->value;
+				found++;
+			}
+			else
+			{
+				values[ start + i ] = NULL;
+			}
+		}
+	}
+
+	return found;
+}
+
 void lc_hash_map_clear( lc_hash_map_t *p_map )
 {
 	size_t i;
 	assert( p_map );
 
-	for( i = 0; i < lc_hash_map_table_size(p_map); i++ )
+	for( i = 0; i < hm_bucket_count(p_map); i++ )
 	{
 		#ifdef LC_HASH_MAP_PREALLOC
-		hm_list_clear( p_map, &p_map->table[ i ] );
+		hm_list_clear( p_map, hm_bucket( p_map, i ) );
 		#else
-		lc_hash_map_list_t *p_list = &p_map->table[ i ];
+		lc_hash_map_list_t *p_list = hm_bucket( p_map, i );
 		if( p_list )
 		{
 			hm_list_clear( p_map, p_list );
@@ -330,63 +625,84 @@ void lc_hash_map_clear( lc_hash_map_t *p_map )
 
 	}
 
+	if( lc_hash_map_is_rehashing(p_map) )
+	{
+		hm_free( p_map, p_map->old_table );
+		p_map->old_table      = NULL;
+		p_map->old_table_size = 0;
+		p_map->rehash_index   = 0;
+	}
+
 	p_map->size = 0;
 }
 
 bool lc_hash_map_resize( lc_hash_map_t *p_map, size_t new_size )
 {
-	if( new_size != lc_hash_map_size(p_map) )
+	assert( new_size > 0 );
+
+	hm_rehash_finish( p_map );
+
+	if( new_size != lc_hash_map_table_size(p_map) )
 	{
-		lc_hash_map_list_t *p_new_table = (lc_hash_map_list_t *) p_map->alloc( new_size * sizeof(lc_hash_map_list_t) );
 		lc_hash_map_list_t *p_old_table = p_map->table;
-		size_t old_size              = p_map->table_size;
+		size_t old_size                 = p_map->table_size;
+		lc_hash_map_node_t **tails;
 		size_t i;
 
-		assert( new_size > 0 );
-
-		if( !p_new_table )
+		if( !hm_table_create( p_map, &p_map->table, new_size ) )
 		{
+			p_map->table = p_old_table;
 			return false;
 		}
 
-		p_map->size       = 0;
-		p_map->table      = p_new_table;
-		p_map->table_size = new_size;
+		/* The last node of each new bucket, so that moving a node
+		 * there doesn't walk the chain. */
+		tails = (lc_hash_map_node_t **) hm_alloc( p_map, new_size * sizeof(lc_hash_map_node_t *) );
 
-		#ifdef LC_HASH_MAP_PREALLOC
-		for( i = 0; i < lc_hash_map_table_size(p_map); i++ )
+		if( !tails )
 		{
-			hm_list_create( &p_map->table[ i ], p_map->destroy );
+			hm_free( p_map, p_map->table );
+			p_map->table = p_old_table;
+			return false;
 		}
-		#else
-		memset( p_map->table, 0, new_size * sizeof(lc_hash_map_list_t) );
-		#endif
 
+		memset( tails, 0, new_size * sizeof(lc_hash_map_node_t *) );
+		p_map->table_size = new_size;
+
+		/* Move the existing nodes into the new table; nothing is
+		 * allocated or freed besides the bucket arrays and tails. Nodes are
+		 * appended, so duplicates of a key keep their order.
+		 */
 		for( i = 0; i < old_size; i++ )
 		{
-			lc_hash_map_list_t *p_list = &p_old_table[ i ];
+			lc_hash_map_node_t *p_node = hm_list_head( &p_old_table[ i ] );
 
-			if( p_list )
+			while( p_node )
 			{
-				lc_hash_map_node_t *p_node = hm_list_head( p_list );
-				while( p_node )
-				{
-					lc_hash_map_node_t *p_previous;
-					void *key   = p_node->key;
-					void *value = p_node->value;
-
-					/* Re-insert data into new table */
-					lc_hash_map_insert( p_map, key, value );
+				lc_hash_map_node_t *p_next = p_node->next;
+				size_t index               = p_node->hash % new_size;
 
-					p_previous = p_node;
-					p_node     = p_node->next;
+				p_node->next = NULL;
 
-					p_map->free( p_previous );
+				if( tails[ index ] )
+				{
+					tails[ index ]->next = p_node;
 				}
+				else
+				{
+					#ifndef LC_HASH_MAP_PREALLOC
+					hm_list_create( &p_map->table[ index ], p_map->destroy );
+					#endif
+					p_map->table[ index ].head = p_node;
+				}
+
+				tails[ index ] = p_node;
+				p_node = p_next;
 			}
 		}
 
-		p_map->free( p_old_table );
+		hm_free( p_map, tails );
+		hm_free( p_map, p_old_table );
 
 		return true;
 	}
@@ -442,9 +758,9 @@ bool lc_hash_map_serialize( lc_hash_map_t *p_map, size_t key_size, size_t value_
 		goto done;
 	}
 
-	for( i = 0; i < lc_hash_map_table_size(p_map); i++ )
+	for( i = 0; i < hm_bucket_count(p_map); i++ )
 	{
-		lc_hash_map_list_t *p_list = &p_map->table[ i ];
+		lc_hash_map_list_t *p_list = hm_bucket( p_map, i );
 		if( p_list )
 		{
 			lc_hash_map_node_t *p_node = p_list->head;
@@ -493,21 +809,21 @@ bool lc_hash_map_unserialize( lc_hash_map_t *p_map, size_t key_size, size_t valu
 		void *p_key;
 		void *p_val;
 
-		p_key = p_map->alloc( key_size );
+		p_key = hm_alloc( p_map, key_size );
 
 		if( fread( p_key, key_size, 1, file ) != 1 )
 		{
-			p_map->free( p_key );
+			hm_free( p_map, p_key );
 			result = false;
 			goto done;
 		}
 
-		p_val = p_map->alloc( value_size );
+		p_val = hm_alloc( p_map, value_size );
 
 		if( fread( p_val, value_size, 1, file ) != 1 )
 		{
-			p_map->free( p_key );
-			p_map->free( p_val );
+			hm_free( p_map, p_key );
+			hm_free( p_map, p_val );
 			result = false;
 			goto done;
 		}
@@ -534,6 +850,13 @@ void lc_hash_map_free_set( lc_hash_map_t *p_map, lc_free_fxn_t free )
 	p_map->free = free;
 }
 
+void lc_hash_map_auto_grow_set( lc_hash_map_t *p_map, float max_load_factor )
+{
+	assert( p_map );
+	assert( max_load_factor >= 0.0f );
+	p_map->max_load_factor = max_load_factor;
+}
+
 void lc_hash_map_iterator( const lc_hash_map_t* p_map, lc_hash_map_iterator_t* iter )
 {
 	assert( p_map );
@@ -567,9 +890,9 @@ bool lc_hash_map_iterator_next( lc_hash_map_iterator_t* iter )
 
 	if( !iter->current )
 	{
-		while( iter->index < lc_hash_map_table_size(iter->map) )
+		while( iter->index < hm_bucket_count(iter->map) )
 		{
-			lc_hash_map_list_t *p_list = &iter->map->table[ iter->index ];
+			lc_hash_map_list_t *p_list = hm_bucket( iter->map, iter->index );
 
 			if( p_list && p_list->head )
 			{
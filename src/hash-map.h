@@ -29,6 +29,11 @@ extern "C" {
 #include <stdbool.h>
 #include "alloc.h"
 
+/* Number of keys hashed and prefetched together by lc_hash_map_find_many() */
+#ifndef LC_HASH_MAP_FIND_BATCH
+#define LC_HASH_MAP_FIND_BATCH         (16)
+#endif
+
 /* Each size is a prime number */
 #ifndef LC_HASH_MAP_SIZE_SMALL
 #define LC_HASH_MAP_SIZE_SMALL         (101)
@@ -51,6 +56,11 @@ extern "C" {
 #define LC_HASH_MAP_THRESHOLD               (0.7)
 #endif
 
+/* Number of buckets migrated by each insert/remove while growing. */
+#ifndef LC_HASH_MAP_REHASH_STEP
+#define LC_HASH_MAP_REHASH_STEP             (4)
+#endif
+
 
 
 typedef size_t  (*lc_hash_map_hash_fxn_t)    ( const void *key );
@@ -68,18 +78,29 @@ typedef struct lc_hash_map {
 	size_t           table_size;
 	lc_hash_map_list_t* table;
 
+	/* Used while growing incrementally; see lc_hash_map_auto_grow_set() */
+	lc_hash_map_list_t* old_table;
+	size_t           old_table_size;
+	size_t           rehash_index;
+	float            max_load_factor;
+
 	lc_hash_map_hash_fxn_t    hash;
 	lc_hash_map_compare_fxn_t compare;
 	lc_hash_map_element_fxn_t destroy;
 
 	lc_alloc_fxn_t  alloc;
 	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
 } lc_hash_map_t;
 
 bool      lc_hash_map_create      ( lc_hash_map_t *p_map, size_t table_size,
                                  lc_hash_map_hash_fxn_t hash_fxn_t, lc_hash_map_element_fxn_t destroy,
                                  lc_hash_map_compare_fxn_t compare,
                                  lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+bool      lc_hash_map_create_with_allocator ( lc_hash_map_t *p_map, size_t table_size,
+                                 lc_hash_map_hash_fxn_t hash_fxn_t, lc_hash_map_element_fxn_t destroy,
+                                 lc_hash_map_compare_fxn_t compare,
+                                 const lc_allocator_t* allocator );
 void      lc_hash_map_destroy     ( lc_hash_map_t* p_map );
 bool      lc_hash_map_insert      ( lc_hash_map_t* __restrict p_map, const void* __restrict key, const void* __restrict value );
 bool      lc_hash_map_remove      ( lc_hash_map_t* __restrict p_map, const void* __restrict key );
@@ -89,9 +110,31 @@ bool      lc_hash_map_resize      ( lc_hash_map_t *p_map, size_t new_size );
 bool      lc_hash_map_rehash      ( lc_hash_map_t *p_map, float load_factor );
 bool      lc_hash_map_serialize   ( lc_hash_map_t *p_map, size_t key_size, size_t value_size, FILE *file );
 bool      lc_hash_map_unserialize ( lc_hash_map_t *p_map, size_t key_size, size_t value_size, FILE *file );
+/*
+ * Get the address of the value stored for key, or NULL if the key is not
+ * in the map, so that the value can be replaced in place.
+ */
+void**    lc_hash_map_find_ref    ( lc_hash_map_t* __restrict p_map, const void* __restrict key );
+/*
+ * Look up count keys at once. values[i] receives the value for keys[i] or
+ * NULL if it is not in the map. The keys are hashed and their buckets
+ * prefetched LC_HASH_MAP_FIND_BATCH at a time before any chain is walked,
+ * so the cache misses of a batch overlap. Returns the number of keys found.
+ */
+size_t    lc_hash_map_find_many   ( const lc_hash_map_t* __restrict p_map, const void* const* __restrict keys, size_t count, void** __restrict values );
 void      lc_hash_map_alloc_set   ( lc_hash_map_t *p_map, lc_alloc_fxn_t alloc );
 void      lc_hash_map_free_set    ( lc_hash_map_t *p_map, lc_free_fxn_t free );
 
+/*
+ * Opt-in automatic growth. Once the load factor exceeds max_load_factor
+ * the map starts moving its entries into a table twice as large, a few
+ * buckets at a time on each insert and remove, instead of rebuilding
+ * the whole table at once. Lookups search both tables in the meantime.
+ * A max_load_factor of 0 turns automatic growth off.
+ */
+void      lc_hash_map_auto_grow_set ( lc_hash_map_t *p_map, float max_load_factor );
+
+#define   lc_hash_map_is_rehashing(p_map) ((p_map)->old_table != NULL)
 #define   lc_hash_map_size(p_map)         ((p_map)->size)
 #define   lc_hash_map_table_size(p_map)   ((p_map)->table_size)
 #define   lc_hash_map_load_factor(p_map)  (lc_hash_map_size(p_map) / ((float) lc_hash_map_table_size(p_map)))
@@ -27,10 +27,43 @@
 #include <math.h>
 #include "hash-table.h"
 
+/*
+ * Every element is kept in an lc_slist_node_t that carries the element's
+ * hash. Lookups skip nodes whose hash does not match without calling
+ * compare() and resizing relinks the nodes without calling hash().  The
+ * lists still own these nodes so lc_slist_clear() and friends work.
+ */
+typedef struct lc_hash_table_node {
+	lc_slist_node_t base;
+	size_t hash;
+} lc_hash_table_node_t;
+
+#define ht_node_hash(p_node)   (((const lc_hash_table_node_t *) (p_node))->hash)
+
+#define ht_alloc( p_table, size )   lc_allocator_alloc( &(p_table)->allocator, (p_table)->alloc, size )
+#define ht_free( p_table, ptr )     lc_allocator_free( &(p_table)->allocator, (p_table)->free, ptr )
+
+/* The lists free our nodes so they must use the table's allocator. */
+static inline void ht_list_create( lc_hash_table_t* p_table, lc_slist_t *p_list )
+{
+	lc_slist_create( p_list, p_table->destroy, p_table->alloc, p_table->free );
+	p_list->allocator = p_table->allocator;
+}
+
+static inline void ht_list_prepare( lc_hash_table_t* p_table, lc_slist_t *p_list )
+{
+	#ifndef LC_HASH_TABLE_PREALLOC
+	if( !p_list->head ) /* uninitialized list */
+	{
+		ht_list_create( p_table, p_list );
+	}
+	#endif
+}
+
 /*
  * Hash Table Functions
  */
-bool lc_hash_table_create( lc_hash_table_t* p_table, size_t table_size, lc_hash_table_hash_fxn_t hash_function, lc_hash_table_element_fxn_t destroy, lc_hash_table_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+static bool ht_create( lc_hash_table_t* p_table, size_t table_size, lc_hash_table_hash_fxn_t hash_function, lc_hash_table_element_fxn_t destroy, lc_hash_table_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free, const lc_allocator_t* allocator )
 {
 	assert( p_table );
 
@@ -38,7 +71,8 @@ bool lc_hash_table_create( lc_hash_table_t* p_table, size_t table_size, lc_hash_
 	p_table->table_size = table_size;
 	p_table->alloc      = alloc;
 	p_table->free       = free;
-	p_table->table      = (lc_slist_t *) p_table->alloc( lc_hash_table_table_size(p_table) * sizeof(lc_slist_t) );
+	lc_allocator_init( &p_table->allocator, allocator );
+	p_table->table      = (lc_slist_t *) ht_alloc( p_table, lc_hash_table_table_size(p_table) * sizeof(lc_slist_t) );
 	p_table->hash       = hash_function;
 	p_table->compare    = compare;
 	p_table->destroy    = destroy;
@@ -51,7 +85,7 @@ bool lc_hash_table_create( lc_hash_table_t* p_table, size_t table_size, lc_hash_
 		int i;
 		for( i = 0; i < lc_hash_table_table_size(p_table); i++ )
 		{
-			lc_slist_create( &p_table->table[ i ], p_table->destroy, p_table->alloc, p_table->free );
+			ht_list_create( p_table, &p_table->table[ i ] );
 		}
 		#else
 		memset( p_table->table, 0, lc_hash_table_table_size(p_table) * sizeof(lc_slist_t) );
@@ -61,6 +95,16 @@ bool lc_hash_table_create( lc_hash_table_t* p_table, size_t table_size, lc_hash_
 	return p_table->table != NULL;
 }
 
+bool lc_hash_table_create( lc_hash_table_t* p_table, size_t table_size, lc_hash_table_hash_fxn_t hash_function, lc_hash_table_element_fxn_t destroy, lc_hash_table_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	return ht_create( p_table, table_size, hash_function, destroy, compare, alloc, free, NULL );
+}
+
+bool lc_hash_table_create_with_allocator( lc_hash_table_t* p_table, size_t table_size, lc_hash_table_hash_fxn_t hash_function, lc_hash_table_element_fxn_t destroy, lc_hash_table_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	return ht_create( p_table, table_size, hash_function, destroy, compare, malloc, free, allocator );
+}
+
 void lc_hash_table_destroy( lc_hash_table_t* p_table )
 {
 	size_t i;
@@ -78,23 +122,28 @@ void lc_hash_table_destroy( lc_hash_table_t* p_table )
 		#endif
 	}
 
-	p_table->free( p_table->table );
+	ht_free( p_table, p_table->table );
 }
 
 bool lc_hash_table_insert( lc_hash_table_t* p_table, const void *data )
 {
-	size_t index     = p_table->hash( data ) % lc_hash_table_table_size(p_table);
-	lc_slist_t *p_list  = &p_table->table[ index ];
+	size_t hash         = p_table->hash( data );
+	lc_slist_t *p_list  = &p_table->table[ hash % lc_hash_table_table_size(p_table) ];
+	lc_hash_table_node_t *p_node;
 
-	#ifndef LC_HASH_TABLE_PREALLOC
-	if( !p_list->head ) /* uninitialized list */
-	{
-		lc_slist_create( p_list, p_table->destroy, p_table->alloc, p_table->free );
-	}
-	#endif
+	ht_list_prepare( p_table, p_list );
 
-	if( lc_slist_push( p_list, data ) )
+	p_node = (lc_hash_table_node_t *) ht_alloc( p_table, sizeof(lc_hash_table_node_t) );
+
+	if( p_node )
 	{
+		p_node->base.data = (void *) data;
+		p_node->base.next = p_list->head;
+		p_node->hash      = hash;
+
+		p_list->head = &p_node->base;
+		p_list->size++;
+
 		p_table->size++;
 		return true;
 	}
@@ -104,8 +153,8 @@ bool lc_hash_table_insert( lc_hash_table_t* p_table, const void *data )
 
 bool lc_hash_table_remove( lc_hash_table_t* p_table, const void *data )
 {
-	size_t index         = p_table->hash( data ) % lc_hash_table_table_size(p_table);
-	lc_slist_t *p_list      = &p_table->table[ index ];
+	size_t hash             = p_table->hash( data );
+	lc_slist_t *p_list      = &p_table->table[ hash % lc_hash_table_table_size(p_table) ];
 	lc_slist_node_t *p_prev = NULL;
 	lc_slist_node_t *p_node;
 
@@ -114,7 +163,7 @@ bool lc_hash_table_remove( lc_hash_table_t* p_table, const void *data )
 
 	while( p_node != NULL )
 	{
-		if( p_table->compare( p_node->data, data ) == 0 )
+		if( ht_node_hash(p_node) == hash && p_table->compare( p_node->data, data ) == 0 )
 		{
 			/* Usually this returns true */
 			if( lc_slist_remove_next( p_list, p_prev ) )
@@ -138,8 +187,8 @@ bool lc_hash_table_remove( lc_hash_table_t* p_table, const void *data )
 
 bool lc_hash_table_find( const lc_hash_table_t* p_table, const void *data, void **found_data )
 {
-	size_t index    = p_table->hash( data ) % lc_hash_table_table_size(p_table);
-	lc_slist_t *p_list = &p_table->table[ index ];
+	size_t hash        = p_table->hash( data );
+	lc_slist_t *p_list = &p_table->table[ hash % lc_hash_table_table_size(p_table) ];
 	lc_slist_node_t *p_node;
 
 	assert( found_data );
@@ -149,7 +198,7 @@ bool lc_hash_table_find( const lc_hash_table_t* p_table, const void *data, void
 
 	while( p_node != NULL )
 	{
-		if( p_table->compare( p_node->data, data ) == 0 )
+		if( ht_node_hash(p_node) == hash && p_table->compare( p_node->data, data ) == 0 )
 		{
 			*found_data = p_node->data;
 			assert( *found_data );
@@ -186,58 +235,79 @@ void lc_hash_table_clear( lc_hash_table_t* p_table )
 
 bool lc_hash_table_resize( lc_hash_table_t* p_table, size_t new_size )
 {
-	if( new_size != lc_hash_table_size(p_table) )
+	assert( new_size > 0 );
+
+	if( new_size != lc_hash_table_table_size(p_table) )
 	{
-		lc_slist_t *p_new_table = (lc_slist_t *) p_table->alloc( new_size * sizeof(lc_slist_t) );
+		lc_slist_t *p_new_table = (lc_slist_t *) ht_alloc( p_table, new_size * sizeof(lc_slist_t) );
 		lc_slist_t *p_old_table = p_table->table;
-		size_t old_size    = p_table->table_size;
+		size_t old_size         = p_table->table_size;
+		lc_slist_node_t **tails;
 		size_t i;
 
-		assert( new_size > 0 );
-
 		if( !p_new_table )
 		{
 			return false;
 		}
 
-		p_table->size       = 0;
+		/* The last node of each new bucket, so that moving a node
+		 * there doesn't walk the chain. */
+		tails = (lc_slist_node_t **) ht_alloc( p_table, new_size * sizeof(lc_slist_node_t *) );
+
+		if( !tails )
+		{
+			ht_free( p_table, p_new_table );
+			return false;
+		}
+
+		memset( tails, 0, new_size * sizeof(lc_slist_node_t *) );
+
 		p_table->table      = p_new_table;
 		p_table->table_size = new_size;
 
 		#ifdef LC_HASH_TABLE_PREALLOC
 		for( i = 0; i < lc_hash_table_table_size(p_table); i++ )
 		{
-			lc_slist_create( &p_table->table[ i ], p_table->destroy, p_table->alloc, p_table->free );
+			ht_list_create( p_table, &p_table->table[ i ] );
 		}
 		#else
 		memset( p_table->table, 0, new_size * sizeof(lc_slist_t) );
 		#endif
 
+		/* Move the existing nodes into the new table; nothing is
+		 * allocated or freed besides the bucket arrays and tails. Nodes are
+		 * appended, so newer duplicates stay in front of older ones.
+		 */
 		for( i = 0; i < old_size; i++ )
 		{
-			lc_slist_t *p_list = &p_old_table[ i ];
-			p_list->destroy = NULL; /* prevent the data from being freed */
+			lc_slist_node_t *p_node = p_old_table[ i ].head;
 
-			if( p_list )
+			while( p_node )
 			{
-				lc_slist_node_t *p_node = lc_slist_head( p_list );
-				while( p_node )
-				{
-					lc_slist_node_t *p_previous;
-					void *data = p_node->data;
+				lc_slist_node_t *p_next = p_node->next;
+				size_t index            = ht_node_hash(p_node) % new_size;
+				lc_slist_t *p_list      = &p_table->table[ index ];
 
-					/* Re-insert data into new table */
-					lc_hash_table_insert( p_table, data );
+				p_node->next = NULL;
 
-					p_previous = p_node;
-					p_node     = p_node->next;
-
-					p_table->free( p_previous );
+				if( tails[ index ] )
+				{
+					tails[ index ]->next = p_node;
 				}
+				else
+				{
+					ht_list_prepare( p_table, p_list );
+					p_list->head = p_node;
+				}
+
+				tails[ index ] = p_node;
+				p_list->size++;
+				p_node = p_next;
 			}
 		}
 
-		p_table->free( p_old_table );
+		ht_free( p_table, tails );
+		ht_free( p_table, p_old_table );
 
 		return true;
 	}
@@ -333,11 +403,11 @@ bool lc_hash_table_unserialize( lc_hash_table_t* p_table, size_t element_size, F
 
 	while( count > 0 && feof(file) == 0 )
 	{
-		void *p_data = p_table->alloc( element_size );
+		void *p_data = ht_alloc( p_table, element_size );
 
 		if( fread( p_data, element_size, 1, file ) != 1 )
 		{
-			p_table->free( p_data );
+			ht_free( p_table, p_data );
 			result = false;
 			goto done;
 		}
@@ -67,9 +67,11 @@ typedef struct lc_hash_table {
 
 	lc_alloc_fxn_t  alloc;
 	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
 } lc_hash_table_t;
 
 bool      lc_hash_table_create      ( lc_hash_table_t* p_table, size_t table_size, lc_hash_table_hash_fxn_t hash_function, lc_hash_table_element_fxn_t destroy_callback, lc_hash_table_compare_fxn_t compare_callback, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+bool      lc_hash_table_create_with_allocator ( lc_hash_table_t* p_table, size_t table_size, lc_hash_table_hash_fxn_t hash_function, lc_hash_table_element_fxn_t destroy_callback, lc_hash_table_compare_fxn_t compare_callback, const lc_allocator_t* allocator );
 void      lc_hash_table_destroy     ( lc_hash_table_t* p_table );
 bool      lc_hash_table_insert      ( lc_hash_table_t* p_table, const void *data );
 bool      lc_hash_table_remove      ( lc_hash_table_t* p_table, const void *data );
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "interval-tree.h"
+
+#if defined(LC_INTERVAL_TREE_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
+	#define DESTROY_CHECK( code ) \
+		if( p_tree->destroy ) \
+		{ \
+			code \
+		}
+#else
+	#define DESTROY_CHECK( code ) \
+		code
+#endif
+
+#define itree_alloc( p_tree, size )  lc_allocator_alloc( &(p_tree)->tree._allocator, (p_tree)->tree._alloc, size )
+#define itree_free( p_tree, ptr )    lc_allocator_free( &(p_tree)->tree._allocator, (p_tree)->tree._free, ptr )
+
+/*
+ * The element of each red-black tree node. The rbtree callbacks only get
+ * elements, so each entry knows which tree it belongs to.
+ */
+typedef struct itree_entry {
+	void* low;
+	void* high;
+	void* value;
+	void* max;      /* the largest high endpoint in this subtree */
+	const lc_interval_tree_t* owner;
+} itree_entry_t;
+
+#define itree_entry( p_node )   ((itree_entry_t *) (p_node)->data)
+
+/* Order by low endpoint, then high endpoint, then value. */
+static int itree_entry_compare( const void *p_left, const void *p_right )
+{
+	const itree_entry_t* left  = p_left;
+	const itree_entry_t* right = p_right;
+	int c = left->owner->compare( left->low, right->low );
+
+	if( c == 0 )
+	{
+		c = left->owner->compare( left->high, right->high );
+	}
+
+	if( c == 0 )
+	{
+		uintptr_t l = (uintptr_t) left->value;
+		uintptr_t r = (uintptr_t) right->value;
+		c = (l > r) - (l < r);
+	}
+
+	return c;
+}
+
+static bool itree_entry_destroy( void *p_data )
+{
+	itree_entry_t* entry = p_data;
+	lc_interval_tree_t* p_tree = (lc_interval_tree_t*) entry->owner;
+	bool result = true;
+
+	DESTROY_CHECK(
+		result = p_tree->destroy( entry->low, entry->high, entry->value );
+	);
+
+	itree_free( p_tree, entry );
+	return result;
+}
+
+static void itree_augment( lc_rbnode_t *p_node, void *user_data )
+{
+	const lc_interval_tree_t* p_tree = user_data;
+	itree_entry_t* entry = itree_entry( p_node );
+
+	entry->max = entry->high;
+
+	if( p_node->left != lc_rbtree_end( ) && p_tree->compare( itree_entry( p_node->left )->max, entry->max ) > 0 )
+	{
+		entry->max = itree_entry( p_node->left )->max;
+	}
+
+	if( p_node->right != lc_rbtree_end( ) && p_tree->compare( itree_entry( p_node->right )->max, entry->max ) > 0 )
+	{
+		entry->max = itree_entry( p_node->right )->max;
+	}
+}
+
+void lc_interval_tree_create( lc_interval_tree_t* p_tree, lc_interval_tree_element_fxn_t destroy, lc_interval_tree_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	assert( p_tree );
+	#if !defined(LC_INTERVAL_TREE_DESTROY_CHECK) && !defined(DESTROY_CHECK_ALL)
+	assert( destroy );
+	#endif
+	assert( compare );
+
+	p_tree->compare = compare;
+	p_tree->destroy = destroy;
+	lc_rbtree_create( &p_tree->tree, itree_entry_destroy, itree_entry_compare, alloc, free );
+	lc_rbtree_augment_set( &p_tree->tree, itree_augment, p_tree );
+}
+
+void lc_interval_tree_create_with_allocator( lc_interval_tree_t* p_tree, lc_interval_tree_element_fxn_t destroy, lc_interval_tree_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	lc_interval_tree_create( p_tree, destroy, compare, malloc, free );
+	lc_allocator_init( &p_tree->tree._allocator, allocator );
+}
+
+void lc_interval_tree_destroy( lc_interval_tree_t* p_tree )
+{
+	assert( p_tree );
+	lc_rbtree_destroy( &p_tree->tree );
+}
+
+bool lc_interval_tree_insert( lc_interval_tree_t* p_tree, const void *low, const void *high, const void *value )
+{
+	itree_entry_t* entry;
+
+	assert( p_tree );
+	assert( p_tree->compare( low, high ) <= 0 );
+
+	entry = (itree_entry_t*) itree_alloc( p_tree, sizeof(itree_entry_t) );
+	if( !entry ) return false;
+
+	entry->low   = (void*) low;
+	entry->high  = (void*) high;
+	entry->value = (void*) value;
+	entry->max   = (void*) high;
+	entry->owner = p_tree;
+
+	if( !lc_rbtree_insert( &p_tree->tree, entry ) )
+	{
+		itree_free( p_tree, entry );
+		return false;
+	}
+
+	return true;
+}
+
+bool lc_interval_tree_remove( lc_interval_tree_t* p_tree, const void *low, const void *high, const void *value )
+{
+	itree_entry_t key;
+
+	assert( p_tree );
+
+	key.low   = (void*) low;
+	key.high  = (void*) high;
+	key.value = (void*) value;
+	key.max   = NULL;
+	key.owner = p_tree;
+
+	return lc_rbtree_remove( &p_tree->tree, &key );
+}
+
+void lc_interval_tree_clear( lc_interval_tree_t* p_tree )
+{
+	assert( p_tree );
+	lc_rbtree_clear( &p_tree->tree );
+}
+
+/*
+ * In order, skipping subtrees whose intervals all end before low and,
+ * once an entry begins after high, everything to its right.
+ */
+static size_t itree_overlaps( const lc_interval_tree_t* p_tree, const lc_rbnode_t *t, const void *low, const void *high,
+                              lc_interval_tree_visit_fxn_t visit, void *user_data, bool *p_stop )
+{
+	size_t count = 0;
+
+	while( t != lc_rbtree_end( ) && !*p_stop )
+	{
+		const itree_entry_t* entry = itree_entry( t );
+
+		if( p_tree->compare( entry->max, low ) < 0 )
+		{
+			break;
+		}
+
+		count += itree_overlaps( p_tree, t->left, low, high, visit, user_data, p_stop );
+
+		if( *p_stop || p_tree->compare( entry->low, high ) > 0 )
+		{
+			break;
+		}
+
+		if( p_tree->compare( entry->high, low ) >= 0 )
+		{
+			count++;
+
+			if( !visit( entry->low, entry->high, entry->value, user_data ) )
+			{
+				*p_stop = true;
+				break;
+			}
+		}
+
+		t = t->right;
+	}
+
+	return count;
+}
+
+size_t lc_interval_tree_overlaps( const lc_interval_tree_t* p_tree, const void *low, const void *high, lc_interval_tree_visit_fxn_t visit, void *user_data )
+{
+	bool stop = false;
+
+	assert( p_tree );
+	assert( visit );
+
+	return itree_overlaps( p_tree, lc_rbtree_root( &p_tree->tree ), low, high, visit, user_data, &stop );
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_INTERVAL_TREE_H_
+#define _LC_INTERVAL_TREE_H_
+/**
+ * @file interval-tree.h
+ * @brief A set of closed intervals with overlap queries.
+ *
+ * The intervals are kept in an lc_rbtree_t ordered by their low endpoint.
+ * Through lc_rbtree_augment_set() every entry also holds the largest high
+ * endpoint in its subtree. An overlap query uses it to skip every subtree
+ * that ends before the query begins, and uses the order to skip every
+ * subtree that begins after it ends. Endpoints are compared with the
+ * compare callback, so they can be times, addresses or anything else
+ * ordered. An interval may be added more than once.
+ *
+ * @defgroup lc_interval_tree Interval Tree
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "alloc.h"
+#include "rbtree.h"
+
+typedef int     (*lc_interval_tree_compare_fxn_t) ( const void *p_left, const void *p_right );
+typedef bool    (*lc_interval_tree_element_fxn_t) ( void *p_low, void *p_high, void *p_value );
+/* Called for each overlapping interval; return false to stop early. */
+typedef bool    (*lc_interval_tree_visit_fxn_t)   ( void *p_low, void *p_high, void *p_value, void *user_data );
+
+/**
+ * lc_interval_tree_t is an interval tree collection object.
+ */
+typedef struct lc_interval_tree {
+	lc_rbtree_t tree;
+	lc_interval_tree_compare_fxn_t compare;
+	lc_interval_tree_element_fxn_t destroy;
+} lc_interval_tree_t;
+
+void   lc_interval_tree_create  ( lc_interval_tree_t* p_tree, lc_interval_tree_element_fxn_t destroy, lc_interval_tree_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create an interval tree whose memory comes from an allocator. If
+ * allocator is NULL, malloc() and free() are used.
+ */
+void   lc_interval_tree_create_with_allocator ( lc_interval_tree_t* p_tree, lc_interval_tree_element_fxn_t destroy, lc_interval_tree_compare_fxn_t compare, const lc_allocator_t* allocator );
+void   lc_interval_tree_destroy ( lc_interval_tree_t* p_tree );
+/**
+ * Add the interval [low, high] with a value. low must not be greater
+ * than high. Returns false if memory could not be allocated.
+ */
+bool   lc_interval_tree_insert  ( lc_interval_tree_t* p_tree, const void *low, const void *high, const void *value );
+/**
+ * Remove one interval with these endpoints and this value.
+ */
+bool   lc_interval_tree_remove  ( lc_interval_tree_t* p_tree, const void *low, const void *high, const void *value );
+void   lc_interval_tree_clear   ( lc_interval_tree_t* p_tree );
+/**
+ * Visit, ordered by low endpoint, every interval that overlaps
+ * [low, high]: each one with a low endpoint not greater than high and a
+ * high endpoint not less than low. Only subtrees that hold a match or lie
+ * on the search path are entered, which is O(log n) when nothing
+ * overlaps and at most O(log n) more for each of the k matches. Returns
+ * the number of intervals visited.
+ */
+size_t lc_interval_tree_overlaps ( const lc_interval_tree_t* p_tree, const void *low, const void *high, lc_interval_tree_visit_fxn_t visit, void *user_data );
+
+#define lc_interval_tree_size( p_tree )          (lc_rbtree_size( &(p_tree)->tree ))
+#define lc_interval_tree_is_empty( p_tree )      (lc_rbtree_is_empty( &(p_tree)->tree ))
+/** Visit the intervals that contain point. */
+#define lc_interval_tree_stab( p_tree, point, visit, user_data ) \
+	lc_interval_tree_overlaps( p_tree, point, point, visit, user_data )
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_INTERVAL_TREE_H_ */
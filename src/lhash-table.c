@@ -20,104 +20,309 @@
  * THE SOFTWARE.
  */
 #include <stdio.h>
-#include <math.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include "lhash-table.h"
 
-static bool lc_lhash_table_find_bucket_for_insertion( lc_lhash_table_t* p_table, const void *data, size_t *p_index );
+static bool lc_lhash_table_find_bucket_for_insertion( lc_lhash_table_t* p_table, size_t hash, size_t *p_index );
 static bool lc_lhash_table_find_bucket( lc_lhash_table_t* p_table, const void *data, size_t *p_index );
+static bool lh_resize( lc_lhash_table_t* p_table, size_t new_size, bool robin_hood );
 
 
-#define bucket_is_occupied( p_table, bucket )    lc_bitset_test( &(p_table)->occupied, bucket )
-#define bucket_mark_occupied( p_table, bucket )  lc_bitset_set( &(p_table)->occupied, bucket )
-#define bucket_mark_empty( p_table, bucket )     lc_bitset_unset( &(p_table)->occupied, bucket )
+#if defined(__GNUC__) || defined(__clang__)
+#define lh_prefetch( addr )       __builtin_prefetch( (addr), 0, 3 )
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define lh_prefetch( addr )       _mm_prefetch( (const char*) (addr), _MM_HINT_T0 )
+#else
+#define lh_prefetch( addr )
+#endif
 
+/*
+ * Each bucket has a control byte: LH_EMPTY, LH_DELETED or, when the
+ * bucket is occupied, the low 7 bits of the element's hash (h2). Most
+ * buckets that don't match are rejected on the control byte alone,
+ * without calling the compare callback or touching the element.
+ */
+#define LH_EMPTY       ((int8_t) -128)
+#define LH_DELETED     ((int8_t) -2)
 
-#define bucket_is_deleted( p_table, bucket )     lc_bitset_test( &(p_table)->deleted, bucket )
-#define bucket_mark_deleted( p_table, bucket )   lc_bitset_set( &(p_table)->deleted, bucket )
-#define bucket_mark_available( p_table, bucket ) lc_bitset_unset( &(p_table)->deleted, bucket )
+#define lh_h1( hash )                ((hash) >> 7)
+#define lh_h2( hash )                ((int8_t) ((hash) & 0x7F))
+#define lh_mask( p_table )           (lc_array_size( &(p_table)->table ) - 1)
+#define lh_home( p_table, hash )     (lh_h1( hash ) & lh_mask( p_table ))
 
-bool lc_lhash_table_create  ( lc_lhash_table_t* p_table, size_t element_size, size_t table_size,
-                           lc_lhash_table_hash_fxn_t hash_function,
-                           lc_lhash_table_compare_fxn_t compare_function,
-                           lc_alloc_fxn_t alloc,
-                           lc_free_fxn_t free )
+#define bucket_is_occupied( p_table, bucket )    ((p_table)->ctrl[ bucket ] >= 0)
+#define bucket_is_deleted( p_table, bucket )     ((p_table)->ctrl[ bucket ] == LH_DELETED)
+#define bucket_is_empty( p_table, bucket )       ((p_table)->ctrl[ bucket ] == LH_EMPTY)
+#define bucket_matches( p_table, bucket, h2 )    ((p_table)->ctrl[ bucket ] == (h2))
+#define bucket_mark_occupied( p_table, bucket, hash ) ((p_table)->ctrl[ bucket ] = lh_h2( hash ))
+#define bucket_mark_deleted( p_table, bucket )   ((p_table)->ctrl[ bucket ] = LH_DELETED)
+#define bucket_mark_empty( p_table, bucket )     ((p_table)->ctrl[ bucket ] = LH_EMPTY)
+
+
+#define lh_alloc( p_table, size )  lc_allocator_alloc( &(p_table)->allocator, (p_table)->alloc, size )
+#define lh_free( p_table, ptr )    lc_allocator_free( &(p_table)->allocator, (p_table)->free, ptr )
+
+/* The table size is a power of two so probing is a mask, not a division. */
+#define lh_next( p_table, index )  (((index) + LC_LHASH_TABLE_LINEAR_CONSTANT) & lh_mask( p_table ))
+#define lh_prev( p_table, index )  (((index) - LC_LHASH_TABLE_LINEAR_CONSTANT) & lh_mask( p_table ))
+
+/*
+ * The user supplied hash functions are often weak in their lower bits
+ * so the result is mixed before it is split into h1 and h2.
+ */
+static inline size_t lh_hash( const lc_lhash_table_t* p_table, const void *data )
+{
+	uint64_t h = (uint64_t) p_table->hash_callback( data );
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return (size_t) h;
+}
+
+static inline size_t lh_table_size_for( size_t table_size )
+{
+	size_t size = 1;
+
+	while( size < table_size )
+	{
+		size <<= 1;
+	}
+
+	return size;
+}
+
+static bool lh_create( lc_lhash_table_t* p_table, size_t element_size, size_t table_size,
+                       lc_lhash_table_hash_fxn_t hash_function,
+                       lc_lhash_table_compare_fxn_t compare_function,
+                       lc_alloc_fxn_t alloc,
+                       lc_free_fxn_t free,
+                       const lc_allocator_t* allocator )
 {
+	bool result;
+
 	assert( p_table );
 
-	if( lc_bitset_create( &p_table->occupied, table_size ) &&
-	    lc_bitset_create( &p_table->deleted, table_size ) )
+	p_table->size             = 0;
+	p_table->deleted          = 0;
+	p_table->max_load         = 0.0;
+	p_table->max_deleted      = 0.0;
+	p_table->distances        = NULL;
+	p_table->hash_callback    = hash_function;
+	p_table->compare_callback = compare_function;
+	p_table->alloc            = alloc;
+	p_table->free             = free;
+	lc_allocator_init( &p_table->allocator, allocator );
+
+	table_size = lh_table_size_for( table_size );
+
+	if( lc_allocator_is_set(&p_table->allocator) )
+	{
+		result = lc_array_create_with_allocator( &p_table->table, element_size, table_size, &p_table->allocator );
+	}
+	else
+	{
+		result = lc_array_create( &p_table->table, element_size, table_size, alloc, free );
+	}
+
+	if( result )
 	{
-		p_table->size             = 0;
-		p_table->hash_callback    = hash_function;
-		p_table->compare_callback = compare_function;
+		p_table->ctrl = lh_alloc( p_table, table_size );
 
-		return lc_array_create( &p_table->table, element_size, table_size, alloc, free );
+		if( p_table->ctrl )
+		{
+			memset( p_table->ctrl, LH_EMPTY, table_size );
+			return true;
+		}
+
+		lc_array_destroy( &p_table->table );
 	}
 
 	return false;
 }
 
+bool lc_lhash_table_create  ( lc_lhash_table_t* p_table, size_t element_size, size_t table_size,
+                           lc_lhash_table_hash_fxn_t hash_function,
+                           lc_lhash_table_compare_fxn_t compare_function,
+                           lc_alloc_fxn_t alloc,
+                           lc_free_fxn_t free )
+{
+	return lh_create( p_table, element_size, table_size, hash_function, compare_function, alloc, free, NULL );
+}
+
+bool lc_lhash_table_create_with_allocator ( lc_lhash_table_t* p_table, size_t element_size, size_t table_size,
+                           lc_lhash_table_hash_fxn_t hash_function,
+                           lc_lhash_table_compare_fxn_t compare_function,
+                           const lc_allocator_t* allocator )
+{
+	return lh_create( p_table, element_size, table_size, hash_function, compare_function, malloc, free, allocator );
+}
+
 void lc_lhash_table_destroy( lc_lhash_table_t* p_table )
 {
 	assert( p_table );
 	lc_array_destroy( &p_table->table );
-	lc_bitset_destroy( &p_table->occupied );
-	lc_bitset_destroy( &p_table->deleted );
+	lh_free( p_table, p_table->ctrl );
+	p_table->ctrl = NULL;
+
+	if( p_table->distances )
+	{
+		lh_free( p_table, p_table->distances );
+		p_table->distances = NULL;
+	}
 }
 
-bool lc_lhash_table_find_bucket_for_insertion( lc_lhash_table_t* p_table, const void *data, size_t *p_index )
+bool lc_lhash_table_find_bucket_for_insertion( lc_lhash_table_t* p_table, size_t hash, size_t *p_index )
 {
 	bool result  = false;
-	size_t hash     = p_table->hash_callback( data );
 	size_t count;
 
-	*p_index  = hash % lc_array_size( &p_table->table );
+	*p_index  = lh_home( p_table, hash );
 
 	for( count = 0; count < lc_array_size(&p_table->table) && !result; count++ )
 	{
-		if( bucket_is_deleted( p_table, *p_index ) || !bucket_is_occupied( p_table, *p_index ) )
+		if( !bucket_is_occupied( p_table, *p_index ) )
 		{
-			bucket_mark_available( p_table, *p_index );
 			result = true;
 		}
 		else
 		{
-			*p_index  = (*p_index + LC_LHASH_TABLE_LINEAR_CONSTANT) % lc_array_size( &p_table->table );
+			*p_index  = lh_next( p_table, *p_index );
 		}
 	}
 
 	return result;
 }
 
-bool lc_lhash_table_find_bucket( lc_lhash_table_t* p_table, const void *data, size_t *p_index )
+/*
+ * Robin Hood buckets are kept in order of their home bucket, so once a
+ * bucket is closer to home than the key would be, the key isn't there.
+ */
+static bool lh_rh_find_bucket( lc_lhash_table_t* p_table, const void *data, size_t hash, size_t *p_index )
+{
+	int8_t h2       = lh_h2( hash );
+	size_t distance = 0;
+
+	*p_index = lh_home( p_table, hash );
+
+	while( bucket_is_occupied( p_table, *p_index ) && p_table->distances[ *p_index ] >= distance )
+	{
+		if( bucket_matches( p_table, *p_index, h2 ) &&
+		    p_table->compare_callback( lc_array_element( &p_table->table, *p_index ), data ) == 0 )
+		{
+			return true;
+		}
+
+		if( ++distance >= lc_array_size( &p_table->table ) )
+		{
+			break;
+		}
+
+		*p_index = lh_next( p_table, *p_index );
+	}
+
+	return false;
+}
+
+static bool lh_rh_insert( lc_lhash_table_t* p_table, const void *data, size_t hash )
+{
+	size_t index    = lh_home( p_table, hash );
+	size_t distance = 0;
+	size_t empty;
+
+	/* Take the first bucket that is empty or closer to home than we are. */
+	while( bucket_is_occupied( p_table, index ) && p_table->distances[ index ] >= distance )
+	{
+		if( ++distance >= lc_array_size( &p_table->table ) )
+		{
+			return false;
+		}
+
+		index = lh_next( p_table, index );
+	}
+
+	/* Every element from there to the next empty bucket moves down one. */
+	for( empty = index; bucket_is_occupied( p_table, empty ); )
+	{
+		empty = lh_next( p_table, empty );
+
+		if( empty == index )
+		{
+			return false;
+		}
+	}
+
+	while( empty != index )
+	{
+		size_t previous = lh_prev( p_table, empty );
+
+		memcpy( lc_array_element( &p_table->table, empty ), lc_array_element( &p_table->table, previous ), lc_array_element_size(&p_table->table) );
+		p_table->ctrl[ empty ]      = p_table->ctrl[ previous ];
+		p_table->distances[ empty ] = p_table->distances[ previous ] + 1;
+		empty = previous;
+	}
+
+	memcpy( lc_array_element( &p_table->table, index ), data, lc_array_element_size(&p_table->table) );
+	bucket_mark_occupied( p_table, index, hash );
+	p_table->distances[ index ] = distance;
+	p_table->size++;
+
+	return true;
+}
+
+/* Backward shift deletion; no deleted markers are left behind. */
+static void lh_rh_remove( lc_lhash_table_t* p_table, size_t index )
+{
+	size_t next = lh_next( p_table, index );
+
+	while( bucket_is_occupied( p_table, next ) && p_table->distances[ next ] > 0 )
+	{
+		memcpy( lc_array_element( &p_table->table, index ), lc_array_element( &p_table->table, next ), lc_array_element_size(&p_table->table) );
+		p_table->ctrl[ index ]      = p_table->ctrl[ next ];
+		p_table->distances[ index ] = p_table->distances[ next ] - 1;
+		index = next;
+		next  = lh_next( p_table, next );
+	}
+
+	bucket_mark_empty( p_table, index );
+	p_table->size--;
+}
+
+static bool lh_find_bucket( lc_lhash_table_t* p_table, const void *data, size_t hash, size_t *p_index )
 {
 	bool result        = false;
-	size_t hash           = p_table->hash_callback( data );
 	bool found_deleted = false;
+	int8_t h2          = lh_h2( hash );
 	size_t deleted;
 	size_t count;
 
+	if( lc_lhash_table_is_robin_hood(p_table) )
+	{
+		return lh_rh_find_bucket( p_table, data, hash, p_index );
+	}
 
-	*p_index  = hash % lc_array_size( &p_table->table );
+	*p_index  = lh_home( p_table, hash );
 	deleted   = *p_index;
 
 	for( count = 0; count < lc_array_size(&p_table->table) && !result; count++ )
 	{
 		if( bucket_is_deleted( p_table, *p_index ) )
 		{
-			/* Save the deleted index so that if we find an occupied matching element
- 			 * we can move them into the deleted bucket and mark the original bucket
- 			 * as
- 			 */
-			deleted = *p_index;
-			*p_index  = (*p_index + LC_LHASH_TABLE_LINEAR_CONSTANT) % lc_array_size( &p_table->table );
-			found_deleted = true;
+			/* Save the first deleted index so that if we find a matching
+			 * element we can move it into the deleted bucket.
+			 */
+			if( !found_deleted )
+			{
+				deleted = *p_index;
+				found_deleted = true;
+			}
+			*p_index  = lh_next( p_table, *p_index );
 			continue;
 		}
 		else
-		if( bucket_is_occupied(p_table, *p_index) && p_table->compare_callback( lc_array_element( &p_table->table, *p_index ), data ) == 0 )
+		if( bucket_matches( p_table, *p_index, h2 ) && p_table->compare_callback( lc_array_element( &p_table->table, *p_index ), data ) == 0 )
 		{
 			/* We found an item */
 
@@ -125,43 +330,65 @@ bool lc_lhash_table_find_bucket( lc_lhash_table_t* p_table, const void *data, si
 			{
 				memmove( lc_array_element(&p_table->table, deleted), lc_array_element(&p_table->table, *p_index), lc_array_element_size(&p_table->table) );
 
-				assert( !bucket_is_deleted( p_table, *p_index ) );
+				p_table->ctrl[ deleted ] = h2;
 				bucket_mark_deleted( p_table, *p_index );
-				bucket_mark_available( p_table, deleted );
-				bucket_mark_occupied( p_table, deleted );
 
 				*p_index = deleted;
 			}
 
 			result = true;
 		}
-		else if( !bucket_is_occupied( p_table, *p_index ) )
+		else if( bucket_is_empty( p_table, *p_index ) )
 		{
 			/* We didn't find an item but we did
  			 * find an empty bucket.
  			 */
-			result = false;
+			break;
 		}
 		else
 		{
-			*p_index  = (*p_index + LC_LHASH_TABLE_LINEAR_CONSTANT) % lc_array_size( &p_table->table );
+			*p_index  = lh_next( p_table, *p_index );
 		}
 	}
 
 	return result;
 }
 
+bool lc_lhash_table_find_bucket( lc_lhash_table_t* p_table, const void *data, size_t *p_index )
+{
+	return lh_find_bucket( p_table, data, lh_hash( p_table, data ), p_index );
+}
+
 bool lc_lhash_table_insert( lc_lhash_table_t* p_table, const void *data )
 {
+	size_t hash;
 	size_t index;
 	bool result = false;
 
 	assert( p_table );
 
-	if( lc_lhash_table_find_bucket_for_insertion( p_table, data, &index ) )
+	if( p_table->max_load > 0.0 && p_table->size + 1 > p_table->max_load * lc_array_size(&p_table->table) )
+	{
+		/* If this fails the insert may still find a free bucket. */
+		lh_resize( p_table, 2 * lc_array_size(&p_table->table), lc_lhash_table_is_robin_hood(p_table) );
+	}
+
+	hash = lh_hash( p_table, data );
+
+	if( lc_lhash_table_is_robin_hood(p_table) )
+	{
+		return lh_rh_insert( p_table, data, hash );
+	}
+
+	if( lc_lhash_table_find_bucket_for_insertion( p_table, hash, &index ) )
 	{
+		if( bucket_is_deleted( p_table, index ) )
+		{
+			p_table->deleted--;
+		}
+
 		memcpy( lc_array_element( &p_table->table, index ), data, lc_array_element_size(&p_table->table) );
-		bucket_mark_occupied( p_table, index );
+		bucket_mark_occupied( p_table, index, hash );
 
 		p_table->size++;
 
@@ -180,11 +407,21 @@ bool lc_lhash_table_remove( lc_lhash_table_t* p_table, const void *data )
 
 	if( lc_lhash_table_find_bucket( p_table, data, &index ) )
 	{
-		/* Mark the bucket as unoccupied and deleted */
-		/*bucket_mark_empty( p_table, index ); // not sure if needed*/
+		if( lc_lhash_table_is_robin_hood(p_table) )
+		{
+			lh_rh_remove( p_table, index );
+			return true;
+		}
+
 		bucket_mark_deleted( p_table, index );
 		p_table->size--;
+		p_table->deleted++;
 		result = true;
+
+		if( p_table->max_deleted > 0.0 && p_table->deleted > p_table->max_deleted * lc_array_size(&p_table->table) )
+		{
+			lh_resize( p_table, lc_array_size(&p_table->table), false );
+		}
 	}
 
 	return result;
@@ -200,55 +437,148 @@ bool lc_lhash_table_find( lc_lhash_table_t* p_table, const void *data, void **fo
 
 	if( lc_lhash_table_find_bucket( p_table, data, &index ) )
 	{
-		if( bucket_is_occupied( p_table, index ) )
+		*found_data = lc_array_element( &p_table->table, index );
+		return true;
+	}
+
+	return false;
+}
+
+size_t lc_lhash_table_find_many( lc_lhash_table_t* p_table, const void* const* data, size_t count, void** found_data )
+{
+	size_t hashes[ LC_LHASH_TABLE_FIND_BATCH ];
+	size_t found = 0;
+	size_t start;
+
+	assert( p_table );
+	assert( data || count == 0 );
+	assert( found_data || count == 0 );
+
+	for( start = 0; start < count; start += LC_LHASH_TABLE_FIND_BATCH )
+	{
+		size_t n = count - start < LC_LHASH_TABLE_FIND_BATCH ? count - start : LC_LHASH_TABLE_FIND_BATCH;
+		size_t i;
+
+		/* Hash the whole batch and prefetch the first probe of each */
+		for( i = 0; i < n; i++ )
 		{
-			*found_data = lc_array_element( &p_table->table, index );
-			return true;
+			size_t index;
+
+			hashes[ i ] = lh_hash( p_table, data[ start + i ] );
+			index       = lh_home( p_table, hashes[ i ] );
+
+			lh_prefetch( &p_table->ctrl[ index ] );
+			lh_prefetch( lc_array_element( &p_table->table, index ) );
+
+			if( p_table->distances )
+			{
+				lh_prefetch( &p_table->distances[ index ] );
+			}
+		}
+
+		for( i = 0; i < n; i++ )
+		{
+			size_t index;
+
+			found_data[ start + i ] = NULL;
+
+			if( lh_find_bucket( p_table, data[ start + i ], hashes[ i ], &index ) )
+			{
+				found_data[ start + i ] = lc_array_element( &p_table->table, index );
+				found++;
+			}
 		}
 	}
 
-	return false;
+	return found;
 }
 
 void lc_lhash_table_clear( lc_lhash_table_t* p_table )
 {
-	lc_bitset_clear( &p_table->occupied );
-	lc_bitset_clear( &p_table->deleted );
+	memset( p_table->ctrl, LH_EMPTY, lc_array_size(&p_table->table) );
+	p_table->size    = 0;
+	p_table->deleted = 0;
 }
 
-bool lc_lhash_table_resize( lc_lhash_table_t* p_table, size_t new_size )
+void lc_lhash_table_auto_resize_set( lc_lhash_table_t* p_table, double max_load, double max_deleted )
 {
 	assert( p_table );
+	assert( max_load >= 0.0 && max_load < 1.0 );
+	assert( max_deleted >= 0.0 && max_deleted < 1.0 );
+
+	p_table->max_load    = max_load;
+	p_table->max_deleted = max_deleted;
+}
+
+static bool lh_resize( lc_lhash_table_t* p_table, size_t new_size, bool robin_hood )
+{
+	lc_lhash_table_t new_table;
 
-	if( new_size != lc_lhash_table_size(p_table) )
+	if( lh_create( &new_table, lc_array_element_size(&p_table->table), new_size, p_table->hash_callback, p_table->compare_callback, p_table->alloc, p_table->free, lc_allocator_is_set(&p_table->allocator) ? &p_table->allocator : NULL ) )
 	{
-		lc_lhash_table_t new_table;
+		size_t i;
 
-		if( lc_lhash_table_create( &new_table, lc_array_element_size(&p_table->table), new_size, p_table->hash_callback, p_table->compare_callback, p_table->alloc, p_table->free ) )
+		if( robin_hood )
 		{
-			size_t i;
+			new_table.distances = lh_alloc( &new_table, sizeof(size_t) * lc_array_size(&new_table.table) );
 
-			for( i = 0; i < lc_array_size(&p_table->table); i++ )
+			if( !new_table.distances )
 			{
-				if( bucket_is_deleted( p_table, i ) )
-				{
-					continue;
-				}
-				else if( bucket_is_occupied( p_table, i ) )
-				{
-					lc_lhash_table_insert( &new_table, lc_array_element( &p_table->table, i ) );
-				}
+				lc_lhash_table_destroy( &new_table );
+				return false;
 			}
+		}
 
-			lc_lhash_table_destroy( p_table );
-			*p_table = new_table;
-
-			return true;
+		for( i = 0; i < lc_array_size(&p_table->table); i++ )
+		{
+			if( bucket_is_occupied( p_table, i ) )
+			{
+				lc_lhash_table_insert( &new_table, lc_array_element( &p_table->table, i ) );
+			}
 		}
+
+		new_table.max_load    = p_table->max_load;
+		new_table.max_deleted = p_table->max_deleted;
+
+		lc_lhash_table_destroy( p_table );
+		*p_table = new_table;
+
+		return true;
 	}
 
 	return false;
 }
+bool lc_lhash_table_resize( lc_lhash_table_t* p_table, size_t new_size )
+{
+	assert( p_table );
+
+	if( new_size < lc_lhash_table_size(p_table) )
+	{
+		return false;
+	}
+
+	return lh_resize( p_table, new_size, lc_lhash_table_is_robin_hood(p_table) );
+}
+
+bool lc_lhash_table_robin_hood_set( lc_lhash_table_t* p_table, bool enable )
+{
+	assert( p_table );
+
+	if( enable == lc_lhash_table_is_robin_hood(p_table) )
+	{
+		return true;
+	}
+
+	if( !enable )
+	{
+		/* A Robin Hood layout is already a valid linear probing layout. */
+		lh_free( p_table, p_table->distances );
+		p_table->distances = NULL;
+		return true;
+	}
+
+	return lh_resize( p_table, lc_array_size(&p_table->table), true );
+}
 
 bool lc_lhash_table_rehash( lc_lhash_table_t* p_table, double load_factor )
 {
@@ -26,35 +26,45 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include "array.h"
-#include "bitset.h"
 #include "alloc.h"
 
 /*
  *    Open Addressing Hash Table
+ *
+ *    Every bucket has a control byte holding its state and 7 bits of
+ *    the element's hash. Table sizes are rounded up to a power of two.
  */
 
-/* Each size is a prime number */
+/* Suggested table sizes; powers of two, so none are rounded up. */
 #ifndef LC_LHASH_TABLE_SIZE_SMALL
-#define LC_LHASH_TABLE_SIZE_SMALL         (37)
+#define LC_LHASH_TABLE_SIZE_SMALL         (32)
 #endif
 #ifndef LC_LHASH_TABLE_SIZE_MEDIUM
-#define LC_LHASH_TABLE_SIZE_MEDIUM        (1031)
+#define LC_LHASH_TABLE_SIZE_MEDIUM        (1024)
 #endif
 #ifndef LC_LHASH_TABLE_SIZE_LARGE
-#define LC_LHASH_TABLE_SIZE_LARGE         (5153)
+#define LC_LHASH_TABLE_SIZE_LARGE         (4096)
 #endif
 #ifndef LC_LHASH_TABLE_SIZE_EXTRA_LARGE
-#define LC_LHASH_TABLE_SIZE_EXTRA_LARGE   (7919)
+#define LC_LHASH_TABLE_SIZE_EXTRA_LARGE   (8192)
 #endif
 
 #ifndef LC_LHASH_TABLE_LOAD_FACTOR
 #define LC_LHASH_TABLE_LOAD_FACTOR        (0.7)
 #endif
+#ifndef LC_LHASH_TABLE_MAX_DELETED
+#define LC_LHASH_TABLE_MAX_DELETED        (0.2)
+#endif
 #ifndef LC_LHASH_TABLE_THRESHOLD
 #define LC_LHASH_TABLE_THRESHOLD          (0.1)
 #endif
+#ifndef LC_LHASH_TABLE_FIND_BATCH
+#define LC_LHASH_TABLE_FIND_BATCH         (16)
+#endif
+/* Must be odd so that probing visits every bucket. */
 #ifndef LC_LHASH_TABLE_LINEAR_CONSTANT
 #define LC_LHASH_TABLE_LINEAR_CONSTANT    (1)
 #endif
@@ -66,11 +76,15 @@ typedef int     (*lc_lhash_table_compare_fxn_t) ( const void *left, const void *
 typedef struct lc_lhash_table {
 	lc_alloc_fxn_t  alloc;
 	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
 
 	lc_array_t  table;
-	lc_bitset_t occupied;
-	lc_bitset_t deleted;
+	int8_t*  ctrl;      /* Control byte of each bucket */
 	size_t   size;
+	size_t   deleted;   /* Buckets marked deleted */
+	double   max_load;
+	double   max_deleted;
+	size_t*  distances; /* Probe distance of each bucket in Robin Hood mode */
 
 	lc_lhash_table_hash_fxn_t    hash_callback;
 	lc_lhash_table_compare_fxn_t compare_callback;
@@ -81,17 +95,53 @@ bool      lc_lhash_table_create  ( lc_lhash_table_t* p_table, size_t element_siz
                                 lc_lhash_table_compare_fxn_t compare_function,
 								lc_alloc_fxn_t alloc,
 								lc_free_fxn_t free );
+bool      lc_lhash_table_create_with_allocator ( lc_lhash_table_t* p_table, size_t element_size, size_t table_size,
+                                lc_lhash_table_hash_fxn_t hash_function,
+                                lc_lhash_table_compare_fxn_t compare_function,
+                                const lc_allocator_t* allocator );
 void      lc_lhash_table_destroy ( lc_lhash_table_t* p_table );
 bool      lc_lhash_table_insert  ( lc_lhash_table_t* p_table, const void *data );
 bool      lc_lhash_table_remove  ( lc_lhash_table_t* p_table, const void *data );
 bool      lc_lhash_table_find    ( lc_lhash_table_t* p_table, const void *data, void **found_data );
+/*
+ * Look up count elements at once; found_data[i] receives the element
+ * matching data[i] or NULL. The whole batch is hashed and the first probe
+ * of each lookup prefetched before any probing starts. Returns the number
+ * of elements found.
+ */
+size_t    lc_lhash_table_find_many ( lc_lhash_table_t* p_table, const void* const* data, size_t count, void** found_data );
 void      lc_lhash_table_clear   ( lc_lhash_table_t* p_table );
+/*
+ * Switch Robin Hood mode on or off. In Robin Hood mode each bucket stores
+ * its distance from the element's home bucket. An insert takes the bucket
+ * of any element closer to home than itself, a lookup stops as soon as it
+ * passes an element closer to home than the key would be, and a remove
+ * shifts the elements after it back instead of leaving a deleted marker.
+ * Probe lengths stay short and even under heavy churn. Existing elements
+ * are rehashed into the new layout.
+ */
+bool      lc_lhash_table_robin_hood_set ( lc_lhash_table_t* p_table, bool enable );
+/*
+ * Resize the table to at least new_size buckets (rounded up to a power of
+ * two). Resizing to the current table size rebuilds the table, dropping
+ * any deleted markers. Fails if new_size can't hold every element.
+ */
 bool      lc_lhash_table_resize  ( lc_lhash_table_t* p_table, size_t new_size );
 bool      lc_lhash_table_rehash  ( lc_lhash_table_t* p_table, double load_factor );
+/*
+ * Opt-in automatic resizing. An insert that would push the load factor
+ * past max_load doubles the table first, and once more than max_deleted
+ * of the buckets are marked deleted the table is rebuilt at the same
+ * size. A threshold of 0 turns that behavior off. For example:
+ * lc_lhash_table_auto_resize_set( &table, LC_LHASH_TABLE_LOAD_FACTOR, LC_LHASH_TABLE_MAX_DELETED ).
+ */
+void      lc_lhash_table_auto_resize_set ( lc_lhash_table_t* p_table, double max_load, double max_deleted );
 
 
 #define   lc_lhash_table_size(p_table)         ((p_table)->size)
 #define   lc_lhash_table_table_size(p_table)   ((p_table)->table.size)
+#define   lc_lhash_table_deleted(p_table)      ((p_table)->deleted)
+#define   lc_lhash_table_is_robin_hood(p_table) ((p_table)->distances != NULL)
 #define   lc_lhash_table_load_factor(p_table)  (lc_lhash_table_size(p_table) / ((double) ((p_table)->table.size)))
 
 #ifdef __cplusplus
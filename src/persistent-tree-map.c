@@ -0,0 +1,538 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <assert.h>
+#include "persistent-tree-map.h"
+
+#if defined(LC_PERSISTENT_TREE_MAP_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
+	#define DESTROY_CHECK( code ) \
+		if( p_map->destroy ) \
+		{ \
+			code \
+		}
+#else
+	#define DESTROY_CHECK( code ) \
+		code
+#endif
+
+/*
+ * Snapshots are released on reader threads while the writer copies and
+ * frees nodes, so the reference counts are atomic when C11 atomics are
+ * available. Without them snapshots are single threaded; see
+ * persistent-tree-map.h.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef atomic_size_t ptm_refs_t;
+#define ptm_refs_init( p_refs, n )    atomic_init( p_refs, n )
+#define ptm_refs_load( p_refs )       atomic_load_explicit( p_refs, memory_order_acquire )
+#define ptm_refs_retain( p_refs )     atomic_fetch_add_explicit( p_refs, 1, memory_order_relaxed )
+#define ptm_refs_release( p_refs )    (atomic_fetch_sub_explicit( p_refs, 1, memory_order_acq_rel ) == 1)
+#else
+typedef size_t ptm_refs_t;
+#define ptm_refs_init( p_refs, n )    (*(p_refs) = (n))
+#define ptm_refs_load( p_refs )       (*(p_refs))
+#define ptm_refs_retain( p_refs )     (++*(p_refs))
+#define ptm_refs_release( p_refs )    (--*(p_refs) == 0)
+#endif
+
+#define ptm_alloc( p_map, size )  lc_allocator_alloc( &(p_map)->allocator, (p_map)->alloc, size )
+#define ptm_free( p_map, ptr )    lc_allocator_free( &(p_map)->allocator, (p_map)->free, ptr )
+
+/*
+ * A key and value shared by every copy of the node that holds it; it is
+ * destroyed with the last of them.
+ */
+typedef struct ptm_entry {
+	void*      key;
+	void*      value;
+	ptm_refs_t refs;
+} ptm_entry_t;
+
+struct lc_persistent_tree_map_node {
+	lc_persistent_tree_map_node_t* left;
+	lc_persistent_tree_map_node_t* right;
+	ptm_entry_t* entry;
+	ptm_refs_t   refs;   /* parents and snapshots that point here */
+	int          height;
+};
+
+typedef lc_persistent_tree_map_node_t ptm_node_t;
+
+#define ptm_height( p_node )   ((p_node) ? (p_node)->height : 0)
+#define ptm_key( p_node )      ((p_node)->entry->key)
+
+
+static void ptm_entry_release( const lc_persistent_tree_map_t* p_map, ptm_entry_t* entry )
+{
+	if( ptm_refs_release( &entry->refs ) )
+	{
+		DESTROY_CHECK(
+			p_map->destroy( entry->key, entry->value );
+		);
+
+		ptm_free( p_map, entry );
+	}
+}
+
+static void ptm_node_release( const lc_persistent_tree_map_t* p_map, ptm_node_t* node )
+{
+	while( node && ptm_refs_release( &node->refs ) )
+	{
+		ptm_node_t* right = node->right;
+
+		ptm_node_release( p_map, node->left );
+		ptm_entry_release( p_map, node->entry );
+		ptm_free( p_map, node );
+
+		node = right;
+	}
+}
+
+/*
+ * Return a node that can be changed in place of node, whose reference the
+ * caller owns. Every node above it has already been made private to the
+ * live version, so node is private too unless something else points to
+ * it; then it is copied and the caller's reference moves to the copy.
+ */
+static ptm_node_t* ptm_own( lc_persistent_tree_map_t* p_map, ptm_node_t* node )
+{
+	ptm_node_t* copy;
+
+	if( ptm_refs_load( &node->refs ) == 1 )
+	{
+		return node;
+	}
+
+	copy = (ptm_node_t*) ptm_alloc( p_map, sizeof(ptm_node_t) );
+
+	if( copy )
+	{
+		copy->left   = node->left;
+		copy->right  = node->right;
+		copy->entry  = node->entry;
+		copy->height = node->height;
+		ptm_refs_init( &copy->refs, 1 );
+
+		if( copy->left )  ptm_refs_retain( &copy->left->refs );
+		if( copy->right ) ptm_refs_retain( &copy->right->refs );
+		ptm_refs_retain( &copy->entry->refs );
+
+		ptm_node_release( p_map, node );
+	}
+
+	return copy;
+}
+
+static inline void ptm_update( ptm_node_t* node )
+{
+	int left  = ptm_height( node->left );
+	int right = ptm_height( node->right );
+
+	node->height = (left > right ? left : right) + 1;
+}
+
+/* The rotations only move pointers between private nodes. */
+static inline ptm_node_t* ptm_rotate_right( ptm_node_t* node )
+{
+	ptm_node_t* left = node->left;
+
+	node->left  = left->right;
+	left->right = node;
+	ptm_update( node );
+	ptm_update( left );
+
+	return left;
+}
+
+static inline ptm_node_t* ptm_rotate_left( ptm_node_t* node )
+{
+	ptm_node_t* right = node->right;
+
+	node->right = right->left;
+	right->left = node;
+	ptm_update( node );
+	ptm_update( right );
+
+	return right;
+}
+
+/*
+ * Restore the AVL balance of the private node. The children that rotate
+ * are made private first; if that fails the tree is left a little out of
+ * balance, which is still a correct search tree.
+ */
+static ptm_node_t* ptm_balance( lc_persistent_tree_map_t* p_map, ptm_node_t* node )
+{
+	int balance = ptm_height( node->left ) - ptm_height( node->right );
+
+	if( balance > 1 )
+	{
+		ptm_node_t* left = ptm_own( p_map, node->left );
+		if( !left ) goto done;
+		node->left = left;
+
+		if( ptm_height( left->left ) < ptm_height( left->right ) )
+		{
+			ptm_node_t* grandchild = ptm_own( p_map, left->right );
+			if( !grandchild ) goto done;
+			left->right = grandchild;
+			node->left  = ptm_rotate_left( left );
+		}
+
+		return ptm_rotate_right( node );
+	}
+	else if( balance < -1 )
+	{
+		ptm_node_t* right = ptm_own( p_map, node->right );
+		if( !right ) goto done;
+		node->right = right;
+
+		if( ptm_height( right->right ) < ptm_height( right->left ) )
+		{
+			ptm_node_t* grandchild = ptm_own( p_map, right->left );
+			if( !grandchild ) goto done;
+			right->left = grandchild;
+			node->right = ptm_rotate_right( right );
+		}
+
+		return ptm_rotate_left( node );
+	}
+
+done:
+	ptm_update( node );
+	return node;
+}
+
+static const ptm_node_t* ptm_find( const lc_persistent_tree_map_t* p_map, const ptm_node_t* node, const void *key )
+{
+	while( node )
+	{
+		int c = p_map->compare( key, ptm_key(node) );
+
+		if( c == 0 )
+		{
+			return node;
+		}
+
+		node = c < 0 ? node->left : node->right;
+	}
+
+	return NULL;
+}
+
+static bool ptm_insert( lc_persistent_tree_map_t* p_map, ptm_node_t** p_slot, ptm_entry_t* entry, bool *p_added )
+{
+	ptm_node_t* node = *p_slot;
+	bool result;
+	int c;
+
+	if( !node )
+	{
+		node = (ptm_node_t*) ptm_alloc( p_map, sizeof(ptm_node_t) );
+		if( !node ) return false;
+
+		node->left   = NULL;
+		node->right  = NULL;
+		node->entry  = entry;
+		node->height = 1;
+		ptm_refs_init( &node->refs, 1 );
+
+		*p_slot  = node;
+		*p_added = true;
+		return true;
+	}
+
+	node = ptm_own( p_map, node );
+	if( !node ) return false;
+	*p_slot = node;
+
+	c = p_map->compare( entry->key, ptm_key(node) );
+
+	if( c == 0 )
+	{
+		ptm_entry_release( p_map, node->entry );
+		node->entry = entry;
+		return true;
+	}
+
+	result  = ptm_insert( p_map, c < 0 ? &node->left : &node->right, entry, p_added );
+	*p_slot = ptm_balance( p_map, node );
+
+	return result;
+}
+
+/* Unlink the smallest node under *p_slot and hand back its entry. */
+static bool ptm_remove_min( lc_persistent_tree_map_t* p_map, ptm_node_t** p_slot, ptm_entry_t** p_entry )
+{
+	ptm_node_t* node = ptm_own( p_map, *p_slot );
+	bool result = true;
+
+	if( !node ) return false;
+	*p_slot = node;
+
+	if( node->left )
+	{
+		result  = ptm_remove_min( p_map, &node->left, p_entry );
+		*p_slot = ptm_balance( p_map, node );
+	}
+	else
+	{
+		*p_entry = node->entry;
+		*p_slot  = node->right;
+		ptm_free( p_map, node );
+	}
+
+	return result;
+}
+
+static bool ptm_remove( lc_persistent_tree_map_t* p_map, ptm_node_t** p_slot, const void *key )
+{
+	ptm_node_t* node = ptm_own( p_map, *p_slot );
+	bool result = true;
+	int c;
+
+	if( !node ) return false;
+	*p_slot = node;
+
+	c = p_map->compare( key, ptm_key(node) );
+
+	if( c < 0 )
+	{
+		result = ptm_remove( p_map, &node->left, key );
+	}
+	else if( c > 0 )
+	{
+		result = ptm_remove( p_map, &node->right, key );
+	}
+	else if( !node->left || !node->right )
+	{
+		*p_slot = node->left ? node->left : node->right;
+		ptm_entry_release( p_map, node->entry );
+		ptm_free( p_map, node );
+		return true;
+	}
+	else
+	{
+		ptm_entry_t* successor;
+
+		result = ptm_remove_min( p_map, &node->right, &successor );
+
+		if( result )
+		{
+			ptm_entry_release( p_map, node->entry );
+			node->entry = successor;
+		}
+	}
+
+	*p_slot = ptm_balance( p_map, node );
+	return result;
+}
+
+static size_t ptm_range( const lc_persistent_tree_map_t* p_map, const ptm_node_t* node, const void *low, const void *high,
+                         lc_tree_map_range_fxn_t visit, void *user_data, bool *p_stop )
+{
+	size_t count = 0;
+
+	while( node && !*p_stop )
+	{
+		bool above_low  = !low || p_map->compare( ptm_key(node), low ) >= 0;
+		bool below_high = !high || p_map->compare( ptm_key(node), high ) < 0;
+
+		if( above_low )
+		{
+			count += ptm_range( p_map, node->left, low, high, visit, user_data, p_stop );
+
+			if( *p_stop || !below_high )
+			{
+				break;
+			}
+
+			count++;
+
+			if( !visit( node->entry->key, node->entry->value, user_data ) )
+			{
+				*p_stop = true;
+				break;
+			}
+		}
+
+		node = node->right;
+	}
+
+	return count;
+}
+
+
+void lc_persistent_tree_map_create( lc_persistent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	assert( p_map );
+	#if !defined(LC_PERSISTENT_TREE_MAP_DESTROY_CHECK) && !defined(DESTROY_CHECK_ALL)
+	assert( destroy );
+	#endif
+	assert( compare );
+	assert( alloc );
+	assert( free );
+
+	p_map->root    = NULL;
+	p_map->size    = 0;
+	p_map->compare = compare;
+	p_map->destroy = destroy;
+	p_map->alloc   = alloc;
+	p_map->free    = free;
+	lc_allocator_init( &p_map->allocator, NULL );
+}
+
+void lc_persistent_tree_map_create_with_allocator( lc_persistent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	lc_persistent_tree_map_create( p_map, destroy, compare, malloc, free );
+	lc_allocator_init( &p_map->allocator, allocator );
+}
+
+void lc_persistent_tree_map_destroy( lc_persistent_tree_map_t* p_map )
+{
+	assert( p_map );
+	lc_persistent_tree_map_clear( p_map );
+}
+
+bool lc_persistent_tree_map_insert( lc_persistent_tree_map_t* p_map, const void *key, const void *value )
+{
+	ptm_entry_t* entry;
+	bool added = false;
+
+	assert( p_map );
+
+	entry = (ptm_entry_t*) ptm_alloc( p_map, sizeof(ptm_entry_t) );
+	if( !entry ) return false;
+
+	entry->key   = (void*) key;
+	entry->value = (void*) value;
+	ptm_refs_init( &entry->refs, 1 );
+
+	if( !ptm_insert( p_map, &p_map->root, entry, &added ) )
+	{
+		ptm_free( p_map, entry );
+		return false;
+	}
+
+	if( added )
+	{
+		p_map->size++;
+	}
+
+	return true;
+}
+
+bool lc_persistent_tree_map_remove( lc_persistent_tree_map_t* p_map, const void *key )
+{
+	assert( p_map );
+
+	/* Nothing is copied unless the key is really there. */
+	if( !ptm_find( p_map, p_map->root, key ) )
+	{
+		return false;
+	}
+
+	if( !ptm_remove( p_map, &p_map->root, key ) )
+	{
+		return false;
+	}
+
+	p_map->size--;
+	return true;
+}
+
+bool lc_persistent_tree_map_find( const lc_persistent_tree_map_t* p_map, const void *key, void **value )
+{
+	const ptm_node_t* node;
+
+	assert( p_map );
+	node = ptm_find( p_map, p_map->root, key );
+
+	if( node && value )
+	{
+		*value = node->entry->value;
+	}
+
+	return node != NULL;
+}
+
+void lc_persistent_tree_map_clear( lc_persistent_tree_map_t* p_map )
+{
+	assert( p_map );
+	ptm_node_release( p_map, p_map->root );
+	p_map->root = NULL;
+	p_map->size = 0;
+}
+
+void lc_persistent_tree_map_snapshot( const lc_persistent_tree_map_t* p_map, lc_persistent_tree_map_snapshot_t* p_snapshot )
+{
+	assert( p_map );
+	assert( p_snapshot );
+
+	if( p_map->root )
+	{
+		ptm_refs_retain( &p_map->root->refs );
+	}
+
+	p_snapshot->map  = p_map;
+	p_snapshot->root = p_map->root;
+	p_snapshot->size = p_map->size;
+}
+
+void lc_persistent_tree_map_snapshot_release( lc_persistent_tree_map_snapshot_t* p_snapshot )
+{
+	assert( p_snapshot );
+
+	if( p_snapshot->map )
+	{
+		ptm_node_release( p_snapshot->map, p_snapshot->root );
+	}
+
+	p_snapshot->root = NULL;
+	p_snapshot->size = 0;
+}
+
+bool lc_persistent_tree_map_snapshot_find( const lc_persistent_tree_map_snapshot_t* p_snapshot, const void *key, void **value )
+{
+	const ptm_node_t* node;
+
+	assert( p_snapshot );
+	node = ptm_find( p_snapshot->map, p_snapshot->root, key );
+
+	if( node && value )
+	{
+		*value = node->entry->value;
+	}
+
+	return node != NULL;
+}
+
+size_t lc_persistent_tree_map_snapshot_range( const lc_persistent_tree_map_snapshot_t* p_snapshot, const void *low, const void *high, lc_tree_map_range_fxn_t visit, void *user_data )
+{
+	bool stop = false;
+
+	assert( p_snapshot );
+	assert( visit );
+
+	return ptm_range( p_snapshot->map, p_snapshot->root, low, high, visit, user_data, &stop );
+}
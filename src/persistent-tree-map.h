@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_PERSISTENT_TREE_MAP_H_
+#define _LC_PERSISTENT_TREE_MAP_H_
+/**
+ * @file persistent-tree-map.h
+ * @brief An ordered map with O(1) copy-on-write snapshots.
+ *
+ * The map is an AVL tree without parent pointers whose nodes are
+ * reference counted. A snapshot takes a reference to the root and so
+ * shares every node with the live map. When the writer changes the map
+ * it copies only the nodes on the path to the change that a snapshot
+ * still references; the rest is modified in place. The nodes and
+ * entries of a version are reclaimed when the last reference to them is
+ * released.
+ *
+ * One thread writes the map and takes snapshots. Any number of threads
+ * may read and release snapshots without locks. Releasing the last
+ * reference to a node frees it, so the allocator and the destroy
+ * callback are called from reader threads while the writer also calls
+ * them; both must be thread safe. The callbacks are the same ones used
+ * by lc_tree_map_t. Keys are unique.
+ *
+ * The reference counts are atomic only when the library is built with
+ * C11 atomics (HAVE_C11_ATOMICS in libcollections-config.h). Otherwise
+ * snapshots are single threaded: they must be read and released on the
+ * writer's thread.
+ *
+ * @defgroup lc_persistent_tree_map Persistent Tree Map
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "alloc.h"
+#include "tree-map.h"
+
+struct lc_persistent_tree_map_node;
+typedef struct lc_persistent_tree_map_node lc_persistent_tree_map_node_t;
+
+/**
+ * lc_persistent_tree_map_t is the live, writable version of the map.
+ */
+typedef struct lc_persistent_tree_map {
+	lc_persistent_tree_map_node_t* root;
+	size_t size;
+	lc_tree_map_compare_fxn_t compare;
+	lc_tree_map_element_fxn_t destroy;
+
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
+} lc_persistent_tree_map_t;
+
+/**
+ * An immutable version of a map. It must be released before the map it
+ * was taken from is destroyed.
+ */
+typedef struct lc_persistent_tree_map_snapshot {
+	const lc_persistent_tree_map_t* map;
+	lc_persistent_tree_map_node_t* root;
+	size_t size;
+} lc_persistent_tree_map_snapshot_t;
+
+void   lc_persistent_tree_map_create  ( lc_persistent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create a map whose nodes come from an allocator. If allocator is NULL,
+ * malloc() and free() are used.
+ */
+void   lc_persistent_tree_map_create_with_allocator ( lc_persistent_tree_map_t* p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, const lc_allocator_t* allocator );
+/**
+ * Release the live version. Entries still in a snapshot are destroyed
+ * when that snapshot is released.
+ */
+void   lc_persistent_tree_map_destroy ( lc_persistent_tree_map_t* p_map );
+/**
+ * Insert a key and value, replacing the entry with an equal key. The
+ * replaced entry is destroyed once no snapshot holds it. Returns false if
+ * memory could not be allocated.
+ */
+bool   lc_persistent_tree_map_insert  ( lc_persistent_tree_map_t* p_map, const void *key, const void *value );
+/**
+ * Remove a key (and its value) from the live version.
+ */
+bool   lc_persistent_tree_map_remove  ( lc_persistent_tree_map_t* p_map, const void *key );
+bool   lc_persistent_tree_map_find    ( const lc_persistent_tree_map_t* p_map, const void *key, void **value );
+void   lc_persistent_tree_map_clear   ( lc_persistent_tree_map_t* p_map );
+
+/**
+ * Take an immutable version of the map in O(1).
+ */
+void   lc_persistent_tree_map_snapshot ( const lc_persistent_tree_map_t* p_map, lc_persistent_tree_map_snapshot_t* p_snapshot );
+/**
+ * Drop a snapshot. Nodes and entries only it referenced are reclaimed.
+ */
+void   lc_persistent_tree_map_snapshot_release ( lc_persistent_tree_map_snapshot_t* p_snapshot );
+bool   lc_persistent_tree_map_snapshot_find    ( const lc_persistent_tree_map_snapshot_t* p_snapshot, const void *key, void **value );
+/**
+ * Visit the entries with low <= key < high in order, in O(log n + k). A
+ * NULL low or high leaves that end of the range open. Returns the number
+ * of entries visited.
+ */
+size_t lc_persistent_tree_map_snapshot_range   ( const lc_persistent_tree_map_snapshot_t* p_snapshot, const void *low, const void *high, lc_tree_map_range_fxn_t visit, void *user_data );
+
+#define lc_persistent_tree_map_size( p_map )                  ((p_map)->size)
+#define lc_persistent_tree_map_is_empty( p_map )              ((p_map)->size <= 0)
+#define lc_persistent_tree_map_snapshot_size( p_snapshot )    ((p_snapshot)->size)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_PERSISTENT_TREE_MAP_H_ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2010-2022 by Joseph A. Marrero.  https://joemarrero.com/
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -19,9 +19,28 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#ifndef _LC_POOL_H_
+#define _LC_POOL_H_
+/**
+ * @file pool.h
+ * @brief Object pools for a specific data type.
+ *
+ * Objects are carved out of chunks that are never moved or resized, so a
+ * pointer returned by prefix##_pool_obtain() stays valid until it is
+ * released. Released objects are kept on an intrusive free list (the
+ * link is stored inside the released object) and a new chunk is only
+ * sliced up as objects are handed out, so both obtain and growing the
+ * pool are O(1).
+ *
+ * @defgroup lc_pool Object Pool
+ * @ingroup Memory
+ * @{
+ */
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
-#include "vector.h"
+#include <assert.h>
+#include "alloc.h"
 
 /**
  * Pool should grow linearly.
@@ -52,29 +71,51 @@
 
 /*
  * Declare an object pool for a specific data type.
+ *
+ * prefix##_pool_allocator() fills in an lc_allocator_t that hands out
+ * objects from the pool, so the pool can be used as the node allocator
+ * of a container. Requests larger than data_type fail.
  */
 #define LC_POOL_DECL( prefix, data_type ) \
 	struct prefix##_pool; \
 	typedef struct prefix##_pool prefix##_pool_t; \
 	\
-	prefix##_pool_t* prefix##_pool_create  ( size_t count, int growth ); \
-	void             prefix##_pool_destroy ( prefix##_pool_t** pool ); \
-	data_type**      prefix##_pool_obtain  ( prefix##_pool_t* pool ); \
-	void             prefix##_pool_release ( prefix##_pool_t* pool, data_type** obj ); \
-	void             prefix##_pool_shrink( prefix##_pool_t* pool );
+	prefix##_pool_t* prefix##_pool_create    ( size_t count, int growth ); \
+	void             prefix##_pool_destroy   ( prefix##_pool_t** pool ); \
+	data_type*       prefix##_pool_obtain    ( prefix##_pool_t* pool ); \
+	void             prefix##_pool_release   ( prefix##_pool_t* pool, data_type** obj ); \
+	void             prefix##_pool_shrink    ( prefix##_pool_t* pool ); \
+	size_t           prefix##_pool_capacity  ( const prefix##_pool_t* pool ); \
+	size_t           prefix##_pool_outstanding ( const prefix##_pool_t* pool ); \
+	void             prefix##_pool_allocator ( prefix##_pool_t* pool, lc_allocator_t* allocator );
 
 
 /*
  * Implement an object pool for a specific data type.
  */
 #define LC_POOL_IMPL( prefix, data_type ) \
+	typedef union prefix##_pool_slot { \
+		data_type object; \
+		union prefix##_pool_slot* next; /* while on the free list */ \
+	} prefix##_pool_slot_t; \
+	\
+	typedef struct prefix##_pool_chunk { \
+		struct prefix##_pool_chunk* next; \
+		size_t count; \
+		prefix##_pool_slot_t slots[]; \
+	} prefix##_pool_chunk_t; \
+	\
 	struct prefix##_pool { \
 		int growth; \
-		data_type*  items;      /* data_type  items[ 10 ]; */ \
-		data_type** available;  /* data_type* available[ 10 ]; */ \
+		size_t capacity;    /* slots in all chunks */ \
+		size_t outstanding; /* objects handed out */ \
+		prefix##_pool_chunk_t* chunks; /* newest first */ \
+		prefix##_pool_slot_t*  free_list; \
+		prefix##_pool_slot_t*  unused;     /* never handed out slots */ \
+		prefix##_pool_slot_t*  unused_end; /* of the newest chunk */ \
 	}; \
 	\
-	static inline void prefix##_pool_grow( prefix##_pool_t* pool ); \
+	static inline bool prefix##_pool_grow( prefix##_pool_t* pool, size_t count ); \
 	\
 	prefix##_pool_t* prefix##_pool_create( size_t count, int growth ) \
 	{ \
@@ -88,13 +129,18 @@
 		\
 		if( pool ) \
 		{ \
-			pool->growth    = growth; \
-			lc_vector_create( pool->items, count ); \
-			lc_vector_create( pool->available, count ); \
+			pool->growth      = growth; \
+			pool->capacity    = 0; \
+			pool->outstanding = 0; \
+			pool->chunks      = NULL; \
+			pool->free_list   = NULL; \
+			pool->unused      = NULL; \
+			pool->unused_end  = NULL; \
 			\
-			for( size_t i = 0; i < count; i++ ) \
+			if( !prefix##_pool_grow( pool, count ) ) \
 			{ \
-				lc_vector_push( pool->available, &pool->items[ i ] ); \
+				free( pool ); \
+				pool = NULL; \
 			} \
 		} \
 		\
@@ -105,74 +151,574 @@
 	{ \
 		if( pool && *pool ) \
 		{ \
-			lc_vector_destroy( (*pool)->items	); \
-			lc_vector_destroy( (*pool)->available ); \
+			prefix##_pool_chunk_t* chunk = (*pool)->chunks; \
+			\
+			while( chunk ) \
+			{ \
+				prefix##_pool_chunk_t* next = chunk->next; \
+				free( chunk ); \
+				chunk = next; \
+			} \
+			\
 			free( *pool ); \
 			*pool = NULL; \
 		} \
 	} \
 	\
-	data_type** prefix##_pool_obtain( prefix##_pool_t* pool ) \
+	data_type* prefix##_pool_obtain( prefix##_pool_t* pool ) \
 	{ \
-		data_type** result = NULL; \
+		prefix##_pool_slot_t* slot = NULL; \
 		\
 		if( pool ) \
 		{ \
-			retry_obtain: \
+			if( pool->free_list ) \
 			{ \
-				const size_t available_count = lc_vector_size(pool->available); \
-				\
-				if( available_count > 0 ) \
+				slot            = pool->free_list; \
+				pool->free_list = slot->next; \
+			} \
+			else \
+			{ \
+				if( pool->unused == pool->unused_end && pool->growth ) \
 				{ \
-					data_type** obj = &lc_vector_last( pool->available ); \
-					lc_vector_pop( pool->available ); \
-					result = obj; \
+					size_t count = pool->growth > 0 ? (size_t) pool->growth : pool->capacity; \
+					prefix##_pool_grow( pool, count ); \
 				} \
-				else if( pool->growth ) \
+				\
+				if( pool->unused != pool->unused_end ) \
 				{ \
-					prefix##_pool_grow( pool ); \
-					goto retry_obtain; \
+					slot = pool->unused++; \
 				} \
 			} \
+			\
+			if( slot ) \
+			{ \
+				pool->outstanding++; \
+			} \
 		} \
 		\
-		return result; \
+		return (data_type*) slot; \
 	} \
 	\
 	void prefix##_pool_release( prefix##_pool_t* pool, data_type** obj ) \
 	{ \
 		if( pool && obj && *obj ) \
 		{ \
-			lc_vector_push( pool->available, (data_type*) *obj ); \
+			prefix##_pool_slot_t* slot = (prefix##_pool_slot_t*) *obj; \
+			\
+			assert( pool->outstanding > 0 ); \
+			slot->next      = pool->free_list; \
+			pool->free_list = slot; \
+			pool->outstanding--; \
 			*obj = NULL; \
 		} \
 	} \
 	\
-	void prefix##_pool_grow( prefix##_pool_t* pool ) \
+	void prefix##_pool_shrink( prefix##_pool_t* pool ) \
+	{ \
+		/* Chunks can only be returned when no object is in use; then */ \
+		/* every chunk except the oldest one is released.             */ \
+		if( pool && pool->outstanding == 0 && pool->chunks ) \
+		{ \
+			prefix##_pool_chunk_t* chunk = pool->chunks; \
+			\
+			while( chunk->next ) \
+			{ \
+				prefix##_pool_chunk_t* next = chunk->next; \
+				free( chunk ); \
+				chunk = next; \
+			} \
+			\
+			pool->chunks     = chunk; \
+			pool->capacity   = chunk->count; \
+			pool->free_list  = NULL; \
+			pool->unused     = chunk->slots; \
+			pool->unused_end = chunk->slots + chunk->count; \
+		} \
+	} \
+	\
+	size_t prefix##_pool_capacity( const prefix##_pool_t* pool ) \
+	{ \
+		return pool->capacity; \
+	} \
+	\
+	size_t prefix##_pool_outstanding( const prefix##_pool_t* pool ) \
+	{ \
+		return pool->outstanding; \
+	} \
+	\
+	static inline prefix##_pool_chunk_t* prefix##_pool_chunk_create( size_t count ) \
+	{ \
+		prefix##_pool_chunk_t* chunk = (prefix##_pool_chunk_t*) malloc( sizeof(prefix##_pool_chunk_t) + count * sizeof(prefix##_pool_slot_t) ); \
+		\
+		if( chunk ) \
+		{ \
+			LC_POOL_INITIALIZE_CHUNK( chunk, count * sizeof(prefix##_pool_slot_t) ); \
+			chunk->next  = NULL; \
+			chunk->count = count; \
+		} \
+		\
+		return chunk; \
+	} \
+	\
+	static inline void prefix##_pool_chunk_link( prefix##_pool_t* pool, prefix##_pool_chunk_t* chunk ) \
+	{ \
+		/* The new chunk is linked in and sliced up lazily by obtain; */ \
+		/* nothing that was handed out ever moves.                    */ \
+		\
+		/* Whatever is left of the previous chunk goes on the free list. */ \
+		while( pool->unused != pool->unused_end ) \
+		{ \
+			prefix##_pool_slot_t* slot = pool->unused++; \
+			slot->next      = pool->free_list; \
+			pool->free_list = slot; \
+		} \
+		\
+		chunk->next      = pool->chunks; \
+		pool->chunks     = chunk; \
+		pool->capacity  += chunk->count; \
+		pool->unused     = chunk->slots; \
+		pool->unused_end = chunk->slots + chunk->count; \
+	} \
+	\
+	bool prefix##_pool_grow( prefix##_pool_t* pool, size_t count ) \
+	{ \
+		prefix##_pool_chunk_t* chunk = prefix##_pool_chunk_create( count ); \
+		\
+		if( !chunk ) \
+		{ \
+			return false; \
+		} \
+		\
+		prefix##_pool_chunk_link( pool, chunk ); \
+		return true; \
+	} \
+	\
+	static void* prefix##_pool_allocator_alloc( void* ctx, size_t size ) \
+	{ \
+		assert( size <= sizeof(prefix##_pool_slot_t) ); \
+		return size <= sizeof(prefix##_pool_slot_t) ? prefix##_pool_obtain( (prefix##_pool_t*) ctx ) : NULL; \
+	} \
+	\
+	static void* prefix##_pool_allocator_realloc( void* ctx, void* data, size_t old_size, size_t new_size ) \
+	{ \
+		(void) old_size; \
+		if( !data ) \
+		{ \
+			return prefix##_pool_allocator_alloc( ctx, new_size ); \
+		} \
+		return new_size <= sizeof(prefix##_pool_slot_t) ? data : NULL; \
+	} \
+	\
+	static void prefix##_pool_allocator_free( void* ctx, void* data ) \
+	{ \
+		data_type* obj = (data_type*) data; \
+		prefix##_pool_release( (prefix##_pool_t*) ctx, &obj ); \
+	} \
+	\
+	void prefix##_pool_allocator( prefix##_pool_t* pool, lc_allocator_t* allocator ) \
+	{ \
+		allocator->alloc   = prefix##_pool_allocator_alloc; \
+		allocator->realloc = prefix##_pool_allocator_realloc; \
+		allocator->free    = prefix##_pool_allocator_free; \
+		allocator->ctx     = pool; \
+	}
+
+#ifdef LC_POOL_INITIALIZE_MEMORY
+# define LC_POOL_INITIALIZE_CHUNK( chunk, size )   memset( (chunk)->slots, LC_POOL_UNUSED_MEMORY_VALUE, (size) )
+#else
+# define LC_POOL_INITIALIZE_CHUNK( chunk, size )
+#endif
+
+/*
+ * Multi-threaded pools (C11).
+ *
+ * LC_POOL_MT_IMPL puts a per-thread cache of free objects in front of a
+ * pool made by LC_POOL_IMPL with the same prefix; that pool becomes the
+ * shared depot and is guarded by a spinlock. Obtain and release only
+ * touch the calling thread's cache, so they are lock-free until the cache
+ * runs empty or full; then LC_POOL_MT_BATCH objects are moved between the
+ * cache and the depot under a single lock. When the depot runs dry its
+ * next chunk is allocated with the lock released.
+ *
+ * Each pool has LC_POOL_MT_MAX_THREADS caches. A thread takes a cache
+ * slot the first time it uses a pool of this type and gives it back when
+ * it exits; the objects left in its caches go back to the depots then.
+ * While more than LC_POOL_MT_MAX_THREADS threads are using pools of the
+ * type, the threads that found no free slot go to the depot on every
+ * call. Objects may be released by a different thread than the one that
+ * obtained them.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#include <stdint.h>
+#define LC_POOL_MT
+
+#ifndef LC_POOL_MT_MAX_THREADS
+# define LC_POOL_MT_MAX_THREADS            (64)
+#endif
+#ifndef LC_POOL_MT_CACHE_SIZE
+# define LC_POOL_MT_CACHE_SIZE             (64)
+#endif
+#ifndef LC_POOL_MT_BATCH
+# define LC_POOL_MT_BATCH                  (LC_POOL_MT_CACHE_SIZE / 2)
+#endif
+#ifndef LC_POOL_MT_CACHE_LINE
+# define LC_POOL_MT_CACHE_LINE             (64)
+#endif
+/**
+ * Pause instructions spun before a waiting thread yields its time slice;
+ * the count doubles on every failed attempt up to this limit.
+ */
+#ifndef LC_POOL_MT_SPIN_LIMIT
+# define LC_POOL_MT_SPIN_LIMIT             (64)
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+typedef DWORD lc_pool_mt_key_t;
+#define LC_POOL_MT_CALLBACK                           WINAPI
+#define lc_pool_mt_key_create( p_key, destructor )    ((*(p_key) = FlsAlloc( destructor )) != FLS_OUT_OF_INDEXES)
+#define lc_pool_mt_key_set( key, value )              FlsSetValue( key, value )
+#define lc_pool_mt_yield( )                           SwitchToThread( )
+#else
+#include <pthread.h>
+#include <sched.h>
+typedef pthread_key_t lc_pool_mt_key_t;
+#define LC_POOL_MT_CALLBACK
+#define lc_pool_mt_key_create( p_key, destructor )    (pthread_key_create( p_key, destructor ) == 0)
+#define lc_pool_mt_key_set( key, value )              pthread_setspecific( key, value )
+#define lc_pool_mt_yield( )                           sched_yield( )
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+# define lc_pool_mt_pause( )                          __builtin_ia32_pause( )
+#elif defined(_M_IX86) || defined(_M_X64)
+# include <immintrin.h>
+# define lc_pool_mt_pause( )                          _mm_pause( )
+#elif defined(__aarch64__) || defined(__arm__)
+# define lc_pool_mt_pause( )                          __asm__ __volatile__( "yield" )
+#else
+# define lc_pool_mt_pause( )
+#endif
+
+static inline void lc_pool_mt_lock( atomic_flag* lock )
+{
+	unsigned spins = 1;
+
+	while( atomic_flag_test_and_set_explicit( lock, memory_order_acquire ) )
+	{
+		if( spins <= LC_POOL_MT_SPIN_LIMIT )
+		{
+			for( unsigned i = 0; i < spins; i++ )
+			{
+				lc_pool_mt_pause( );
+			}
+			spins *= 2;
+		}
+		else
+		{
+			/* The holder may have been preempted; let it run. */
+			lc_pool_mt_yield( );
+		}
+	}
+}
+
+static inline void lc_pool_mt_unlock( atomic_flag* lock )
+{
+	atomic_flag_clear_explicit( lock, memory_order_release );
+}
+
+#define LC_POOL_MT_DECL( prefix, data_type ) \
+	struct prefix##_pool_mt; \
+	typedef struct prefix##_pool_mt prefix##_pool_mt_t; \
+	\
+	prefix##_pool_mt_t* prefix##_pool_mt_create    ( size_t count, int growth ); \
+	void                prefix##_pool_mt_destroy   ( prefix##_pool_mt_t** pool ); \
+	data_type*          prefix##_pool_mt_obtain    ( prefix##_pool_mt_t* pool ); \
+	void                prefix##_pool_mt_release   ( prefix##_pool_mt_t* pool, data_type** obj ); \
+	void                prefix##_pool_mt_allocator ( prefix##_pool_mt_t* pool, lc_allocator_t* allocator );
+
+#define LC_POOL_MT_IMPL( prefix, data_type ) \
+	typedef struct prefix##_pool_mt_cache { \
+		_Alignas(LC_POOL_MT_CACHE_LINE) size_t count; \
+		data_type* items[ LC_POOL_MT_CACHE_SIZE ]; \
+	} prefix##_pool_mt_cache_t; \
+	\
+	struct prefix##_pool_mt { \
+		atomic_flag       lock; \
+		int               growth; /* the depot itself never grows */ \
+		prefix##_pool_t*  depot; \
+		prefix##_pool_mt_cache_t* caches; \
+		struct prefix##_pool_mt* next; /* live pools of this type */ \
+		struct prefix##_pool_mt* prev; \
+	}; \
+	\
+	/* Pools of this type and the cache slots of live threads, guarded */ \
+	/* by one lock; a slot is freed by the exit handler of its thread.  */ \
+	static atomic_flag prefix##_pool_mt_registry_lock = ATOMIC_FLAG_INIT; \
+	static prefix##_pool_mt_t* prefix##_pool_mt_pools = NULL; \
+	static bool prefix##_pool_mt_slot_used[ LC_POOL_MT_MAX_THREADS ]; \
+	static bool prefix##_pool_mt_key_ready = false; \
+	static lc_pool_mt_key_t prefix##_pool_mt_key; \
+	static _Thread_local size_t prefix##_pool_mt_thread = 0; /* 1-based slot */ \
+	\
+	static void LC_POOL_MT_CALLBACK prefix##_pool_mt_thread_exit( void* value ) \
+	{ \
+		size_t slot = (size_t) (uintptr_t) value - 1; \
+		prefix##_pool_mt_t* pool; \
+		\
+		/* Hand the cached objects back and free the slot. */ \
+		lc_pool_mt_lock( &prefix##_pool_mt_registry_lock ); \
+		for( pool = prefix##_pool_mt_pools; pool; pool = pool->next ) \
+		{ \
+			prefix##_pool_mt_cache_t* cache = &pool->caches[ slot ]; \
+			\
+			lc_pool_mt_lock( &pool->lock ); \
+			while( cache->count > 0 ) \
+			{ \
+				prefix##_pool_release( pool->depot, &cache->items[ --cache->count ] ); \
+			} \
+			lc_pool_mt_unlock( &pool->lock ); \
+		} \
+		prefix##_pool_mt_slot_used[ slot ] = false; \
+		lc_pool_mt_unlock( &prefix##_pool_mt_registry_lock ); \
+	} \
+	\
+	static inline size_t prefix##_pool_mt_thread_slot( void ) \
 	{ \
-		/* We ran out of items so we need to grow the */ \
-		/* pool.                                      */ \
-		size_t old_capacity = lc_vector_capacity( pool->items ); \
-		size_t new_capacity = pool->growth > 0 ? (old_capacity + (size_t)pool->growth) : (1.5f * old_capacity + 1); \
+		size_t slot = LC_POOL_MT_MAX_THREADS; /* none */ \
 		\
-		data_type* old_base = pool->items; \
+		lc_pool_mt_lock( &prefix##_pool_mt_registry_lock ); \
+		if( !prefix##_pool_mt_key_ready ) \
+		{ \
+			prefix##_pool_mt_key_ready = lc_pool_mt_key_create( &prefix##_pool_mt_key, prefix##_pool_mt_thread_exit ); \
+		} \
+		if( prefix##_pool_mt_key_ready ) \
+		{ \
+			for( slot = 0; slot < LC_POOL_MT_MAX_THREADS && prefix##_pool_mt_slot_used[ slot ]; slot++ ) \
+			{ \
+			} \
+			if( slot < LC_POOL_MT_MAX_THREADS ) \
+			{ \
+				prefix##_pool_mt_slot_used[ slot ] = true; \
+				lc_pool_mt_key_set( prefix##_pool_mt_key, (void*) (uintptr_t) (slot + 1) ); \
+			} \
+		} \
+		lc_pool_mt_unlock( &prefix##_pool_mt_registry_lock ); \
 		\
-		pool->items     = lc_vector_reserve( pool->items, new_capacity ); \
-		pool->available = lc_vector_reserve( pool->available, new_capacity ); \
+		return slot + 1; \
+	} \
+	\
+	static inline prefix##_pool_mt_cache_t* prefix##_pool_mt_cache( prefix##_pool_mt_t* pool ) \
+	{ \
+		if( prefix##_pool_mt_thread == 0 ) \
+		{ \
+			prefix##_pool_mt_thread = prefix##_pool_mt_thread_slot( ); \
+		} \
 		\
-		if( old_base != pool->items ) \
+		return prefix##_pool_mt_thread <= LC_POOL_MT_MAX_THREADS ? &pool->caches[ prefix##_pool_mt_thread - 1 ] : NULL; \
+	} \
+	\
+	/* Moves up to count objects from the depot into items. If the depot */ \
+	/* is empty it grows by a chunk that is allocated outside the lock.  */ \
+	static size_t prefix##_pool_mt_refill( prefix##_pool_mt_t* pool, data_type** items, size_t count ) \
+	{ \
+		prefix##_pool_chunk_t* chunk = NULL; \
+		size_t grow_count = 0; \
+		size_t n = 0; \
+		data_type* obj; \
+		\
+		lc_pool_mt_lock( &pool->lock ); \
+		while( n < count && (obj = prefix##_pool_obtain( pool->depot )) != NULL ) \
 		{ \
-			/* Pool was relocated somewhere else in memory. */ \
-			/* We need to update the previous pointers.     */ \
-			for( size_t i = 0; i < old_capacity; i++ ) \
+			items[ n++ ] = obj; \
+		} \
+		if( n == 0 && pool->growth ) \
+		{ \
+			grow_count = pool->growth > 0 ? (size_t) pool->growth : prefix##_pool_capacity( pool->depot ); \
+		} \
+		lc_pool_mt_unlock( &pool->lock ); \
+		\
+		if( grow_count > 0 ) \
+		{ \
+			chunk = prefix##_pool_chunk_create( grow_count ); \
+			\
+			lc_pool_mt_lock( &pool->lock ); \
+			/* Another thread may have refilled the depot meanwhile. */ \
+			while( n < count && (obj = prefix##_pool_obtain( pool->depot )) != NULL ) \
 			{ \
-				pool->available[ i ] = &pool->items[ i ]; \
+				items[ n++ ] = obj; \
 			} \
+			if( n == 0 && chunk ) \
+			{ \
+				prefix##_pool_chunk_link( pool->depot, chunk ); \
+				chunk = NULL; \
+				while( n < count && (obj = prefix##_pool_obtain( pool->depot )) != NULL ) \
+				{ \
+					items[ n++ ] = obj; \
+				} \
+			} \
+			lc_pool_mt_unlock( &pool->lock ); \
+			\
+			free( chunk ); \
 		} \
 		\
-		for( size_t i = old_capacity; i < new_capacity; i++ ) \
+		return n; \
+	} \
+	\
+	prefix##_pool_mt_t* prefix##_pool_mt_create( size_t count, int growth ) \
+	{ \
+		prefix##_pool_mt_t* pool = (prefix##_pool_mt_t*) malloc( sizeof(prefix##_pool_mt_t) ); \
+		\
+		if( pool ) \
 		{ \
-			lc_vector_push( pool->available, &pool->items[ i ] ); \
+			atomic_flag_clear( &pool->lock ); \
+			pool->growth = growth; \
+			pool->depot  = prefix##_pool_create( count, LC_POOL_GROWTH_NONE ); \
+			pool->caches = (prefix##_pool_mt_cache_t*) aligned_alloc( LC_POOL_MT_CACHE_LINE, LC_POOL_MT_MAX_THREADS * sizeof(prefix##_pool_mt_cache_t) ); \
+			\
+			if( !pool->depot || !pool->caches ) \
+			{ \
+				prefix##_pool_destroy( &pool->depot ); \
+				free( pool->caches ); \
+				free( pool ); \
+				return NULL; \
+			} \
+			\
+			for( size_t i = 0; i < LC_POOL_MT_MAX_THREADS; i++ ) \
+			{ \
+				pool->caches[ i ].count = 0; \
+			} \
+			\
+			lc_pool_mt_lock( &prefix##_pool_mt_registry_lock ); \
+			pool->prev = NULL; \
+			pool->next = prefix##_pool_mt_pools; \
+			if( pool->next ) \
+			{ \
+				pool->next->prev = pool; \
+			} \
+			prefix##_pool_mt_pools = pool; \
+			lc_pool_mt_unlock( &prefix##_pool_mt_registry_lock ); \
 		} \
+		\
+		return pool; \
+	} \
+	\
+	void prefix##_pool_mt_destroy( prefix##_pool_mt_t** pool ) \
+	{ \
+		/* No other thread may be using the pool. */ \
+		if( pool && *pool ) \
+		{ \
+			lc_pool_mt_lock( &prefix##_pool_mt_registry_lock ); \
+			if( (*pool)->prev ) \
+			{ \
+				(*pool)->prev->next = (*pool)->next; \
+			} \
+			else \
+			{ \
+				prefix##_pool_mt_pools = (*pool)->next; \
+			} \
+			if( (*pool)->next ) \
+			{ \
+				(*pool)->next->prev = (*pool)->prev; \
+			} \
+			lc_pool_mt_unlock( &prefix##_pool_mt_registry_lock ); \
+			\
+			prefix##_pool_destroy( &(*pool)->depot ); \
+			free( (*pool)->caches ); \
+			free( *pool ); \
+			*pool = NULL; \
+		} \
+	} \
+	\
+	data_type* prefix##_pool_mt_obtain( prefix##_pool_mt_t* pool ) \
+	{ \
+		prefix##_pool_mt_cache_t* cache = prefix##_pool_mt_cache( pool ); \
+		data_type* obj = NULL; \
+		\
+		if( !cache ) \
+		{ \
+			prefix##_pool_mt_refill( pool, &obj, 1 ); \
+			return obj; \
+		} \
+		\
+		if( cache->count == 0 ) \
+		{ \
+			/* Refill a batch from the depot. */ \
+			cache->count = prefix##_pool_mt_refill( pool, cache->items, LC_POOL_MT_BATCH ); \
+		} \
+		\
+		if( cache->count > 0 ) \
+		{ \
+			obj = cache->items[ --cache->count ]; \
+		} \
+		\
+		return obj; \
+	} \
+	\
+	void prefix##_pool_mt_release( prefix##_pool_mt_t* pool, data_type** obj ) \
+	{ \
+		prefix##_pool_mt_cache_t* cache; \
+		\
+		if( !pool || !obj || !*obj ) \
+		{ \
+			return; \
+		} \
+		\
+		cache = prefix##_pool_mt_cache( pool ); \
+		\
+		if( !cache ) \
+		{ \
+			lc_pool_mt_lock( &pool->lock ); \
+			prefix##_pool_release( pool->depot, obj ); \
+			lc_pool_mt_unlock( &pool->lock ); \
+			return; \
+		} \
+		\
+		if( cache->count == LC_POOL_MT_CACHE_SIZE ) \
+		{ \
+			/* Spill a batch back to the depot. */ \
+			lc_pool_mt_lock( &pool->lock ); \
+			while( cache->count > LC_POOL_MT_CACHE_SIZE - LC_POOL_MT_BATCH ) \
+			{ \
+				prefix##_pool_release( pool->depot, &cache->items[ --cache->count ] ); \
+			} \
+			lc_pool_mt_unlock( &pool->lock ); \
+		} \
+		\
+		cache->items[ cache->count++ ] = *obj; \
+		*obj = NULL; \
+	} \
+	\
+	static void* prefix##_pool_mt_allocator_alloc( void* ctx, size_t size ) \
+	{ \
+		assert( size <= sizeof(data_type) ); \
+		return size <= sizeof(data_type) ? prefix##_pool_mt_obtain( (prefix##_pool_mt_t*) ctx ) : NULL; \
+	} \
+	\
+	static void* prefix##_pool_mt_allocator_realloc( void* ctx, void* data, size_t old_size, size_t new_size ) \
+	{ \
+		(void) old_size; \
+		if( !data ) \
+		{ \
+			return prefix##_pool_mt_allocator_alloc( ctx, new_size ); \
+		} \
+		return new_size <= sizeof(data_type) ? data : NULL; \
+	} \
+	\
+	static void prefix##_pool_mt_allocator_free( void* ctx, void* data ) \
+	{ \
+		data_type* obj = (data_type*) data; \
+		prefix##_pool_mt_release( (prefix##_pool_mt_t*) ctx, &obj ); \
+	} \
+	\
+	void prefix##_pool_mt_allocator( prefix##_pool_mt_t* pool, lc_allocator_t* allocator ) \
+	{ \
+		allocator->alloc   = prefix##_pool_mt_allocator_alloc; \
+		allocator->realloc = prefix##_pool_mt_allocator_realloc; \
+		allocator->free    = prefix##_pool_mt_allocator_free; \
+		allocator->ctx     = pool; \
 	}
+#endif /* C11 */
 
+#endif /* _LC_POOL_H_ */
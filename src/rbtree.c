@@ -21,18 +21,37 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <assert.h>
 #include "rbtree.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef LC_RBTREE_ORDER_STATISTICS
+	#define RBNIL_COUNT          , 0 /* the nil leaf is an empty subtree */
+#else
+	#define RBNIL_COUNT
+#endif
+
+#ifdef LC_RBTREE_COMPACT_NODES
+	#define RBNIL_INITIALIZER    { (uintptr_t) &RBNIL, (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, NULL RBNIL_COUNT }
+#else
+	#define RBNIL_INITIALIZER    { (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, false, NULL RBNIL_COUNT }
+#endif
+
 #ifdef LC_EXTERN_RBNIL
 	/* Typical leaf node (always black).
 	 * This cannot be const because the parent pointer is manipulated.
 	 */
-	lc_rbnode_t RBNIL = { (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, false, NULL };
+	lc_rbnode_t RBNIL = RBNIL_INITIALIZER;
 #else
 	/* Typical leaf node (always black) */
-	static lc_rbnode_t RBNIL = { (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, false, NULL };
+	static lc_rbnode_t RBNIL = RBNIL_INITIALIZER;
 #endif
 
 #if defined(LC_RBTREE_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
@@ -47,23 +66,92 @@
 #endif
 
 
+#define rbt_alloc( p_tree, size )   lc_allocator_alloc( &(p_tree)->_allocator, (p_tree)->_alloc, size )
+#define rbt_free( p_tree, ptr )     lc_allocator_free( &(p_tree)->_allocator, (p_tree)->_free, ptr )
+
+#define rbt_parent( p_node )     lc_rbnode_parent( p_node )
+#define rbt_is_red( p_node )     lc_rbnode_is_red( p_node )
+
+#ifdef LC_RBTREE_COMPACT_NODES
+	#define rbt_set_parent( p_node, p_parent ) \
+		((p_node)->parent_color = (uintptr_t) (p_parent) | ((p_node)->parent_color & 1))
+	#define rbt_set_red( p_node, red ) \
+		((p_node)->parent_color = ((p_node)->parent_color & ~(uintptr_t) 1) | ((red) ? 1 : 0))
+	#define rbt_set_parent_color( p_node, p_parent, red ) \
+		((p_node)->parent_color = (uintptr_t) (p_parent) | ((red) ? 1 : 0))
+#else
+	#define rbt_set_parent( p_node, p_parent )  ((p_node)->parent = (p_parent))
+	#define rbt_set_red( p_node, red )          ((p_node)->is_red = (red))
+	#define rbt_set_parent_color( p_node, p_parent, red ) \
+		((p_node)->parent = (p_parent), (p_node)->is_red = (red))
+#endif
+
 #define nil_init( p_node ) \
-	(p_node)->parent = p_node; \
+	rbt_set_parent_color( p_node, p_node, false ); \
 	(p_node)->left   = p_node; \
 	(p_node)->right  = p_node; \
-	(p_node)->data   = NULL; \
-	(p_node)->is_red = false;
+	(p_node)->data   = NULL;
 
 #define lc_rbnode_init( p_node, p_data, p_parent, p_left, p_right, color ) \
-	(p_node)->parent = p_parent; \
+	rbt_set_parent_color( p_node, p_parent, color ); \
 	(p_node)->left   = p_left; \
 	(p_node)->right  = p_right; \
-	(p_node)->data   = (void *) p_data; \
-	(p_node)->is_red = color;
+	(p_node)->data   = (void *) p_data;
+
+/*
+ * Nodes from lc_rbtree_build_sorted() are freed with their block. The test
+ * compares addresses as integers, since ordering pointers into different
+ * objects is undefined; a node below the block wraps around to a large
+ * offset.
+ */
+#define rbt_node_in_block( p_tree, p_node ) \
+	((p_tree)->_block && (uintptr_t) (p_node) - (uintptr_t) (p_tree)->_block < (p_tree)->_block_count * sizeof(*(p_tree)->_block))
+
+static inline void rbt_node_free( lc_rbtree_t* p_tree, lc_rbnode_t *p_node )
+{
+	if( !rbt_node_in_block( p_tree, p_node ) )
+	{
+		rbt_free( p_tree, p_node );
+	}
+}
 
+static inline void rbt_block_release( lc_rbtree_t* p_tree )
+{
+	if( p_tree->_block )
+	{
+		p_tree->_free( p_tree->_block );
+		p_tree->_block       = NULL;
+		p_tree->_block_count = 0;
+	}
+}
 
 static lc_rbnode_t* lc_rbnode_search       ( lc_rbtree_t* p_tree, const void *key );
 
+#ifdef LC_RBTREE_ORDER_STATISTICS
+	#define rbt_count_update( p_node ) \
+		((p_node)->count = (p_node)->left->count + (p_node)->right->count + 1)
+	#define rbt_count_add( p_node, n ) \
+		((p_node)->count += (n))
+#else
+	#define rbt_count_update( p_node )
+	#define rbt_count_add( p_node, n )
+#endif
+
+#define rbt_augment( p_tree, p_node ) \
+	((p_tree)->_augment ? (p_tree)->_augment( (p_node), (p_tree)->_augment_data ) : (void) 0)
+
+/* Recompute the augmented data from p_node up to the root. */
+static inline void rbt_augment_path( const lc_rbtree_t* p_tree, lc_rbnode_t *p_node )
+{
+	if( p_tree->_augment )
+	{
+		for( ; p_node != &RBNIL; p_node = rbt_parent( p_node ) )
+		{
+			p_tree->_augment( p_node, p_tree->_augment_data );
+		}
+	}
+}
+
 
 static inline void lc_rbtree_left_rotate( lc_rbtree_t* p_tree, lc_rbnode_t *x )
 {
@@ -75,26 +163,31 @@ static inline void lc_rbtree_left_rotate( lc_rbtree_t* p_tree, lc_rbnode_t *x )
 
 	if( y->left != &RBNIL )
 	{
-		y->left->parent = x;
+		rbt_set_parent( y->left, x );
 	}
 
-	y->parent = x->parent;
+	rbt_set_parent( y, rbt_parent( x ) );
 
-	if( x->parent == &RBNIL )
+	if( rbt_parent( x ) == &RBNIL )
 	{
 		p_tree->root = y;
 	}
-	else if( x == x->parent->left )
+	else if( x == rbt_parent( x )->left )
 	{
-		x->parent->left = y;
+		rbt_parent( x )->left = y;
 	}
 	else
 	{
-		x->parent->right = y;
+		rbt_parent( x )->right = y;
 	}
 
 	y->left   = x;
-	x->parent = y;
+	rbt_set_parent( x, y );
+
+	rbt_count_update( x );
+	rbt_count_update( y );
+	rbt_augment( p_tree, x );
+	rbt_augment( p_tree, y );
 }
 
 static inline void lc_rbtree_right_rotate( lc_rbtree_t* p_tree, lc_rbnode_t *x )
@@ -107,164 +200,174 @@ static inline void lc_rbtree_right_rotate( lc_rbtree_t* p_tree, lc_rbnode_t *x )
 
 	if( y->right != &RBNIL )
 	{
-		y->right->parent = x;
+		rbt_set_parent( y->right, x );
 	}
 
-	y->parent = x->parent;
+	rbt_set_parent( y, rbt_parent( x ) );
 
-	if( x->parent == &RBNIL )
+	if( rbt_parent( x ) == &RBNIL )
 	{
 		p_tree->root = y;
 	}
-	else if( x == x->parent->right ) {
-		x->parent->right = y;
+	else if( x == rbt_parent( x )->right ) {
+		rbt_parent( x )->right = y;
 	}
 	else
 	{
-		x->parent->left = y;
+		rbt_parent( x )->left = y;
 	}
 
 	y->right  = x;
-	x->parent = y;
+	rbt_set_parent( x, y );
+
+	rbt_count_update( x );
+	rbt_count_update( y );
+	rbt_augment( p_tree, x );
+	rbt_augment( p_tree, y );
 }
 
-static inline void lc_rbtree_insert_fixup( lc_rbtree_t* p_tree, lc_rbnode_t ** t )
+/* Returns true if the root was red and recolored, i.e. the black height grew. */
+static inline bool lc_rbtree_insert_fixup( lc_rbtree_t* p_tree, lc_rbnode_t ** t )
 {
 	lc_rbnode_t *y = (lc_rbnode_t *) &RBNIL;
+	bool grew;
 
-	while( (*t)->parent->is_red )
+	while( rbt_is_red( rbt_parent( *t ) ) )
 	{
-		if( (*t)->parent == (*t)->parent->parent->left ) /* is parent on left side of grandparent... */
+		if( rbt_parent( *t ) == rbt_parent( rbt_parent( *t ) )->left ) /* is parent on left side of grandparent... */
 		{
-			y = (*t)->parent->parent->right; /* y is uncle */
+			y = rbt_parent( rbt_parent( *t ) )->right; /* y is uncle */
 			/* case 1 */
-			if( y->is_red ) /* uncle is red, just recolor */
+			if( rbt_is_red( y ) ) /* uncle is red, just recolor */
 			{
-				(*t)->parent->is_red = false;
-				y->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				(*t) = (*t)->parent->parent;
+				rbt_set_red( rbt_parent( *t ), false );
+				rbt_set_red( y, false );
+				rbt_set_red( rbt_parent( rbt_parent( *t ) ), true );
+				(*t) = rbt_parent( rbt_parent( *t ) );
 			}
 			else
 			{
 				/* case 2 - uncle is black and t is on the right */
-				if( (*t) == (*t)->parent->right )
+				if( (*t) == rbt_parent( *t )->right )
 				{
-					(*t) = (*t)->parent;
+					(*t) = rbt_parent( *t );
 					lc_rbtree_left_rotate( p_tree, (*t) );
 				}
 				/* case 3 - uncle is black and t is on the left */
-				(*t)->parent->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				lc_rbtree_right_rotate( p_tree, (*t)->parent->parent );
+				rbt_set_red( rbt_parent( *t ), false );
+				rbt_set_red( rbt_parent( rbt_parent( *t ) ), true );
+				lc_rbtree_right_rotate( p_tree, rbt_parent( rbt_parent( *t ) ) );
 			}
 		}
 		else  /* parent is on right side of grandparent... */
 		{
-			y = (*t)->parent->parent->left; /* y is uncle */
+			y = rbt_parent( rbt_parent( *t ) )->left; /* y is uncle */
 			/* case 1 */
-			if( y->is_red ) /* uncle is red */
+			if( rbt_is_red( y ) ) /* uncle is red */
 			{
-				(*t)->parent->is_red = false;
-				y->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				(*t) = (*t)->parent->parent;
+				rbt_set_red( rbt_parent( *t ), false );
+				rbt_set_red( y, false );
+				rbt_set_red( rbt_parent( rbt_parent( *t ) ), true );
+				(*t) = rbt_parent( rbt_parent( *t ) );
 			}
 			else
 			{
 				/* case 2 - uncle is black and t is on the left */
-				if( (*t) == (*t)->parent->left )
+				if( (*t) == rbt_parent( *t )->left )
 				{
-					(*t) = (*t)->parent;
+					(*t) = rbt_parent( *t );
 					lc_rbtree_right_rotate( p_tree, (*t) );
 				}
 				/* case 3 - uncle is black and t is on the right */
-				(*t)->parent->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				lc_rbtree_left_rotate( p_tree, (*t)->parent->parent );
+				rbt_set_red( rbt_parent( *t ), false );
+				rbt_set_red( rbt_parent( rbt_parent( *t ) ), true );
+				lc_rbtree_left_rotate( p_tree, rbt_parent( rbt_parent( *t ) ) );
 			}
 		}
 	}
 
-	p_tree->root->is_red = false;
+	grew = rbt_is_red( p_tree->root );
+	rbt_set_red( p_tree->root, false );
+
+	return grew;
 }
 
 static inline void lc_rbtree_delete_fixup( lc_rbtree_t* p_tree, lc_rbnode_t ** t )
 {
 	lc_rbnode_t *w = (lc_rbnode_t *) &RBNIL;
 
-	while( (*t) != p_tree->root && (*t)->is_red == false )
+	while( (*t) != p_tree->root && rbt_is_red( *t ) == false )
 	{
-		if( (*t) == (*t)->parent->left )
+		if( (*t) == rbt_parent( *t )->left )
 		{
-			w = (*t)->parent->right;
+			w = rbt_parent( *t )->right;
 
-			if( w->is_red )
+			if( rbt_is_red( w ) )
 			{
-				w->is_red            = false;
-				(*t)->parent->is_red = true;
-				lc_rbtree_left_rotate( p_tree, (*t)->parent );
-				w = (*t)->parent->right;
+				rbt_set_red( w, false );
+				rbt_set_red( rbt_parent( *t ), true );
+				lc_rbtree_left_rotate( p_tree, rbt_parent( *t ) );
+				w = rbt_parent( *t )->right;
 			}
 
-			if( w->left->is_red == false && w->right->is_red == false )
+			if( rbt_is_red( w->left ) == false && rbt_is_red( w->right ) == false )
 			{
-				w->is_red = true;
-				(*t) = (*t)->parent;
+				rbt_set_red( w, true );
+				(*t) = rbt_parent( *t );
 			}
 			else {
-				if( w->right->is_red == false )
+				if( rbt_is_red( w->right ) == false )
 				{
-					w->left->is_red = false;
-					w->is_red       = true;
+					rbt_set_red( w->left, false );
+					rbt_set_red( w, true );
 					lc_rbtree_right_rotate( p_tree, w );
-					w = (*t)->parent->right;
+					w = rbt_parent( *t )->right;
 				}
 
-				w->is_red            = (*t)->parent->is_red;
-				(*t)->parent->is_red = false;
-				w->right->is_red     = false;
-				lc_rbtree_left_rotate( p_tree, (*t)->parent );
+				rbt_set_red( w, rbt_is_red( rbt_parent( *t ) ) );
+				rbt_set_red( rbt_parent( *t ), false );
+				rbt_set_red( w->right, false );
+				lc_rbtree_left_rotate( p_tree, rbt_parent( *t ) );
 				(*t) = p_tree->root;
 			}
 		}
 		else
 		{
-			w = (*t)->parent->left;
+			w = rbt_parent( *t )->left;
 
-			if( w->is_red )
+			if( rbt_is_red( w ) )
 			{
-				w->is_red = false;
-				(*t)->parent->is_red = true;
-				lc_rbtree_right_rotate( p_tree, (*t)->parent );
-				w = (*t)->parent->left;
+				rbt_set_red( w, false );
+				rbt_set_red( rbt_parent( *t ), true );
+				lc_rbtree_right_rotate( p_tree, rbt_parent( *t ) );
+				w = rbt_parent( *t )->left;
 			}
 
-			if( w->right->is_red == false && w->left->is_red == false )
+			if( rbt_is_red( w->right ) == false && rbt_is_red( w->left ) == false )
 			{
-				w->is_red = true;
-				(*t) = (*t)->parent;
+				rbt_set_red( w, true );
+				(*t) = rbt_parent( *t );
 			}
 			else
 			{
-				if( w->left->is_red == false )
+				if( rbt_is_red( w->left ) == false )
 				{
-					w->right->is_red = false;
-					w->is_red = true;
+					rbt_set_red( w->right, false );
+					rbt_set_red( w, true );
 					lc_rbtree_left_rotate( p_tree, w );
-					w = (*t)->parent->left;
+					w = rbt_parent( *t )->left;
 				}
 
-				w->is_red = (*t)->parent->is_red;
-				(*t)->parent->is_red = false;
-				w->left->is_red = false;
-				lc_rbtree_right_rotate( p_tree, (*t)->parent );
+				rbt_set_red( w, rbt_is_red( rbt_parent( *t ) ) );
+				rbt_set_red( rbt_parent( *t ), false );
+				rbt_set_red( w->left, false );
+				lc_rbtree_right_rotate( p_tree, rbt_parent( *t ) );
 				(*t) = p_tree->root;
 			}
 		}
 	}
 
-	(*t)->is_red = false;
+	rbt_set_red( *t, false );
 }
 
 lc_rbnode_t *lc_rbnode_minimum( lc_rbnode_t *t )
@@ -288,12 +391,12 @@ lc_rbnode_t *lc_rbnode_successor( const lc_rbnode_t *t )
 		return lc_rbnode_minimum( t->right );
 	}
 
-	y = t->parent;
+	y = rbt_parent( t );
 
 	while( y != &RBNIL && t == y->right )
 	{
 		t = y;
-		y = y->parent;
+		y = rbt_parent( y );
 	}
 
 	return y;
@@ -308,12 +411,12 @@ lc_rbnode_t *lc_rbnode_predecessor( const lc_rbnode_t *t )
 		return lc_rbnode_maximum( t->left );
 	}
 
-	y = t->parent;
+	y = rbt_parent( t );
 
 	while( y != &RBNIL && t == y->left )
 	{
 		t = y;
-		y = y->parent;
+		y = rbt_parent( y );
 	}
 
 	return y;
@@ -344,8 +447,20 @@ void lc_rbtree_create( lc_rbtree_t* p_tree, lc_rbtree_element_fxn_t destroy, lc_
 	p_tree->_destroy = destroy;
 
 
-	p_tree->_alloc = malloc;
+	p_tree->_alloc = alloc;
 	p_tree->_free  = free;
+	p_tree->_block = NULL;
+	p_tree->_block_count = 0;
+	p_tree->_threads = 1;
+	p_tree->_augment = NULL;
+	p_tree->_augment_data = NULL;
+	lc_allocator_init( &p_tree->_allocator, NULL );
+}
+
+void lc_rbtree_create_with_allocator( lc_rbtree_t* p_tree, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	lc_rbtree_create( p_tree, destroy, compare, malloc, free );
+	lc_allocator_init( &p_tree->_allocator, allocator );
 }
 
 void lc_rbtree_destroy( lc_rbtree_t* p_tree )
@@ -392,13 +507,16 @@ bool lc_rbtree_insert( lc_rbtree_t* p_tree, const void *key )
 	assert( p_tree );
 	y   = (lc_rbnode_t *) &RBNIL;
 	x   = p_tree->root;
-	newNode = p_tree->_alloc( sizeof(lc_rbnode_t) );
+	newNode = rbt_alloc( p_tree, sizeof(lc_rbnode_t) );
 	if( !newNode ) return false;
 
 	/* Find where to insert the new node--y points the parent. */
 	while( x != &RBNIL )
 	{
 		y = x;
+		#ifdef LC_RBTREE_ORDER_STATISTICS
+		y->count++;
+		#endif
 		if( p_tree->_compare( key, x->data ) < 0 )
 		{
 			x = x->left;
@@ -427,6 +545,8 @@ bool lc_rbtree_insert( lc_rbtree_t* p_tree, const void *key )
 	}
 
 	lc_rbnode_init( newNode, key, y, (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, true );
+	rbt_count_update( newNode );
+	rbt_augment_path( p_tree, newNode );
 	lc_rbtree_insert_fixup( p_tree, &newNode );
 	p_tree->size++;
 
@@ -469,23 +589,35 @@ bool lc_rbtree_remove( lc_rbtree_t* p_tree, const void *key )
 		x = y->right;
 	}
 
-	x->parent = y->parent;
+	rbt_set_parent( x, rbt_parent( y ) );
 
-	if( y->parent == &RBNIL )
+	if( rbt_parent( y ) == &RBNIL )
 	{
 		p_tree->root = x;
 	}
 	else
 	{
-		if( y == y->parent->left )
+		if( y == rbt_parent( y )->left )
 		{
-			y->parent->left = x;
+			rbt_parent( y )->left = x;
 		}
 		else
 		{
-			y->parent->right = x;
+			rbt_parent( y )->right = x;
+		}
+	}
+
+	#ifdef LC_RBTREE_ORDER_STATISTICS
+	{
+		lc_rbnode_t *p;
+
+		/* Every ancestor of y lost one node. */
+		for( p = rbt_parent( y ); p != &RBNIL; p = rbt_parent( p ) )
+		{
+			p->count--;
 		}
 	}
+	#endif
 
 	if( y != t )
 	{
@@ -494,8 +626,8 @@ bool lc_rbtree_remove( lc_rbtree_t* p_tree, const void *key )
 		);
 
 		t->data = y->data;
-		y_is_red = y->is_red;
-		p_tree->_free( y );
+		y_is_red = rbt_is_red( y );
+		rbt_node_free( p_tree, y );
 	}
 	else
 	{
@@ -503,10 +635,13 @@ bool lc_rbtree_remove( lc_rbtree_t* p_tree, const void *key )
 			p_tree->_destroy( y->data );
 		);
 
-		y_is_red = y->is_red;
-		p_tree->_free( y );
+		y_is_red = rbt_is_red( y );
+		rbt_node_free( p_tree, y );
 	}
 
+	/* x's parent is where y was; t, if it took y's data, is above it. */
+	rbt_augment_path( p_tree, rbt_parent( x ) );
+
 	if( y_is_red == false ) /* y is black */
 	{
 		lc_rbtree_delete_fixup( p_tree, &x );
@@ -514,6 +649,11 @@ bool lc_rbtree_remove( lc_rbtree_t* p_tree, const void *key )
 
 	p_tree->size--;
 
+	if( p_tree->size == 0 )
+	{
+		rbt_block_release( p_tree );
+	}
+
 	return true;
 }
 
@@ -565,37 +705,37 @@ void lc_rbtree_clear( lc_rbtree_t* p_tree )
 
 		if( y->right == &RBNIL )
 		{
-			y->parent->left = (lc_rbnode_t *) &RBNIL;
-			x = y->parent;
+			rbt_parent( y )->left = (lc_rbnode_t *) &RBNIL;
+			x = rbt_parent( y );
 
 			/* free... */
 			DESTROY_CHECK(
 				p_tree->_destroy( y->data );
 			);
 
-			p_tree->_free( y );
+			rbt_node_free( p_tree, y );
 
 			p_tree->size--;
 		}
 		else
 		{
 			x = y->right;
-			x->parent = y->parent;
+			rbt_set_parent( x, rbt_parent( y ) );
 
-			if( x->parent == &RBNIL )
+			if( rbt_parent( x ) == &RBNIL )
 			{
 				p_tree->root = x;
 			}
 			else
 			{
-				y->parent->left = x;
+				rbt_parent( y )->left = x;
 			}
 			/* free... */
 			DESTROY_CHECK(
 				p_tree->_destroy( y->data );
 			);
 
-			p_tree->_free( y );
+			rbt_node_free( p_tree, y );
 
 			p_tree->size--;
 		}
@@ -607,6 +747,125 @@ void lc_rbtree_clear( lc_rbtree_t* p_tree )
 
 	/* reset the root and current pointers */
 	p_tree->root = (lc_rbnode_t *) &RBNIL;
+	rbt_block_release( p_tree );
+}
+
+/*
+ * Link data[lo, hi) into a subtree rooted at its middle element. The
+ * halves never differ in size by more than one, so only the deepest
+ * level (red_depth) can be partial; coloring it red keeps the black
+ * height of every path the same. Nodes come from block, or when there
+ * is no block from the spare list.
+ */
+static lc_rbnode_t* rbt_build( const lc_rbtree_t* p_tree, lc_rbnode_t *block, lc_rbnode_t **p_spare, void *const *data, size_t lo, size_t hi,
+                               size_t depth, size_t red_depth, lc_rbnode_t *parent )
+{
+	lc_rbnode_t *node;
+	size_t mid;
+
+	if( lo >= hi )
+	{
+		return (lc_rbnode_t *) &RBNIL;
+	}
+
+	mid = lo + (hi - lo) / 2;
+
+	if( block )
+	{
+		node = &block[ mid ];
+	}
+	else
+	{
+		node     = *p_spare;
+		*p_spare = node->right;
+	}
+
+	lc_rbnode_init( node, data[ mid ], parent, (lc_rbnode_t *) &RBNIL, (lc_rbnode_t *) &RBNIL, depth == red_depth );
+	node->left  = rbt_build( p_tree, block, p_spare, data, lo, mid, depth + 1, red_depth, node );
+	node->right = rbt_build( p_tree, block, p_spare, data, mid + 1, hi, depth + 1, red_depth, node );
+	rbt_count_update( node );
+	rbt_augment( p_tree, node );
+
+	return node;
+}
+
+bool lc_rbtree_build_sorted( lc_rbtree_t* p_tree, void *const *data, size_t count )
+{
+	lc_rbnode_t *block;
+	lc_rbnode_t *spare = NULL;
+	size_t full_levels = 0;
+	size_t i;
+
+	assert( p_tree );
+	assert( count == 0 || data );
+
+	if( p_tree->size > 0 )
+	{
+		return false;
+	}
+
+	for( i = 1; i < count; i++ )
+	{
+		if( p_tree->_compare( data[ i - 1 ], data[ i ] ) > 0 )
+		{
+			return false;
+		}
+	}
+
+	if( count == 0 )
+	{
+		return true;
+	}
+
+	if( count > SIZE_MAX / sizeof(lc_rbnode_t) )
+	{
+		return false;
+	}
+
+	if( lc_allocator_is_set( &p_tree->_allocator ) )
+	{
+		/* An allocator such as a pool may only hand out one node at a
+		 * time, so each node is obtained on its own. */
+		block = NULL;
+
+		for( i = 0; i < count; i++ )
+		{
+			lc_rbnode_t *node = (lc_rbnode_t *) rbt_alloc( p_tree, sizeof(lc_rbnode_t) );
+
+			if( !node )
+			{
+				while( spare )
+				{
+					node  = spare;
+					spare = spare->right;
+					rbt_free( p_tree, node );
+				}
+				return false;
+			}
+
+			node->right = spare;
+			spare       = node;
+		}
+	}
+	else
+	{
+		block = (lc_rbnode_t *) p_tree->_alloc( count * sizeof(lc_rbnode_t) );
+		if( !block ) return false;
+	}
+
+	/* floor(log2(count + 1)) levels are completely filled. */
+	for( i = count + 1; i > 1; i >>= 1 )
+	{
+		full_levels++;
+	}
+
+	rbt_block_release( p_tree );
+	p_tree->_block       = block;
+	p_tree->_block_count = block ? count : 0;
+	p_tree->root         = rbt_build( p_tree, block, &spare, data, 0, count, 0, full_levels, (lc_rbnode_t *) &RBNIL );
+	p_tree->size         = count;
+
+	return true;
 }
 
 /* ------------------------------------- */
@@ -648,132 +907,1023 @@ lc_rbtree_iterator_t lc_rbtree_end( )
 	return (lc_rbnode_t *) &RBNIL;
 }
 
-bool lc_rbtree_serialize( lc_rbtree_t* p_tree, size_t element_size, FILE *file )
+lc_rbtree_iterator_t lc_rbtree_lower_bound( const lc_rbtree_t* p_tree, const void *data )
 {
-	bool result = true;
-	size_t count;
-	lc_rbtree_iterator_t itr;
+	lc_rbnode_t *x;
+	lc_rbnode_t *result = (lc_rbnode_t *) &RBNIL;
 
 	assert( p_tree );
+	x = p_tree->root;
 
-	if( !p_tree )
+	while( x != &RBNIL )
 	{
-		result = false;
-		goto done;
+		if( p_tree->_compare( x->data, data ) < 0 )
+		{
+			x = x->right;
+		}
+		else
+		{
+			result = x;
+			x      = x->left;
+		}
 	}
 
-	count = lc_rbtree_size(p_tree);
-	if( fwrite( &count, sizeof(size_t), 1, file ) != 1 )
-	{
-		result = false;
-		goto done;
-	}
+	return result;
+}
 
+lc_rbtree_iterator_t lc_rbtree_upper_bound( const lc_rbtree_t* p_tree, const void *data )
+{
+	lc_rbnode_t *x;
+	lc_rbnode_t *result = (lc_rbnode_t *) &RBNIL;
 
-	for( itr = lc_rbtree_begin( p_tree );
-	     itr != lc_rbtree_end( ) && !ferror(file);
-	     itr = lc_rbtree_next( itr ) )
+	assert( p_tree );
+	x = p_tree->root;
+
+	while( x != &RBNIL )
 	{
-		if( fwrite( itr->data, element_size, 1, file ) != 1 )
+		if( p_tree->_compare( data, x->data ) < 0 )
 		{
-			result = false;
-			goto done;
+			result = x;
+			x      = x->left;
+		}
+		else
+		{
+			x = x->right;
 		}
 	}
 
-done:
 	return result;
 }
 
-bool lc_rbtree_unserialize( lc_rbtree_t* p_tree, size_t element_size, FILE *file )
+void lc_rbtree_equal_range( const lc_rbtree_t* p_tree, const void *data, lc_rbtree_iterator_t* p_first, lc_rbtree_iterator_t* p_last )
 {
-	bool result = true;
-	size_t count = 0;
-
-	assert( p_tree );
+	*p_first = lc_rbtree_lower_bound( p_tree, data );
+	*p_last  = lc_rbtree_upper_bound( p_tree, data );
+}
 
-	if( !p_tree )
-	{
-		result = false;
-		goto done;
-	}
+size_t lc_rbtree_range( const lc_rbtree_t* p_tree, const void *low, const void *high, lc_rbtree_range_fxn_t visit, void *user_data )
+{
+	lc_rbtree_iterator_t itr = low ? lc_rbtree_lower_bound( p_tree, low ) : lc_rbtree_begin( p_tree );
+	size_t count = 0;
 
-	if( fread( &count, sizeof(size_t), 1, file ) != 1 )
-	{
-		result = false;
-		goto done;
-	}
+	assert( visit );
 
-	while( count > 0 && feof(file) == 0 )
+	while( itr != &RBNIL && (!high || p_tree->_compare( itr->data, high ) < 0) )
 	{
-		void *p_data = p_tree->_alloc( element_size );
+		count++;
 
-		if( fread( p_data, element_size, 1, file ) != 1 )
+		if( !visit( itr->data, user_data ) )
 		{
-			p_tree->_free( p_data );
-
-			result = false;
-			goto done;
+			break;
 		}
 
-		lc_rbtree_insert( p_tree, p_data );
-		count--;
+		itr = lc_rbnode_successor( itr );
 	}
 
-done:
-	return result;
+	return count;
 }
 
-
-void lc_rbtree_alloc_set( lc_rbtree_t* p_tree, lc_alloc_fxn_t alloc )
+#ifdef LC_RBTREE_ORDER_STATISTICS
+lc_rbtree_iterator_t lc_rbtree_select( const lc_rbtree_t* p_tree, size_t k )
 {
+	lc_rbnode_t *x;
+
 	assert( p_tree );
-	assert( alloc );
-	p_tree->_alloc = alloc;
+	x = p_tree->root;
+
+	while( x != &RBNIL )
+	{
+		if( k < x->left->count )
+		{
+			x = x->left;
+		}
+		else if( k == x->left->count )
+		{
+			return x;
+		}
+		else
+		{
+			k -= x->left->count + 1;
+			x = x->right;
+		}
+	}
+
+	return (lc_rbnode_t *) &RBNIL;
 }
 
-void lc_rbtree_free_set( lc_rbtree_t* p_tree, lc_free_fxn_t free )
+size_t lc_rbtree_rank( const lc_rbtree_t* p_tree, const void *data )
 {
+	lc_rbnode_t *x;
+	size_t rank = 0;
+
 	assert( p_tree );
-	assert( free );
-	p_tree->_free = free;
+	x = p_tree->root;
+
+	while( x != &RBNIL )
+	{
+		if( p_tree->_compare( x->data, data ) < 0 )
+		{
+			rank += x->left->count + 1;
+			x = x->right;
+		}
+		else
+		{
+			x = x->left;
+		}
+	}
+
+	return rank;
 }
+#endif
 
+/* ------------------------------------- */
 
-#ifdef LC_RBTREE_DEBUG
-static bool lc_rbnode_verify_tree  ( lc_rbtree_t* p_tree, lc_rbnode_t *t );
-static void padding             ( char ch, int n );
-static void structure           ( const lc_rbnode_t *root, int level );
+/*
+ * Join based split, join and set operations (Blelloch, Ferizovic and Sun,
+ * "Just Join for Parallel Ordered Sets"). The algorithms work on detached
+ * subtrees whose black heights are carried along so that a join only walks
+ * down the spine of the taller tree by the difference in heights.
+ */
+typedef struct rbt_part {
+	lc_rbnode_t* root;
+	size_t bh;   /* black nodes on every path from root (inclusive) to a leaf */
+} rbt_part_t;
 
-bool lc_rbtree_verify_tree( lc_rbtree_t* p_tree )
+#define rbt_part_empty( ) ((rbt_part_t) { (lc_rbnode_t *) &RBNIL, 0 })
+
+/* Only fork a subtree when it has at least 2^height - 1 elements. */
+#ifndef LC_RBTREE_PARALLEL_MIN_HEIGHT
+#define LC_RBTREE_PARALLEL_MIN_HEIGHT   (10)
+#endif
+
+static inline size_t rbt_black_height( const lc_rbnode_t *t )
 {
-	assert( p_tree );
+	size_t bh = 0;
 
-	/* check if root is black... */
-	if( p_tree->root->is_red )
+	for( ; t != &RBNIL; t = t->left )
 	{
-		return false;
+		bh += rbt_is_red( t ) ? 0 : 1;
 	}
 
-	return lc_rbnode_verify_tree( p_tree, p_tree->root );
+	return bh;
 }
 
-bool lc_rbnode_verify_tree( lc_rbtree_t* p_tree, lc_rbnode_t *t )
+static size_t rbt_subtree_size( const lc_rbnode_t *t )
 {
-	assert( p_tree );
+#ifdef LC_RBTREE_ORDER_STATISTICS
+	return t->count;
+#else
+	return t == &RBNIL ? 0 : rbt_subtree_size( t->left ) + rbt_subtree_size( t->right ) + 1;
+#endif
+}
 
-	if( t == &RBNIL )
-	{
-		return true;
-	}
+/* Detach the children of t as trees of their own. */
+static inline void rbt_expose( lc_rbnode_t *t, size_t bh, rbt_part_t *p_left, rbt_part_t *p_right )
+{
+	size_t child_bh = bh - (rbt_is_red( t ) ? 0 : 1);
 
-	if( t->is_red )
-	{
-		if( t->left->is_red || t->right->is_red )
-		{
-			return false;
-		}
-	}
+	p_left->root  = t->left;
+	p_left->bh    = child_bh;
+	p_right->root = t->right;
+	p_right->bh   = child_bh;
+
+	if( t->left != &RBNIL )  rbt_set_parent( t->left, (lc_rbnode_t *) &RBNIL );
+	if( t->right != &RBNIL ) rbt_set_parent( t->right, (lc_rbnode_t *) &RBNIL );
+}
+
+/*
+ * Join left, k and right, where every element of left is not greater than
+ * k and every element of right not less. The taller tree's spine is walked
+ * down to a black node as high as the other tree, k is linked in there as a
+ * red node and the insert fixup repairs the tree.
+ */
+static rbt_part_t rbt_join( const lc_rbtree_t* p_tree, rbt_part_t left, lc_rbnode_t *k, rbt_part_t right )
+{
+	lc_rbtree_t tree;
+	rbt_part_t result;
+	lc_rbnode_t *p = (lc_rbnode_t *) &RBNIL;
+	lc_rbnode_t *x;
+	size_t bh;
+
+	if( rbt_is_red( left.root ) )  { rbt_set_red( left.root, false ); left.bh++; }
+	if( rbt_is_red( right.root ) ) { rbt_set_red( right.root, false ); right.bh++; }
+
+	if( left.bh == right.bh )
+	{
+		lc_rbnode_init( k, k->data, (lc_rbnode_t *) &RBNIL, left.root, right.root, false );
+		if( left.root != &RBNIL )  rbt_set_parent( left.root, k );
+		if( right.root != &RBNIL ) rbt_set_parent( right.root, k );
+		rbt_count_update( k );
+		rbt_augment( p_tree, k );
+
+		result.root = k;
+		result.bh   = left.bh + 1;
+		return result;
+	}
+
+	if( left.bh > right.bh )
+	{
+		tree.root = left.root;
+		x  = left.root;
+		bh = left.bh;
+
+		while( rbt_is_red( x ) || bh > right.bh )
+		{
+			rbt_count_add( x, right.root->count + 1 );
+			bh -= rbt_is_red( x ) ? 0 : 1;
+			p = x;
+			x = x->right;
+		}
+
+		lc_rbnode_init( k, k->data, p, x, right.root, true );
+		p->right = k;
+	}
+	else
+	{
+		tree.root = right.root;
+		x  = right.root;
+		bh = right.bh;
+
+		while( rbt_is_red( x ) || bh > left.bh )
+		{
+			rbt_count_add( x, left.root->count + 1 );
+			bh -= rbt_is_red( x ) ? 0 : 1;
+			p = x;
+			x = x->left;
+		}
+
+		lc_rbnode_init( k, k->data, p, left.root, x, true );
+		p->left = k;
+	}
+
+	if( k->left != &RBNIL )  rbt_set_parent( k->left, k );
+	if( k->right != &RBNIL ) rbt_set_parent( k->right, k );
+	rbt_count_update( k );
+
+	if( p_tree->_augment )
+	{
+		/* k's ancestors on the spine gained a subtree. */
+		for( x = k; ; x = rbt_parent( x ) )
+		{
+			p_tree->_augment( x, p_tree->_augment_data );
+			if( x == tree.root ) break;
+		}
+	}
+
+	tree._augment      = p_tree->_augment;
+	tree._augment_data = p_tree->_augment_data;
+	result.bh   = (left.bh > right.bh ? left.bh : right.bh) + (lc_rbtree_insert_fixup( &tree, &k ) ? 1 : 0);
+	result.root = tree.root;
+	return result;
+}
+
+/* Remove the last element of t and return it. */
+static lc_rbnode_t* rbt_split_last( const lc_rbtree_t* p_tree, rbt_part_t t, rbt_part_t *p_rest )
+{
+	rbt_part_t left;
+	rbt_part_t right;
+	lc_rbnode_t *last;
+
+	rbt_expose( t.root, t.bh, &left, &right );
+
+	if( right.root == &RBNIL )
+	{
+		*p_rest = left;
+		return t.root;
+	}
+
+	last    = rbt_split_last( p_tree, right, &right );
+	*p_rest = rbt_join( p_tree, left, t.root, right );
+	return last;
+}
+
+/* Join two trees where every element of left is not greater than any of right. */
+static rbt_part_t rbt_join2( const lc_rbtree_t* p_tree, rbt_part_t left, rbt_part_t right )
+{
+	lc_rbnode_t *last;
+
+	if( left.root == &RBNIL )
+	{
+		return right;
+	}
+
+	last = rbt_split_last( p_tree, left, &left );
+	return rbt_join( p_tree, left, last, right );
+}
+
+/*
+ * Split t into the elements less than data and the rest. If exact is
+ * true, one element equal to data is left out of both and returned.
+ */
+static lc_rbnode_t* rbt_split( const lc_rbtree_t* p_tree, rbt_part_t t, const void *data, bool exact, rbt_part_t *p_less, rbt_part_t *p_greater )
+{
+	rbt_part_t left;
+	rbt_part_t right;
+	lc_rbnode_t *middle;
+	int c;
+
+	if( t.root == &RBNIL )
+	{
+		*p_less    = rbt_part_empty( );
+		*p_greater = rbt_part_empty( );
+		return (lc_rbnode_t *) &RBNIL;
+	}
+
+	rbt_expose( t.root, t.bh, &left, &right );
+	c = p_tree->_compare( data, t.root->data );
+
+	if( exact && c == 0 )
+	{
+		*p_less    = left;
+		*p_greater = right;
+		return t.root;
+	}
+	else if( c <= 0 )
+	{
+		middle     = rbt_split( p_tree, left, data, exact, p_less, &left );
+		*p_greater = rbt_join( p_tree, left, t.root, right );
+	}
+	else
+	{
+		middle  = rbt_split( p_tree, right, data, exact, &right, p_greater );
+		*p_less = rbt_join( p_tree, left, t.root, right );
+	}
+
+	return middle;
+}
+
+static inline void rbt_dispose( lc_rbtree_t* p_tree, lc_rbnode_t *t )
+{
+	DESTROY_CHECK(
+		p_tree->_destroy( t->data );
+	);
+
+	rbt_node_free( p_tree, t );
+}
+
+static size_t rbt_dispose_subtree( lc_rbtree_t* p_tree, lc_rbnode_t *t )
+{
+	size_t count;
+
+	if( t == &RBNIL )
+	{
+		return 0;
+	}
+
+	count = rbt_dispose_subtree( p_tree, t->left ) + rbt_dispose_subtree( p_tree, t->right ) + 1;
+	rbt_dispose( p_tree, t );
+	return count;
+}
+
+/*
+ * Give every node from lc_rbtree_build_sorted() an allocation of its own so
+ * that it can move to another tree.
+ */
+static lc_rbnode_t* rbt_relocate( lc_rbtree_t* p_tree, lc_rbnode_t *t, bool *p_relocated )
+{
+	lc_rbnode_t *node = t;
+
+	if( t == &RBNIL )
+	{
+		return t;
+	}
+
+	t->left  = rbt_relocate( p_tree, t->left, p_relocated );
+	t->right = rbt_relocate( p_tree, t->right, p_relocated );
+
+	if( rbt_node_in_block( p_tree, t ) )
+	{
+		node = rbt_alloc( p_tree, sizeof(lc_rbnode_t) );
+
+		if( node )
+		{
+			*node = *t;
+		}
+		else
+		{
+			node = t;
+			*p_relocated = false;
+		}
+	}
+
+	if( node->left != &RBNIL )  rbt_set_parent( node->left, node );
+	if( node->right != &RBNIL ) rbt_set_parent( node->right, node );
+
+	return node;
+}
+
+static bool rbt_unblock( lc_rbtree_t* p_tree )
+{
+	bool relocated = true;
+
+	if( p_tree->_block )
+	{
+		p_tree->root = rbt_relocate( p_tree, p_tree->root, &relocated );
+		rbt_set_parent( p_tree->root, (lc_rbnode_t *) &RBNIL );
+
+		if( relocated )
+		{
+			rbt_block_release( p_tree );
+		}
+	}
+
+	return relocated;
+}
+
+static inline bool rbt_same_allocator( const lc_rbtree_t* p_a, const lc_rbtree_t* p_b )
+{
+	return p_a->_alloc == p_b->_alloc && p_a->_free == p_b->_free &&
+	       p_a->_allocator.alloc == p_b->_allocator.alloc &&
+	       p_a->_allocator.free == p_b->_allocator.free &&
+	       p_a->_allocator.ctx == p_b->_allocator.ctx;
+}
+
+/*
+ * A set operation on the subtrees a (from p_tree) and b (from p_other).
+ * The two halves of each step are independent and may run on another
+ * thread until the fork budget is spent.
+ */
+struct rbt_task;
+typedef void (*rbt_set_fxn_t) ( struct rbt_task* task );
+
+typedef struct rbt_task {
+	lc_rbtree_t*  p_tree;
+	lc_rbtree_t*  p_other;
+	rbt_set_fxn_t run;
+	size_t        forks;          /* levels that may still fork */
+	rbt_part_t    a;
+	rbt_part_t    b;
+	rbt_part_t    result;
+	size_t        tree_disposed;  /* elements destroyed from p_tree */
+	size_t        other_disposed; /* elements destroyed from p_other */
+} rbt_task_t;
+
+#ifdef _WIN32
+typedef HANDLE rbt_thread_t;
+
+static DWORD WINAPI rbt_thread_main( LPVOID arg )
+{
+	rbt_task_t* task = arg;
+	task->run( task );
+	return 0;
+}
+
+#define rbt_thread_start( p_thread, task )  ((*(p_thread) = CreateThread( NULL, 0, rbt_thread_main, task, 0, NULL )) != NULL)
+#define rbt_thread_join( thread )           (WaitForSingleObject( thread, INFINITE ), CloseHandle( thread ))
+#else
+typedef pthread_t rbt_thread_t;
+
+static void* rbt_thread_main( void* arg )
+{
+	rbt_task_t* task = arg;
+	task->run( task );
+	return NULL;
+}
+
+#define rbt_thread_start( p_thread, task )  (pthread_create( p_thread, NULL, rbt_thread_main, task ) == 0)
+#define rbt_thread_join( thread )           pthread_join( thread, NULL )
+#endif
+
+static inline void rbt_task_init( rbt_task_t* task, const rbt_task_t* parent, rbt_part_t a, rbt_part_t b )
+{
+	*task = *parent;
+	task->forks          = parent->forks > 0 ? parent->forks - 1 : 0;
+	task->a              = a;
+	task->b              = b;
+	task->result         = rbt_part_empty( );
+	task->tree_disposed  = 0;
+	task->other_disposed = 0;
+}
+
+static void rbt_fork( rbt_task_t* parent, rbt_task_t* left, rbt_task_t* right )
+{
+	rbt_thread_t thread;
+	bool forked = false;
+
+	if( parent->forks > 0 &&
+	    (left->a.bh >= LC_RBTREE_PARALLEL_MIN_HEIGHT || left->b.bh >= LC_RBTREE_PARALLEL_MIN_HEIGHT) )
+	{
+		forked = rbt_thread_start( &thread, left );
+	}
+
+	if( !forked )
+	{
+		left->run( left );
+	}
+
+	right->run( right );
+
+	if( forked )
+	{
+		rbt_thread_join( thread );
+	}
+
+	parent->tree_disposed  += left->tree_disposed + right->tree_disposed;
+	parent->other_disposed += left->other_disposed + right->other_disposed;
+}
+
+static void rbt_union( rbt_task_t* task )
+{
+	rbt_task_t left;
+	rbt_task_t right;
+	rbt_part_t a_left, a_right, b_left, b_right;
+	lc_rbnode_t *k = task->a.root;
+	lc_rbnode_t *m;
+
+	if( task->a.root == &RBNIL )
+	{
+		task->result = task->b;
+		return;
+	}
+
+	if( task->b.root == &RBNIL )
+	{
+		task->result = task->a;
+		return;
+	}
+
+	rbt_expose( k, task->a.bh, &a_left, &a_right );
+	m = rbt_split( task->p_tree, task->b, k->data, true, &b_left, &b_right );
+
+	if( m != &RBNIL )
+	{
+		rbt_dispose( task->p_other, m );
+		task->other_disposed++;
+	}
+
+	rbt_task_init( &left, task, a_left, b_left );
+	rbt_task_init( &right, task, a_right, b_right );
+	rbt_fork( task, &left, &right );
+
+	task->result = rbt_join( task->p_tree, left.result, k, right.result );
+}
+
+static void rbt_intersection( rbt_task_t* task )
+{
+	rbt_task_t left;
+	rbt_task_t right;
+	rbt_part_t a_left, a_right, b_left, b_right;
+	lc_rbnode_t *k = task->a.root;
+	lc_rbnode_t *m;
+
+	if( task->a.root == &RBNIL || task->b.root == &RBNIL )
+	{
+		task->tree_disposed  += rbt_dispose_subtree( task->p_tree, task->a.root );
+		task->other_disposed += rbt_dispose_subtree( task->p_other, task->b.root );
+		task->result = rbt_part_empty( );
+		return;
+	}
+
+	rbt_expose( k, task->a.bh, &a_left, &a_right );
+	m = rbt_split( task->p_tree, task->b, k->data, true, &b_left, &b_right );
+
+	rbt_task_init( &left, task, a_left, b_left );
+	rbt_task_init( &right, task, a_right, b_right );
+	rbt_fork( task, &left, &right );
+
+	if( m != &RBNIL )
+	{
+		rbt_dispose( task->p_other, m );
+		task->other_disposed++;
+		task->result = rbt_join( task->p_tree, left.result, k, right.result );
+	}
+	else
+	{
+		rbt_dispose( task->p_tree, k );
+		task->tree_disposed++;
+		task->result = rbt_join2( task->p_tree, left.result, right.result );
+	}
+}
+
+static void rbt_difference( rbt_task_t* task )
+{
+	rbt_task_t left;
+	rbt_task_t right;
+	rbt_part_t a_left, a_right, b_left, b_right;
+	lc_rbnode_t *k = task->b.root;
+	lc_rbnode_t *m;
+
+	if( task->a.root == &RBNIL || task->b.root == &RBNIL )
+	{
+		task->other_disposed += rbt_dispose_subtree( task->p_other, task->b.root );
+		task->result = task->a;
+		return;
+	}
+
+	rbt_expose( k, task->b.bh, &b_left, &b_right );
+	m = rbt_split( task->p_tree, task->a, k->data, true, &a_left, &a_right );
+
+	rbt_task_init( &left, task, a_left, b_left );
+	rbt_task_init( &right, task, a_right, b_right );
+	rbt_fork( task, &left, &right );
+
+	rbt_dispose( task->p_other, k );
+	task->other_disposed++;
+
+	if( m != &RBNIL )
+	{
+		rbt_dispose( task->p_tree, m );
+		task->tree_disposed++;
+	}
+
+	task->result = rbt_join2( task->p_tree, left.result, right.result );
+}
+
+/* Make result (with size elements) the contents of p_tree. */
+static void rbt_set_root( lc_rbtree_t* p_tree, rbt_part_t result, size_t size )
+{
+	if( result.root != &RBNIL )
+	{
+		rbt_set_parent( result.root, (lc_rbnode_t *) &RBNIL );
+		rbt_set_red( result.root, false );
+	}
+
+	p_tree->root = result.root;
+	p_tree->size = size;
+
+	if( p_tree->size == 0 )
+	{
+		rbt_block_release( p_tree );
+	}
+}
+
+static bool rbt_set_operation( lc_rbtree_t* p_tree, lc_rbtree_t* p_other, rbt_set_fxn_t run )
+{
+	rbt_task_t task;
+	size_t size;
+
+	assert( p_tree );
+	assert( p_other );
+	assert( p_tree->_compare == p_other->_compare );
+
+	if( p_tree == p_other )
+	{
+		return false;
+	}
+
+	/* Only a union moves elements out of p_other. */
+	if( run == rbt_union && (!rbt_same_allocator( p_tree, p_other ) || !rbt_unblock( p_other )) )
+	{
+		return false;
+	}
+
+	task.p_tree         = p_tree;
+	task.p_other        = p_other;
+	task.run            = run;
+	task.forks          = 0;
+	task.a.root         = p_tree->root;
+	task.a.bh           = rbt_black_height( p_tree->root );
+	task.b.root         = p_other->root;
+	task.b.bh           = rbt_black_height( p_other->root );
+	task.result         = rbt_part_empty( );
+	task.tree_disposed  = 0;
+	task.other_disposed = 0;
+
+	while( ((size_t) 1 << task.forks) < p_tree->_threads )
+	{
+		task.forks++;
+	}
+
+	run( &task );
+
+	if( run == rbt_union )
+	{
+		size = p_tree->size + p_other->size - task.other_disposed;
+	}
+	else
+	{
+		size = p_tree->size - task.tree_disposed;
+	}
+
+	rbt_set_root( p_tree, task.result, size );
+	rbt_set_root( p_other, rbt_part_empty( ), 0 );
+	return true;
+}
+
+bool lc_rbtree_union( lc_rbtree_t* p_tree, lc_rbtree_t* p_other )
+{
+	return rbt_set_operation( p_tree, p_other, rbt_union );
+}
+
+bool lc_rbtree_intersection( lc_rbtree_t* p_tree, lc_rbtree_t* p_other )
+{
+	return rbt_set_operation( p_tree, p_other, rbt_intersection );
+}
+
+bool lc_rbtree_difference( lc_rbtree_t* p_tree, lc_rbtree_t* p_other )
+{
+	return rbt_set_operation( p_tree, p_other, rbt_difference );
+}
+
+bool lc_rbtree_split( lc_rbtree_t* p_tree, const void *data, lc_rbtree_t* p_greater )
+{
+	rbt_part_t less;
+	rbt_part_t greater;
+	rbt_part_t tree;
+	size_t moved;
+
+	assert( p_tree );
+	assert( p_greater );
+	assert( p_tree->_compare == p_greater->_compare );
+
+	if( p_tree == p_greater || p_greater->size > 0 || !rbt_same_allocator( p_tree, p_greater ) )
+	{
+		return false;
+	}
+
+	if( !rbt_unblock( p_tree ) )
+	{
+		return false;
+	}
+
+	tree.root = p_tree->root;
+	tree.bh   = rbt_black_height( p_tree->root );
+	rbt_split( p_tree, tree, data, false, &less, &greater );
+	moved = rbt_subtree_size( greater.root );
+
+	rbt_set_root( p_greater, greater, moved );
+	rbt_set_root( p_tree, less, p_tree->size - moved );
+	return true;
+}
+
+bool lc_rbtree_join( lc_rbtree_t* p_tree, lc_rbtree_t* p_other )
+{
+	rbt_part_t left;
+	rbt_part_t right;
+	size_t size;
+
+	assert( p_tree );
+	assert( p_other );
+	assert( p_tree->_compare == p_other->_compare );
+
+	if( p_tree == p_other || !rbt_same_allocator( p_tree, p_other ) )
+	{
+		return false;
+	}
+
+	if( p_tree->size > 0 && p_other->size > 0 &&
+	    p_tree->_compare( lc_rbnode_maximum( p_tree->root )->data, lc_rbnode_minimum( p_other->root )->data ) > 0 )
+	{
+		return false;
+	}
+
+	if( !rbt_unblock( p_other ) )
+	{
+		return false;
+	}
+
+	left.root  = p_tree->root;
+	left.bh    = rbt_black_height( p_tree->root );
+	right.root = p_other->root;
+	right.bh   = rbt_black_height( p_other->root );
+	size       = p_tree->size + p_other->size;
+
+	rbt_set_root( p_tree, rbt_join2( p_tree, left, right ), size );
+	rbt_set_root( p_other, rbt_part_empty( ), 0 );
+	return true;
+}
+
+bool lc_rbtree_serialize( lc_rbtree_t* p_tree, size_t element_size, FILE *file )
+{
+	bool result = true;
+	size_t count;
+	lc_rbtree_iterator_t itr;
+
+	assert( p_tree );
+
+	if( !p_tree )
+	{
+		result = false;
+		goto done;
+	}
+
+	count = lc_rbtree_size(p_tree);
+	if( fwrite( &count, sizeof(size_t), 1, file ) != 1 )
+	{
+		result = false;
+		goto done;
+	}
+
+
+	for( itr = lc_rbtree_begin( p_tree );
+	     itr != lc_rbtree_end( ) && !ferror(file);
+	     itr = lc_rbtree_next( itr ) )
+	{
+		if( fwrite( itr->data, element_size, 1, file ) != 1 )
+		{
+			result = false;
+			goto done;
+		}
+	}
+
+done:
+	return result;
+}
+
+/*
+ * Bytes from the current position to the end of the file, if the file
+ * can seek.
+ */
+static bool rbt_file_remaining( FILE *file, size_t *p_remaining )
+{
+	long position = ftell( file );
+	long end;
+
+	if( position < 0 || fseek( file, 0, SEEK_END ) != 0 )
+	{
+		return false;
+	}
+
+	end = ftell( file );
+
+	if( fseek( file, position, SEEK_SET ) != 0 || end < position )
+	{
+		return false;
+	}
+
+	*p_remaining = (size_t) (end - position);
+	return true;
+}
+
+bool lc_rbtree_unserialize( lc_rbtree_t* p_tree, size_t element_size, FILE *file )
+{
+	bool result = true;
+	size_t count = 0;
+	size_t read = 0;
+	size_t remaining;
+	size_t i;
+	void **elements = NULL;
+
+	assert( p_tree );
+
+	if( !p_tree )
+	{
+		result = false;
+		goto done;
+	}
+
+	if( fread( &count, sizeof(size_t), 1, file ) != 1 )
+	{
+		result = false;
+		goto done;
+	}
+
+	if( count == 0 )
+	{
+		goto done;
+	}
+
+	if( rbt_file_remaining( file, &remaining ) )
+	{
+		/* The count comes from the file, so it is checked against the
+		 * file before anything is allocated for it. */
+		if( element_size == 0 || count > remaining / element_size )
+		{
+			result = false;
+			goto done;
+		}
+
+		/* Serialized elements are in order so they can be bulk loaded.
+		 * Elements and this scratch array come from the legacy
+		 * callbacks, not the node allocator, which may only hand out
+		 * nodes. */
+		elements = count <= SIZE_MAX / sizeof(void*) ? (void **) p_tree->_alloc( count * sizeof(void*) ) : NULL;
+
+		if( !elements )
+		{
+			result = false;
+			goto done;
+		}
+	}
+
+	/* Without a size to check the count against, as with a pipe, the
+	 * elements are inserted as they are read. */
+	while( read < count && feof(file) == 0 )
+	{
+		void *p_data = p_tree->_alloc( element_size );
+
+		if( fread( p_data, element_size, 1, file ) != 1 )
+		{
+			p_tree->_free( p_data );
+
+			result = false;
+			break;
+		}
+
+		if( elements )
+		{
+			elements[ read ] = p_data;
+		}
+		else
+		{
+			lc_rbtree_insert( p_tree, p_data );
+		}
+
+		read++;
+	}
+
+	if( elements )
+	{
+		if( !lc_rbtree_build_sorted( p_tree, elements, read ) )
+		{
+			for( i = 0; i < read; i++ )
+			{
+				lc_rbtree_insert( p_tree, elements[ i ] );
+			}
+		}
+
+		p_tree->_free( elements );
+	}
+
+done:
+	return result;
+}
+
+
+void lc_rbtree_alloc_set( lc_rbtree_t* p_tree, lc_alloc_fxn_t alloc )
+{
+	assert( p_tree );
+	assert( alloc );
+	p_tree->_alloc = alloc;
+}
+
+void lc_rbtree_free_set( lc_rbtree_t* p_tree, lc_free_fxn_t free )
+{
+	assert( p_tree );
+	assert( free );
+	p_tree->_free = free;
+}
+
+void lc_rbtree_threads_set( lc_rbtree_t* p_tree, size_t threads )
+{
+	assert( p_tree );
+	p_tree->_threads = threads > 0 ? threads : 1;
+}
+
+static void rbt_augment_subtree( const lc_rbtree_t* p_tree, lc_rbnode_t *t )
+{
+	if( t != &RBNIL )
+	{
+		rbt_augment_subtree( p_tree, t->left );
+		rbt_augment_subtree( p_tree, t->right );
+		p_tree->_augment( t, p_tree->_augment_data );
+	}
+}
+
+void lc_rbtree_augment_set( lc_rbtree_t* p_tree, lc_rbtree_augment_fxn_t augment, void *user_data )
+{
+	assert( p_tree );
+	p_tree->_augment      = augment;
+	p_tree->_augment_data = user_data;
+
+	if( augment )
+	{
+		rbt_augment_subtree( p_tree, p_tree->root );
+	}
+}
+
+
+#ifdef LC_RBTREE_DEBUG
+static bool lc_rbnode_verify_tree  ( lc_rbtree_t* p_tree, lc_rbnode_t *t );
+static void padding             ( char ch, int n );
+static void structure           ( const lc_rbnode_t *root, int level );
+
+bool lc_rbtree_verify_tree( lc_rbtree_t* p_tree )
+{
+	assert( p_tree );
+
+	/* check if root is black... */
+	if( rbt_is_red( p_tree->root ) )
+	{
+		return false;
+	}
+
+	return lc_rbnode_verify_tree( p_tree, p_tree->root );
+}
+
+bool lc_rbnode_verify_tree( lc_rbtree_t* p_tree, lc_rbnode_t *t )
+{
+	assert( p_tree );
+
+	if( t == &RBNIL )
+	{
+		return true;
+	}
+
+	if( rbt_is_red( t ) )
+	{
+		if( rbt_is_red( t->left ) || rbt_is_red( t->right ) )
+		{
+			return false;
+		}
+	}
+
+	#ifdef LC_RBTREE_ORDER_STATISTICS
+	if( t->count != t->left->count + t->right->count + 1 )
+	{
+		return false;
+	}
+	#endif
 
 	return lc_rbnode_verify_tree( p_tree, t->left ) &&
 	       lc_rbnode_verify_tree( p_tree, t->right );
@@ -803,7 +1953,7 @@ inline void structure( const lc_rbnode_t *root, int level )
 		structure( root->right, level + 1 );
 		padding( '\t', level );
 		printf( "%d-", *( (int *) root->data ) );
-		printf( "%c\n", root->is_red ? 'R' : 'B' );
+		printf( "%c\n", rbt_is_red( root ) ? 'R' : 'B' );
 		structure( root->left, level + 1 );
 	}
 }
@@ -36,24 +36,54 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
 #include <stdbool.h>
 //#include "libcollections-config.h"
 #include "alloc.h"
 
 typedef int     (*lc_rbtree_compare_fxn_t) ( const void *p_data_left, const void *p_data_right );
 typedef bool    (*lc_rbtree_element_fxn_t) ( void *p_data );
+/* Called for each element of a range; return false to stop early. */
+typedef bool    (*lc_rbtree_range_fxn_t)   ( void *p_data, void *user_data );
+
+struct lc_rbnode;
+/* Recompute a node's augmented data from its children; see lc_rbtree_augment_set(). */
+typedef void    (*lc_rbtree_augment_fxn_t) ( struct lc_rbnode *p_node, void *user_data );
 
 /**
  * A node in the red-black tree.
+ *
+ * With LC_RBTREE_COMPACT_NODES the color is kept in the low bit of the
+ * parent pointer, which saves a word per node. Like
+ * LC_RBTREE_ORDER_STATISTICS, it changes the node layout and must be
+ * defined the same way for the library and its users. Use
+ * lc_rbnode_parent() and lc_rbnode_is_red() to read either layout.
  */
 typedef struct lc_rbnode {
+#ifdef LC_RBTREE_COMPACT_NODES
+	uintptr_t parent_color; /* parent pointer; the low bit is set when red */
+#else
 	struct lc_rbnode *parent;
+#endif
 	struct lc_rbnode *left;
 	struct lc_rbnode *right;
+#ifndef LC_RBTREE_COMPACT_NODES
 	bool   is_red;
+#endif
 	void *data;
+#ifdef LC_RBTREE_ORDER_STATISTICS
+	size_t count; /* number of nodes in this subtree */
+#endif
 } lc_rbnode_t;
 
+#ifdef LC_RBTREE_COMPACT_NODES
+#define lc_rbnode_parent( p_node )   ((lc_rbnode_t *) ((p_node)->parent_color & ~(uintptr_t) 1))
+#define lc_rbnode_is_red( p_node )   ((bool) ((p_node)->parent_color & 1))
+#else
+#define lc_rbnode_parent( p_node )   ((p_node)->parent)
+#define lc_rbnode_is_red( p_node )   ((p_node)->is_red)
+#endif
+
 #ifdef LC_EXTERN_RBNIL
 extern lc_rbnode RBNIL;
 #endif
@@ -69,6 +99,18 @@ typedef struct lc_rbtree {
 
 	lc_alloc_fxn_t  _alloc;
 	lc_free_fxn_t   _free;
+	lc_allocator_t  _allocator;
+
+	/* Nodes allocated in one block by lc_rbtree_build_sorted(). */
+	lc_rbnode_t* _block;
+	size_t    _block_count;
+
+	/* Threads used by the set operations; see lc_rbtree_threads_set(). */
+	size_t    _threads;
+
+	/* Keeps per-subtree data up to date; see lc_rbtree_augment_set(). */
+	lc_rbtree_augment_fxn_t _augment;
+	void*     _augment_data;
 } lc_rbtree_t;
 
 /**
@@ -79,6 +121,7 @@ typedef lc_rbnode_t* lc_rbtree_iterator_t;
 
 lc_rbtree_t* lc_rbtree_create_ex   ( lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
 void      lc_rbtree_create      ( lc_rbtree_t* p_tree, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+void      lc_rbtree_create_with_allocator ( lc_rbtree_t* p_tree, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, const lc_allocator_t* allocator );
 void      lc_rbtree_destroy     ( lc_rbtree_t* p_tree );
 void      lc_rbtree_copy        ( lc_rbtree_t const *p_srcTree, lc_rbtree_t* p_dstTree );
 bool      lc_rbtree_insert      ( lc_rbtree_t* p_tree, const void *data );
@@ -87,9 +130,62 @@ bool      lc_rbtree_search      ( const lc_rbtree_t* p_tree, const void *data );
 void      lc_rbtree_clear       ( lc_rbtree_t* p_tree );
 bool      lc_rbtree_serialize   ( lc_rbtree_t* p_tree, size_t element_size, FILE *file );
 bool      lc_rbtree_unserialize ( lc_rbtree_t* p_tree, size_t element_size, FILE *file );
+/*
+ * Build a balanced tree from count elements that are already in
+ * ascending order, in O(n) and with one allocation for all of the nodes.
+ * The tree must be empty. Returns false if the elements are not sorted
+ * or memory could not be allocated.
+ *
+ * Removing an element does not give its node back: the block stays
+ * allocated at its full size until the tree is empty again, or until a
+ * split, join or union copies the remaining nodes out of it. A tree with
+ * an lc_allocator_t gets its nodes from the allocator one at a time
+ * instead, since an allocator such as a pool may not hand out a block.
+ */
+bool      lc_rbtree_build_sorted ( lc_rbtree_t* p_tree, void *const *data, size_t count );
+
+/*
+ * Join based bulk operations. Elements move from p_other (which is left
+ * empty) into p_tree; no element is copied. Both trees must use the same
+ * compare function and, when elements move between them, the same
+ * allocator. The set operations treat each tree as a set: an element of
+ * p_other equal to one in p_tree is destroyed and p_tree's is kept.
+ */
+/*
+ * Move the elements that are not less than data to p_greater, which must
+ * be empty. This is O(log n) with LC_RBTREE_ORDER_STATISTICS and otherwise
+ * also counts the k elements moved, O(log n + k).
+ */
+bool      lc_rbtree_split        ( lc_rbtree_t* p_tree, const void *data, lc_rbtree_t* p_greater );
+/** Append p_other, whose elements must not be less than any in p_tree. */
+bool      lc_rbtree_join         ( lc_rbtree_t* p_tree, lc_rbtree_t* p_other );
+/*
+ * Keep the elements in either tree (union), in both (intersection) or in
+ * p_tree but not p_other (difference). Each takes O(m log(n/m + 1)) work
+ * where m is the size of the smaller tree and n of the larger.
+ */
+bool      lc_rbtree_union        ( lc_rbtree_t* p_tree, lc_rbtree_t* p_other );
+bool      lc_rbtree_intersection ( lc_rbtree_t* p_tree, lc_rbtree_t* p_other );
+bool      lc_rbtree_difference   ( lc_rbtree_t* p_tree, lc_rbtree_t* p_other );
 
 void    lc_rbtree_alloc_set   ( lc_rbtree_t* p_tree, lc_alloc_fxn_t alloc );
 void    lc_rbtree_free_set    ( lc_rbtree_t* p_tree, lc_free_fxn_t free );
+/*
+ * Let the set operations on p_tree run disjoint subtrees on up to threads
+ * threads (the default is 1). The compare and destroy callbacks and the
+ * allocator must then be thread safe.
+ */
+void    lc_rbtree_threads_set ( lc_rbtree_t* p_tree, size_t threads );
+/*
+ * Augment the tree with data computed from each subtree, such as the
+ * largest endpoint below a node of an interval tree. augment is called
+ * on a node whenever its children or its element change, after it has
+ * been called on the children, so it only needs to combine the node's
+ * element with its children's (lc_rbtree_end() for a missing child).
+ * The result is kept in the element. Setting it computes every node
+ * once; NULL turns it off.
+ */
+void    lc_rbtree_augment_set ( lc_rbtree_t* p_tree, lc_rbtree_augment_fxn_t augment, void *user_data );
 
 lc_rbnode_t* lc_rbnode_minimum     ( lc_rbnode_t *t );
 lc_rbnode_t* lc_rbnode_maximum     ( lc_rbnode_t *t );
@@ -98,6 +194,30 @@ lc_rbnode_t* lc_rbnode_predecessor ( const lc_rbnode_t *t );
 
 lc_rbtree_iterator_t lc_rbtree_begin ( const lc_rbtree_t* p_tree );
 lc_rbtree_iterator_t lc_rbtree_end   ( );
+/** The first element that is not less than data, or lc_rbtree_end(). */
+lc_rbtree_iterator_t lc_rbtree_lower_bound ( const lc_rbtree_t* p_tree, const void *data );
+/** The first element that is greater than data, or lc_rbtree_end(). */
+lc_rbtree_iterator_t lc_rbtree_upper_bound ( const lc_rbtree_t* p_tree, const void *data );
+/** The elements equal to data are [*p_first, *p_last). */
+void                 lc_rbtree_equal_range ( const lc_rbtree_t* p_tree, const void *data, lc_rbtree_iterator_t* p_first, lc_rbtree_iterator_t* p_last );
+/**
+ * Visit the elements with low <= element < high in order, in
+ * O(log n + k). A NULL low or high leaves that end of the range open.
+ * Returns the number of elements visited.
+ */
+size_t               lc_rbtree_range       ( const lc_rbtree_t* p_tree, const void *low, const void *high, lc_rbtree_range_fxn_t visit, void *user_data );
+
+#ifdef LC_RBTREE_ORDER_STATISTICS
+/*
+ * Order statistics. Every node keeps the size of its subtree so these
+ * run in O(log n). LC_RBTREE_ORDER_STATISTICS changes the node layout and
+ * must be defined the same way for the library and its users.
+ */
+/** The element at zero-based position k in order, or lc_rbtree_end(). */
+lc_rbtree_iterator_t lc_rbtree_select      ( const lc_rbtree_t* p_tree, size_t k );
+/** The number of elements less than data (its position if present). */
+size_t               lc_rbtree_rank        ( const lc_rbtree_t* p_tree, const void *data );
+#endif
 
 #ifdef LC_RBTREE_DEBUG
 bool    lc_rbtree_verify_tree ( lc_rbtree_t* p_tree );
@@ -0,0 +1,830 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "slab-rbtree.h"
+
+#define SRBT_NIL                 ((uint32_t) 0)
+#define SRBT_MAX_CAPACITY        ((size_t) UINT32_MAX)
+#define SRBT_HEADER_SIZE         sizeof(lc_slab_rbtree_header_t)
+
+#define srbt_header( p_tree )    lc_slab_rbtree_header( p_tree )
+#define srbt_node( p_tree, i )   ((lc_slab_rbnode_t *) ((p_tree)->slab + SRBT_HEADER_SIZE + (size_t) (i) * (p_tree)->stride))
+#define srbt_element( p_tree, i ) lc_slab_rbtree_element( p_tree, i )
+
+/* Shorthands for the links of node i of p_tree. */
+#define PARENT( i )   (srbt_node( p_tree, i )->parent)
+#define LEFT( i )     (srbt_node( p_tree, i )->left)
+#define RIGHT( i )    (srbt_node( p_tree, i )->right)
+#define IS_RED( i )   (srbt_node( p_tree, i )->is_red)
+
+/* Elements start 8 byte aligned, right after their node. */
+#define srbt_stride( element_size ) \
+	(sizeof(lc_slab_rbnode_t) + (((element_size) + 7) & ~(size_t) 7))
+
+static inline size_t srbt_slab_size( const lc_slab_rbtree_t* p_tree, size_t capacity )
+{
+	return SRBT_HEADER_SIZE + capacity * p_tree->stride;
+}
+
+static void* srbt_realloc( lc_slab_rbtree_t* p_tree, void *data, size_t old_size, size_t new_size )
+{
+	void* result;
+
+	if( lc_allocator_is_set( &p_tree->allocator ) )
+	{
+		return p_tree->allocator.realloc( p_tree->allocator.ctx, data, old_size, new_size );
+	}
+
+	result = p_tree->alloc( new_size );
+
+	if( result && data )
+	{
+		memcpy( result, data, old_size < new_size ? old_size : new_size );
+		p_tree->free( data );
+	}
+
+	return result;
+}
+
+static bool srbt_resize( lc_slab_rbtree_t* p_tree, size_t capacity )
+{
+	uint8_t* slab;
+
+	if( capacity > SRBT_MAX_CAPACITY || capacity > (SIZE_MAX - SRBT_HEADER_SIZE) / p_tree->stride )
+	{
+		return false;
+	}
+
+	slab = (uint8_t*) srbt_realloc( p_tree, p_tree->slab, p_tree->slab ? srbt_slab_size( p_tree, p_tree->capacity ) : 0, srbt_slab_size( p_tree, capacity ) );
+
+	if( !slab )
+	{
+		return false;
+	}
+
+	p_tree->slab     = slab;
+	p_tree->capacity = capacity;
+	return true;
+}
+
+static void srbt_reset( lc_slab_rbtree_t* p_tree )
+{
+	lc_slab_rbtree_header_t* header = srbt_header( p_tree );
+	lc_slab_rbnode_t* nil = srbt_node( p_tree, SRBT_NIL );
+
+	memset( header, 0, SRBT_HEADER_SIZE );
+	header->magic        = LC_SLAB_RBTREE_MAGIC;
+	header->element_size = (uint32_t) p_tree->element_size;
+	header->root         = SRBT_NIL;
+	header->used         = 1;
+	header->free_list    = SRBT_NIL;
+
+	memset( nil, 0, p_tree->stride );
+}
+
+/* Take a node from the free list or the end of the slab; 0 if full. */
+static uint32_t srbt_node_alloc( lc_slab_rbtree_t* p_tree )
+{
+	lc_slab_rbtree_header_t* header = srbt_header( p_tree );
+	uint32_t i = header->free_list;
+
+	if( i != SRBT_NIL )
+	{
+		header->free_list = RIGHT( i );
+		return i;
+	}
+
+	if( header->used == p_tree->capacity )
+	{
+		/* Double, but no further than the largest index. */
+		size_t capacity = p_tree->capacity <= SRBT_MAX_CAPACITY / 2 ? p_tree->capacity * 2 : SRBT_MAX_CAPACITY;
+
+		if( capacity == p_tree->capacity || !srbt_resize( p_tree, capacity ) )
+		{
+			return SRBT_NIL;
+		}
+		header = srbt_header( p_tree );
+	}
+
+	return header->used++;
+}
+
+static inline void srbt_node_free( lc_slab_rbtree_t* p_tree, uint32_t i )
+{
+	lc_slab_rbtree_header_t* header = srbt_header( p_tree );
+
+	RIGHT( i ) = header->free_list;
+	header->free_list = i;
+}
+
+static inline void srbt_left_rotate( lc_slab_rbtree_t* p_tree, uint32_t x )
+{
+	uint32_t y = RIGHT( x );
+
+	RIGHT( x ) = LEFT( y );
+
+	if( LEFT( y ) != SRBT_NIL )
+	{
+		PARENT( LEFT( y ) ) = x;
+	}
+
+	PARENT( y ) = PARENT( x );
+
+	if( PARENT( x ) == SRBT_NIL )
+	{
+		srbt_header( p_tree )->root = y;
+	}
+	else if( x == LEFT( PARENT( x ) ) )
+	{
+		LEFT( PARENT( x ) ) = y;
+	}
+	else
+	{
+		RIGHT( PARENT( x ) ) = y;
+	}
+
+	LEFT( y )   = x;
+	PARENT( x ) = y;
+}
+
+static inline void srbt_right_rotate( lc_slab_rbtree_t* p_tree, uint32_t x )
+{
+	uint32_t y = LEFT( x );
+
+	LEFT( x ) = RIGHT( y );
+
+	if( RIGHT( y ) != SRBT_NIL )
+	{
+		PARENT( RIGHT( y ) ) = x;
+	}
+
+	PARENT( y ) = PARENT( x );
+
+	if( PARENT( x ) == SRBT_NIL )
+	{
+		srbt_header( p_tree )->root = y;
+	}
+	else if( x == RIGHT( PARENT( x ) ) )
+	{
+		RIGHT( PARENT( x ) ) = y;
+	}
+	else
+	{
+		LEFT( PARENT( x ) ) = y;
+	}
+
+	RIGHT( y )  = x;
+	PARENT( x ) = y;
+}
+
+static void srbt_insert_fixup( lc_slab_rbtree_t* p_tree, uint32_t t )
+{
+	while( IS_RED( PARENT( t ) ) )
+	{
+		uint32_t parent      = PARENT( t );
+		uint32_t grandparent = PARENT( parent );
+
+		if( parent == LEFT( grandparent ) )
+		{
+			uint32_t uncle = RIGHT( grandparent );
+
+			if( IS_RED( uncle ) )
+			{
+				IS_RED( parent )      = false;
+				IS_RED( uncle )       = false;
+				IS_RED( grandparent ) = true;
+				t = grandparent;
+			}
+			else
+			{
+				if( t == RIGHT( parent ) )
+				{
+					t = parent;
+					srbt_left_rotate( p_tree, t );
+				}
+				IS_RED( PARENT( t ) )           = false;
+				IS_RED( PARENT( PARENT( t ) ) ) = true;
+				srbt_right_rotate( p_tree, PARENT( PARENT( t ) ) );
+			}
+		}
+		else
+		{
+			uint32_t uncle = LEFT( grandparent );
+
+			if( IS_RED( uncle ) )
+			{
+				IS_RED( parent )      = false;
+				IS_RED( uncle )       = false;
+				IS_RED( grandparent ) = true;
+				t = grandparent;
+			}
+			else
+			{
+				if( t == LEFT( parent ) )
+				{
+					t = parent;
+					srbt_right_rotate( p_tree, t );
+				}
+				IS_RED( PARENT( t ) )           = false;
+				IS_RED( PARENT( PARENT( t ) ) ) = true;
+				srbt_left_rotate( p_tree, PARENT( PARENT( t ) ) );
+			}
+		}
+	}
+
+	IS_RED( srbt_header( p_tree )->root ) = false;
+}
+
+static void srbt_delete_fixup( lc_slab_rbtree_t* p_tree, uint32_t t )
+{
+	while( t != srbt_header( p_tree )->root && !IS_RED( t ) )
+	{
+		uint32_t w;
+
+		if( t == LEFT( PARENT( t ) ) )
+		{
+			w = RIGHT( PARENT( t ) );
+
+			if( IS_RED( w ) )
+			{
+				IS_RED( w )         = false;
+				IS_RED( PARENT( t ) ) = true;
+				srbt_left_rotate( p_tree, PARENT( t ) );
+				w = RIGHT( PARENT( t ) );
+			}
+
+			if( !IS_RED( LEFT( w ) ) && !IS_RED( RIGHT( w ) ) )
+			{
+				IS_RED( w ) = true;
+				t = PARENT( t );
+			}
+			else
+			{
+				if( !IS_RED( RIGHT( w ) ) )
+				{
+					IS_RED( LEFT( w ) ) = false;
+					IS_RED( w )         = true;
+					srbt_right_rotate( p_tree, w );
+					w = RIGHT( PARENT( t ) );
+				}
+
+				IS_RED( w )           = IS_RED( PARENT( t ) );
+				IS_RED( PARENT( t ) ) = false;
+				IS_RED( RIGHT( w ) )  = false;
+				srbt_left_rotate( p_tree, PARENT( t ) );
+				t = srbt_header( p_tree )->root;
+			}
+		}
+		else
+		{
+			w = LEFT( PARENT( t ) );
+
+			if( IS_RED( w ) )
+			{
+				IS_RED( w )           = false;
+				IS_RED( PARENT( t ) ) = true;
+				srbt_right_rotate( p_tree, PARENT( t ) );
+				w = LEFT( PARENT( t ) );
+			}
+
+			if( !IS_RED( RIGHT( w ) ) && !IS_RED( LEFT( w ) ) )
+			{
+				IS_RED( w ) = true;
+				t = PARENT( t );
+			}
+			else
+			{
+				if( !IS_RED( LEFT( w ) ) )
+				{
+					IS_RED( RIGHT( w ) ) = false;
+					IS_RED( w )          = true;
+					srbt_left_rotate( p_tree, w );
+					w = LEFT( PARENT( t ) );
+				}
+
+				IS_RED( w )           = IS_RED( PARENT( t ) );
+				IS_RED( PARENT( t ) ) = false;
+				IS_RED( LEFT( w ) )   = false;
+				srbt_right_rotate( p_tree, PARENT( t ) );
+				t = srbt_header( p_tree )->root;
+			}
+		}
+	}
+
+	IS_RED( t ) = false;
+}
+
+static inline uint32_t srbt_minimum( const lc_slab_rbtree_t* p_tree, uint32_t t )
+{
+	while( LEFT( t ) != SRBT_NIL ) { t = LEFT( t ); }
+	return t;
+}
+
+static inline uint32_t srbt_maximum( const lc_slab_rbtree_t* p_tree, uint32_t t )
+{
+	while( RIGHT( t ) != SRBT_NIL ) { t = RIGHT( t ); }
+	return t;
+}
+
+static uint32_t srbt_search( const lc_slab_rbtree_t* p_tree, const void *key )
+{
+	uint32_t t = srbt_header( p_tree )->root;
+
+	while( t != SRBT_NIL )
+	{
+		int c = p_tree->compare( key, srbt_element( p_tree, t ) );
+
+		if( c == 0 )
+		{
+			break;
+		}
+
+		t = c < 0 ? LEFT( t ) : RIGHT( t );
+	}
+
+	return t;
+}
+
+
+bool lc_slab_rbtree_create( lc_slab_rbtree_t* p_tree, size_t element_size, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
+{
+	assert( p_tree );
+	assert( element_size > 0 && element_size <= UINT32_MAX );
+	assert( compare );
+	assert( alloc );
+	assert( free );
+
+	p_tree->compare = compare;
+	p_tree->destroy = destroy;
+	p_tree->alloc   = alloc;
+	p_tree->free    = free;
+	lc_allocator_init( &p_tree->allocator, NULL );
+
+	p_tree->slab         = NULL;
+	p_tree->capacity     = 0;
+	p_tree->element_size = element_size;
+	p_tree->stride       = srbt_stride( element_size );
+
+	if( !srbt_resize( p_tree, LC_SLAB_RBTREE_MIN_CAPACITY ) )
+	{
+		return false;
+	}
+
+	srbt_reset( p_tree );
+	return true;
+}
+
+bool lc_slab_rbtree_create_with_allocator( lc_slab_rbtree_t* p_tree, size_t element_size, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	assert( p_tree );
+	assert( element_size > 0 && element_size <= UINT32_MAX );
+	assert( compare );
+
+	p_tree->compare = compare;
+	p_tree->destroy = destroy;
+	p_tree->alloc   = malloc;
+	p_tree->free    = free;
+	lc_allocator_init( &p_tree->allocator, allocator );
+
+	p_tree->slab         = NULL;
+	p_tree->capacity     = 0;
+	p_tree->element_size = element_size;
+	p_tree->stride       = srbt_stride( element_size );
+
+	if( !srbt_resize( p_tree, LC_SLAB_RBTREE_MIN_CAPACITY ) )
+	{
+		return false;
+	}
+
+	srbt_reset( p_tree );
+	return true;
+}
+
+void lc_slab_rbtree_destroy( lc_slab_rbtree_t* p_tree )
+{
+	assert( p_tree );
+
+	if( p_tree->slab )
+	{
+		lc_slab_rbtree_clear( p_tree );
+		lc_allocator_free( &p_tree->allocator, p_tree->free, p_tree->slab );
+		p_tree->slab     = NULL;
+		p_tree->capacity = 0;
+	}
+}
+
+bool lc_slab_rbtree_insert( lc_slab_rbtree_t* p_tree, const void *element )
+{
+	uint32_t x;
+	uint32_t y = SRBT_NIL;
+	uint32_t z;
+	int c = 0;
+
+	assert( p_tree );
+
+	/* Find where to insert the new node--y points the parent. */
+	for( x = srbt_header( p_tree )->root; x != SRBT_NIL; x = c < 0 ? LEFT( x ) : RIGHT( x ) )
+	{
+		y = x;
+		c = p_tree->compare( element, srbt_element( p_tree, x ) );
+
+		if( c == 0 )
+		{
+			return false;
+		}
+	}
+
+	/* This may move the slab; only indices are kept across it. */
+	z = srbt_node_alloc( p_tree );
+
+	if( z == SRBT_NIL )
+	{
+		return false;
+	}
+
+	PARENT( z ) = y;
+	LEFT( z )   = SRBT_NIL;
+	RIGHT( z )  = SRBT_NIL;
+	IS_RED( z ) = true;
+	memcpy( srbt_element( p_tree, z ), element, p_tree->element_size );
+
+	if( y == SRBT_NIL )
+	{
+		srbt_header( p_tree )->root = z;
+	}
+	else if( c < 0 )
+	{
+		LEFT( y ) = z;
+	}
+	else
+	{
+		RIGHT( y ) = z;
+	}
+
+	srbt_insert_fixup( p_tree, z );
+	srbt_header( p_tree )->size++;
+	return true;
+}
+
+bool lc_slab_rbtree_remove( lc_slab_rbtree_t* p_tree, const void *key )
+{
+	uint32_t t;
+	uint32_t x;
+	uint32_t y;
+	bool y_is_red;
+
+	assert( p_tree );
+	t = srbt_search( p_tree, key );
+
+	if( t == SRBT_NIL )
+	{
+		return false;
+	}
+
+	y = LEFT( t ) == SRBT_NIL || RIGHT( t ) == SRBT_NIL ? t : srbt_minimum( p_tree, RIGHT( t ) );
+	x = LEFT( y ) != SRBT_NIL ? LEFT( y ) : RIGHT( y );
+
+	PARENT( x ) = PARENT( y );
+
+	if( PARENT( y ) == SRBT_NIL )
+	{
+		srbt_header( p_tree )->root = x;
+	}
+	else if( y == LEFT( PARENT( y ) ) )
+	{
+		LEFT( PARENT( y ) ) = x;
+	}
+	else
+	{
+		RIGHT( PARENT( y ) ) = x;
+	}
+
+	y_is_red = IS_RED( y );
+
+	if( y != t )
+	{
+		/* y's node takes t's place in the tree rather than copying its
+		 * element into t, so that no other element moves. */
+		if( PARENT( x ) == t )
+		{
+			PARENT( x ) = y;
+		}
+
+		PARENT( y ) = PARENT( t );
+		LEFT( y )   = LEFT( t );
+		RIGHT( y )  = RIGHT( t );
+		IS_RED( y ) = IS_RED( t );
+
+		if( PARENT( t ) == SRBT_NIL )
+		{
+			srbt_header( p_tree )->root = y;
+		}
+		else if( t == LEFT( PARENT( t ) ) )
+		{
+			LEFT( PARENT( t ) ) = y;
+		}
+		else
+		{
+			RIGHT( PARENT( t ) ) = y;
+		}
+
+		if( LEFT( y ) != SRBT_NIL )
+		{
+			PARENT( LEFT( y ) ) = y;
+		}
+		if( RIGHT( y ) != SRBT_NIL )
+		{
+			PARENT( RIGHT( y ) ) = y;
+		}
+	}
+
+	if( p_tree->destroy )
+	{
+		p_tree->destroy( srbt_element( p_tree, t ) );
+	}
+
+	srbt_node_free( p_tree, t );
+
+	if( !y_is_red )
+	{
+		srbt_delete_fixup( p_tree, x );
+	}
+
+	srbt_header( p_tree )->size--;
+	return true;
+}
+
+void* lc_slab_rbtree_find( const lc_slab_rbtree_t* p_tree, const void *key )
+{
+	uint32_t t;
+
+	assert( p_tree );
+	t = srbt_search( p_tree, key );
+
+	return t != SRBT_NIL ? srbt_element( p_tree, t ) : NULL;
+}
+
+void lc_slab_rbtree_clear( lc_slab_rbtree_t* p_tree )
+{
+	assert( p_tree );
+
+	if( p_tree->destroy )
+	{
+		lc_slab_rbtree_iterator_t it;
+
+		for( it = lc_slab_rbtree_begin( p_tree ); it != lc_slab_rbtree_end( ); it = lc_slab_rbtree_next( p_tree, it ) )
+		{
+			p_tree->destroy( srbt_element( p_tree, it ) );
+		}
+	}
+
+	srbt_reset( p_tree );
+}
+
+bool lc_slab_rbtree_reserve( lc_slab_rbtree_t* p_tree, size_t count )
+{
+	assert( p_tree );
+
+	/* One more for the nil node. */
+	if( count >= SRBT_MAX_CAPACITY )
+	{
+		return false;
+	}
+
+	return count + 1 <= p_tree->capacity || srbt_resize( p_tree, count + 1 );
+}
+
+const void* lc_slab_rbtree_image( const lc_slab_rbtree_t* p_tree, size_t *p_size )
+{
+	assert( p_tree );
+	assert( p_size );
+
+	*p_size = srbt_slab_size( p_tree, srbt_header( p_tree )->used );
+	return p_tree->slab;
+}
+
+static bool srbt_header_valid( const lc_slab_rbtree_t* p_tree, const lc_slab_rbtree_header_t* header )
+{
+	return header->magic == LC_SLAB_RBTREE_MAGIC &&
+	       header->element_size == p_tree->element_size &&
+	       header->used >= 1 &&
+	       header->used <= (SIZE_MAX - SRBT_HEADER_SIZE) / p_tree->stride &&
+	       header->size < header->used &&
+	       header->root < header->used &&
+	       header->free_list < header->used;
+}
+
+/*
+ * Check that every link of an image, whose header is valid, stays inside
+ * the image and that the free list ends. The image may be unaligned.
+ */
+static bool srbt_nodes_valid( const lc_slab_rbtree_t* p_tree, const uint8_t* image )
+{
+	const lc_slab_rbtree_header_t* header = (const lc_slab_rbtree_header_t*) image;
+	uint32_t used;
+	uint32_t free_list;
+	uint32_t steps;
+	uint32_t i;
+	lc_slab_rbnode_t node;
+
+	memcpy( &used, &header->used, sizeof(used) );
+	memcpy( &free_list, &header->free_list, sizeof(free_list) );
+
+	for( i = 0; i < used; i++ )
+	{
+		memcpy( &node, image + SRBT_HEADER_SIZE + (size_t) i * p_tree->stride, sizeof(node) );
+
+		if( node.parent >= used || node.left >= used || node.right >= used )
+		{
+			return false;
+		}
+	}
+
+	for( steps = 0; free_list != SRBT_NIL; steps++ )
+	{
+		if( steps == used )
+		{
+			return false; /* a cycle */
+		}
+
+		memcpy( &node, image + SRBT_HEADER_SIZE + (size_t) free_list * p_tree->stride, sizeof(node) );
+		free_list = node.right;
+	}
+
+	return true;
+}
+
+bool lc_slab_rbtree_load( lc_slab_rbtree_t* p_tree, const void *image, size_t size )
+{
+	lc_slab_rbtree_header_t header;
+
+	assert( p_tree );
+	assert( image );
+
+	if( size < SRBT_HEADER_SIZE )
+	{
+		return false;
+	}
+
+	memcpy( &header, image, SRBT_HEADER_SIZE );
+
+	if( !srbt_header_valid( p_tree, &header ) || size < srbt_slab_size( p_tree, header.used ) ||
+	    !srbt_nodes_valid( p_tree, (const uint8_t*) image ) )
+	{
+		return false;
+	}
+
+	/* Grow before clearing so that a failure leaves the tree as it was. */
+	if( header.used > p_tree->capacity && !srbt_resize( p_tree, header.used ) )
+	{
+		return false;
+	}
+
+	lc_slab_rbtree_clear( p_tree );
+	memcpy( p_tree->slab, image, srbt_slab_size( p_tree, header.used ) );
+	return true;
+}
+
+bool lc_slab_rbtree_serialize( const lc_slab_rbtree_t* p_tree, FILE *file )
+{
+	size_t size;
+	const void* image;
+
+	assert( p_tree );
+	assert( file );
+
+	image = lc_slab_rbtree_image( p_tree, &size );
+	return fwrite( image, size, 1, file ) == 1;
+}
+
+bool lc_slab_rbtree_unserialize( lc_slab_rbtree_t* p_tree, FILE *file )
+{
+	lc_slab_rbtree_header_t header;
+	uint8_t* slab;
+
+	assert( p_tree );
+	assert( file );
+
+	if( fread( &header, SRBT_HEADER_SIZE, 1, file ) != 1 || !srbt_header_valid( p_tree, &header ) )
+	{
+		return false;
+	}
+
+	/* The nodes are read straight into a new slab, which replaces the
+	 * tree's only once it is known to be good. */
+	slab = (uint8_t*) lc_allocator_alloc( &p_tree->allocator, p_tree->alloc, srbt_slab_size( p_tree, header.used ) );
+
+	if( !slab )
+	{
+		return false;
+	}
+
+	memcpy( slab, &header, SRBT_HEADER_SIZE );
+
+	if( fread( slab + SRBT_HEADER_SIZE, p_tree->stride, header.used, file ) != header.used ||
+	    !srbt_nodes_valid( p_tree, slab ) )
+	{
+		lc_allocator_free( &p_tree->allocator, p_tree->free, slab );
+		return false;
+	}
+
+	lc_slab_rbtree_clear( p_tree );
+	lc_allocator_free( &p_tree->allocator, p_tree->free, p_tree->slab );
+	p_tree->slab     = slab;
+	p_tree->capacity = header.used;
+	return true;
+}
+
+lc_slab_rbtree_iterator_t lc_slab_rbtree_begin( const lc_slab_rbtree_t* p_tree )
+{
+	uint32_t root;
+
+	assert( p_tree );
+	root = srbt_header( p_tree )->root;
+
+	return root != SRBT_NIL ? srbt_minimum( p_tree, root ) : SRBT_NIL;
+}
+
+lc_slab_rbtree_iterator_t lc_slab_rbtree_next( const lc_slab_rbtree_t* p_tree, lc_slab_rbtree_iterator_t t )
+{
+	uint32_t y;
+
+	assert( p_tree );
+
+	if( RIGHT( t ) != SRBT_NIL )
+	{
+		return srbt_minimum( p_tree, RIGHT( t ) );
+	}
+
+	for( y = PARENT( t ); y != SRBT_NIL && t == RIGHT( y ); y = PARENT( y ) )
+	{
+		t = y;
+	}
+
+	return y;
+}
+
+lc_slab_rbtree_iterator_t lc_slab_rbtree_previous( const lc_slab_rbtree_t* p_tree, lc_slab_rbtree_iterator_t t )
+{
+	uint32_t y;
+
+	assert( p_tree );
+
+	if( LEFT( t ) != SRBT_NIL )
+	{
+		return srbt_maximum( p_tree, LEFT( t ) );
+	}
+
+	for( y = PARENT( t ); y != SRBT_NIL && t == LEFT( y ); y = PARENT( y ) )
+	{
+		t = y;
+	}
+
+	return y;
+}
+
+lc_slab_rbtree_iterator_t lc_slab_rbtree_lower_bound( const lc_slab_rbtree_t* p_tree, const void *key )
+{
+	uint32_t t;
+	uint32_t result = SRBT_NIL;
+
+	assert( p_tree );
+
+	for( t = srbt_header( p_tree )->root; t != SRBT_NIL; )
+	{
+		if( p_tree->compare( srbt_element( p_tree, t ), key ) < 0 )
+		{
+			t = RIGHT( t );
+		}
+		else
+		{
+			result = t;
+			t = LEFT( t );
+		}
+	}
+
+	return result;
+}
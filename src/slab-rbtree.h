@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_SLAB_RBTREE_H_
+#define _LC_SLAB_RBTREE_H_
+/**
+ * @file slab-rbtree.h
+ * @brief A red-black tree stored in one relocatable block of memory.
+ *
+ * The nodes live in a single growable slab and link to each other with
+ * 32-bit indices rather than pointers. Each element of element_size bytes
+ * is copied into its node. Index 0 is the black nil node. The slab begins
+ * with a small header (root, size, free list), so the slab by itself is
+ * the whole tree. It can be written out, memcpy()'d or mmap()'d as one
+ * block and loaded back without rebuilding anything, provided the
+ * elements hold no pointers. Images use the host's byte order.
+ *
+ * The compare and destroy callbacks are the ones used by lc_rbtree_t and
+ * get pointers to elements in the slab. The destroy callback may be NULL
+ * when elements own nothing. Element pointers and iterators into the slab
+ * are invalidated when an insert grows it. A remove only invalidates the
+ * ones to the removed element; the others stay where they are.
+ *
+ * @defgroup lc_slab_rbtree Slab Red-Black Tree
+ * @ingroup Collections
+ * @{
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "alloc.h"
+#include "rbtree.h"
+
+#define LC_SLAB_RBTREE_MAGIC        (0x42525342u) /* "BSRB" */
+
+#ifndef LC_SLAB_RBTREE_MIN_CAPACITY
+#define LC_SLAB_RBTREE_MIN_CAPACITY (16)
+#endif
+
+/**
+ * The start of every slab and of every image.
+ */
+typedef struct lc_slab_rbtree_header {
+	uint32_t magic;
+	uint32_t element_size;
+	uint32_t root;
+	uint32_t size;       /* elements in the tree */
+	uint32_t used;       /* nodes handed out, including nil */
+	uint32_t free_list;  /* removed nodes, linked through right */
+	uint32_t reserved[ 2 ];
+} lc_slab_rbtree_header_t;
+
+/**
+ * A node; the element follows it in the slab.
+ */
+typedef struct lc_slab_rbnode {
+	uint32_t parent;
+	uint32_t left;
+	uint32_t right;
+	uint32_t is_red;
+} lc_slab_rbnode_t;
+
+/**
+ * lc_slab_rbtree_t is a red-black tree collection object.
+ */
+typedef struct lc_slab_rbtree {
+	uint8_t* slab;
+	size_t   capacity;     /* nodes */
+	size_t   stride;       /* bytes per node and element */
+	size_t   element_size;
+
+	lc_rbtree_compare_fxn_t compare;
+	lc_rbtree_element_fxn_t destroy;
+
+	lc_alloc_fxn_t  alloc;
+	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
+} lc_slab_rbtree_t;
+
+/**
+ * A position in the tree: the index of a node. 0 is the end.
+ */
+typedef uint32_t lc_slab_rbtree_iterator_t;
+
+bool   lc_slab_rbtree_create  ( lc_slab_rbtree_t* p_tree, size_t element_size, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+/**
+ * Create a tree whose slab comes from an allocator. If allocator is
+ * NULL, malloc() and free() are used.
+ */
+bool   lc_slab_rbtree_create_with_allocator ( lc_slab_rbtree_t* p_tree, size_t element_size, lc_rbtree_element_fxn_t destroy, lc_rbtree_compare_fxn_t compare, const lc_allocator_t* allocator );
+void   lc_slab_rbtree_destroy ( lc_slab_rbtree_t* p_tree );
+/**
+ * Copy an element into the tree. Returns false if an equal element is
+ * already in the tree or the slab could not grow, including when it
+ * already holds the most nodes a 32-bit index can reach.
+ */
+bool   lc_slab_rbtree_insert  ( lc_slab_rbtree_t* p_tree, const void *element );
+bool   lc_slab_rbtree_remove  ( lc_slab_rbtree_t* p_tree, const void *key );
+/**
+ * The element equal to key, or NULL.
+ */
+void*  lc_slab_rbtree_find    ( const lc_slab_rbtree_t* p_tree, const void *key );
+/**
+ * Remove every element. The slab is kept.
+ */
+void   lc_slab_rbtree_clear   ( lc_slab_rbtree_t* p_tree );
+/**
+ * Grow the slab so that it holds at least count elements.
+ */
+bool   lc_slab_rbtree_reserve ( lc_slab_rbtree_t* p_tree, size_t count );
+
+/**
+ * The tree as one block of memory of *p_size bytes. It stays valid until
+ * the tree is changed.
+ */
+const void* lc_slab_rbtree_image ( const lc_slab_rbtree_t* p_tree, size_t *p_size );
+/**
+ * Replace the contents of the tree with an image from
+ * lc_slab_rbtree_image() with one copy. Returns false, leaving the tree
+ * as it was, if the image is not a tree of this element size or a link
+ * in it points outside of it. That is all that is checked: an image that
+ * did not come from lc_slab_rbtree_image() or lc_slab_rbtree_serialize()
+ * can still hold an unbalanced or cyclic tree.
+ */
+bool   lc_slab_rbtree_load        ( lc_slab_rbtree_t* p_tree, const void *image, size_t size );
+/**
+ * Write the image to a file, or read one back in with the same checks as
+ * lc_slab_rbtree_load().
+ */
+bool   lc_slab_rbtree_serialize   ( const lc_slab_rbtree_t* p_tree, FILE *file );
+bool   lc_slab_rbtree_unserialize ( lc_slab_rbtree_t* p_tree, FILE *file );
+
+lc_slab_rbtree_iterator_t lc_slab_rbtree_begin       ( const lc_slab_rbtree_t* p_tree );
+lc_slab_rbtree_iterator_t lc_slab_rbtree_next        ( const lc_slab_rbtree_t* p_tree, lc_slab_rbtree_iterator_t it );
+lc_slab_rbtree_iterator_t lc_slab_rbtree_previous    ( const lc_slab_rbtree_t* p_tree, lc_slab_rbtree_iterator_t it );
+/** The first element that is not less than key, or lc_slab_rbtree_end(). */
+lc_slab_rbtree_iterator_t lc_slab_rbtree_lower_bound ( const lc_slab_rbtree_t* p_tree, const void *key );
+
+#define lc_slab_rbtree_end( )                 ((lc_slab_rbtree_iterator_t) 0)
+#define lc_slab_rbtree_header( p_tree )       ((lc_slab_rbtree_header_t *) (p_tree)->slab)
+#define lc_slab_rbtree_size( p_tree )         ((size_t) lc_slab_rbtree_header(p_tree)->size)
+#define lc_slab_rbtree_is_empty( p_tree )     (lc_slab_rbtree_size(p_tree) == 0)
+#define lc_slab_rbtree_element( p_tree, it )  ((void *) ((p_tree)->slab + sizeof(lc_slab_rbtree_header_t) + (size_t) (it) * (p_tree)->stride + sizeof(lc_slab_rbnode_t)))
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LC_SLAB_RBTREE_H_ */
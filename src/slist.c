@@ -34,6 +34,9 @@
 		code
 #endif
 
+#define slist_alloc( p_list, size )   lc_allocator_alloc( &(p_list)->allocator, (p_list)->alloc, size )
+#define slist_free( p_list, ptr )     lc_allocator_free( &(p_list)->allocator, (p_list)->free, ptr )
+
 
 void lc_slist_create( lc_slist_t *p_list, lc_slist_element_fxn_t destroy_callback, lc_alloc_fxn_t alloc, lc_free_fxn_t free )
 {
@@ -45,6 +48,13 @@ void lc_slist_create( lc_slist_t *p_list, lc_slist_element_fxn_t destroy_callbac
 
 	p_list->alloc = alloc;
 	p_list->free  = free;
+	lc_allocator_init( &p_list->allocator, NULL );
+}
+
+void lc_slist_create_with_allocator( lc_slist_t *p_list, lc_slist_element_fxn_t destroy_callback, const lc_allocator_t* allocator )
+{
+	lc_slist_create( p_list, destroy_callback, malloc, free );
+	lc_allocator_init( &p_list->allocator, allocator );
 }
 
 void lc_slist_destroy( lc_slist_t *p_list )
@@ -63,7 +73,7 @@ bool lc_slist_insert_front( lc_slist_t *p_list, const void *data ) /* O(1) */
 	lc_slist_node_t *p_node;
 	assert( p_list );
 
-	p_node = p_list->alloc( sizeof(lc_slist_node_t) );
+	p_node = slist_alloc( p_list, sizeof(lc_slist_node_t) );
 	assert( p_node );
 
 	if( p_node != NULL )
@@ -93,7 +103,7 @@ bool lc_slist_remove_front( lc_slist_t *p_list ) /* O(1) */
 		result = p_list->destroy( p_list->head->data );
 	);
 
-	p_list->free( p_list->head );
+	slist_free( p_list, p_list->head );
 
 	p_list->head = p_node;
 	p_list->size--;
@@ -108,7 +118,7 @@ bool lc_slist_insert_next( lc_slist_t *p_list, lc_slist_node_t *p_front_node, co
 
 	if( p_front_node )
 	{
-		lc_slist_node_t *p_node = p_list->alloc( sizeof(lc_slist_node_t) );
+		lc_slist_node_t *p_node = slist_alloc( p_list, sizeof(lc_slist_node_t) );
 		assert( p_node );
 
 		if( p_node != NULL )
@@ -146,7 +156,7 @@ bool lc_slist_remove_next( lc_slist_t *p_list, lc_slist_node_t *p_front_node ) /
 			result = p_list->destroy( p_node->data );
 		);
 
-		p_list->free( p_node );
+		slist_free( p_list, p_node );
 
 		p_front_node->next = p_new_next;
 		p_list->size--;
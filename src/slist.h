@@ -51,12 +51,14 @@ typedef struct lc_slist {
 
 	lc_alloc_fxn_t  alloc;
 	lc_free_fxn_t   free;
+	lc_allocator_t  allocator;
 } lc_slist_t;
 
 typedef lc_slist_node_t* lc_slist_iterator_t;
 
 
 void    lc_slist_create        ( lc_slist_t *p_list, lc_slist_element_fxn_t destroy_callback, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+void    lc_slist_create_with_allocator ( lc_slist_t *p_list, lc_slist_element_fxn_t destroy_callback, const lc_allocator_t* allocator );
 void    lc_slist_destroy       ( lc_slist_t *p_list );
 bool    lc_slist_insert_front  ( lc_slist_t *p_list, const void *data ); /* O(1) */
 bool    lc_slist_remove_front  ( lc_slist_t *p_list ); /* O(1) */
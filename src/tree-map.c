@@ -21,11 +21,16 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <assert.h>
 #include "tree-map.h"
 
 /* Typical leaf node (always black) */
+#ifdef LC_TREE_MAP_COMPACT_NODES
+static lc_tree_map_node_t TREE_MAP_NODE_NIL = { (uintptr_t) &TREE_MAP_NODE_NIL, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, NULL, NULL };
+#else
 static lc_tree_map_node_t TREE_MAP_NODE_NIL = { (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, false, NULL };
+#endif
 
 #if defined(TREE_MAP_DESTROY_CHECK) || defined(DESTROY_CHECK_ALL)
 	#define DESTROY_CHECK( code ) \
@@ -39,14 +44,59 @@ static lc_tree_map_node_t TREE_MAP_NODE_NIL = { (lc_tree_map_node_t *) &TREE_MAP
 #endif
 
 
+#define tm_alloc( p_map, size )   lc_allocator_alloc( &(p_map)->_allocator, (p_map)->_alloc, size )
+#define tm_free( p_map, ptr )     lc_allocator_free( &(p_map)->_allocator, (p_map)->_free, ptr )
+
+#define tm_parent( p_node )      lc_tree_map_node_parent( p_node )
+#define tm_is_red( p_node )      lc_tree_map_node_is_red( p_node )
+
+#ifdef LC_TREE_MAP_COMPACT_NODES
+	#define tm_set_parent( p_node, p_parent ) \
+		((p_node)->parent_color = (uintptr_t) (p_parent) | ((p_node)->parent_color & 1))
+	#define tm_set_red( p_node, red ) \
+		((p_node)->parent_color = ((p_node)->parent_color & ~(uintptr_t) 1) | ((red) ? 1 : 0))
+	#define tm_set_parent_color( p_node, p_parent, red ) \
+		((p_node)->parent_color = (uintptr_t) (p_parent) | ((red) ? 1 : 0))
+#else
+	#define tm_set_parent( p_node, p_parent )  ((p_node)->parent = (p_parent))
+	#define tm_set_red( p_node, red )          ((p_node)->is_red = (red))
+	#define tm_set_parent_color( p_node, p_parent, red ) \
+		((p_node)->parent = (p_parent), (p_node)->is_red = (red))
+#endif
+
 #define lc_tree_map_node_init( p_node, p_key, p_value, p_parent, p_left, p_right, color ) \
-	(p_node)->parent = p_parent; \
+	tm_set_parent_color( p_node, p_parent, color ); \
 	(p_node)->left   = p_left; \
 	(p_node)->right  = p_right; \
 	(p_node)->key    = (void *) p_key; \
-	(p_node)->value  = (void *) p_value; \
-	(p_node)->is_red = color;
+	(p_node)->value  = (void *) p_value;
 
+/*
+ * Nodes from lc_tree_map_build_sorted() are freed with their block. The test
+ * compares addresses as integers, since ordering pointers into different
+ * objects is undefined; a node below the block wraps around to a large
+ * offset.
+ */
+#define tm_node_in_block( p_map, p_node ) \
+	((p_map)->_block && (uintptr_t) (p_node) - (uintptr_t) (p_map)->_block < (p_map)->_block_count * sizeof(*(p_map)->_block))
+
+static inline void tm_node_free( lc_tree_map_t *p_map, lc_tree_map_node_t *p_node )
+{
+	if( !tm_node_in_block( p_map, p_node ) )
+	{
+		tm_free( p_map, p_node );
+	}
+}
+
+static inline void tm_block_release( lc_tree_map_t *p_map )
+{
+	if( p_map->_block )
+	{
+		p_map->_free( p_map->_block );
+		p_map->_block       = NULL;
+		p_map->_block_count = 0;
+	}
+}
 
 static lc_tree_map_node_t* lc_tree_map_node_find       ( lc_tree_map_t *p_map, const void *key );
 
@@ -62,26 +112,26 @@ static inline void lc_tree_map_left_rotate( lc_tree_map_t *p_map, lc_tree_map_no
 
 	if( y->left != &TREE_MAP_NODE_NIL )
 	{
-		y->left->parent = x;
+		tm_set_parent( y->left, x );
 	}
 
-	y->parent = x->parent;
+	tm_set_parent( y, tm_parent( x ) );
 
-	if( x->parent == &TREE_MAP_NODE_NIL )
+	if( tm_parent( x ) == &TREE_MAP_NODE_NIL )
 	{
 		p_map->root = y;
 	}
-	else if( x == x->parent->left )
+	else if( x == tm_parent( x )->left )
 	{
-		x->parent->left = y;
+		tm_parent( x )->left = y;
 	}
 	else
 	{
-		x->parent->right = y;
+		tm_parent( x )->right = y;
 	}
 
 	y->left   = x;
-	x->parent = y;
+	tm_set_parent( x, y );
 }
 
 static inline void lc_tree_map_right_rotate( lc_tree_map_t *p_map, lc_tree_map_node_t *x )
@@ -95,164 +145,164 @@ static inline void lc_tree_map_right_rotate( lc_tree_map_t *p_map, lc_tree_map_n
 
 	if( y->right != &TREE_MAP_NODE_NIL )
 	{
-		y->right->parent = x;
+		tm_set_parent( y->right, x );
 	}
 
-	y->parent = x->parent;
+	tm_set_parent( y, tm_parent( x ) );
 
-	if( x->parent == &TREE_MAP_NODE_NIL )
+	if( tm_parent( x ) == &TREE_MAP_NODE_NIL )
 	{
 		p_map->root = y;
 	}
-	else if( x == x->parent->right ) {
-		x->parent->right = y;
+	else if( x == tm_parent( x )->right ) {
+		tm_parent( x )->right = y;
 	}
 	else
 	{
-		x->parent->left = y;
+		tm_parent( x )->left = y;
 	}
 
 	y->right  = x;
-	x->parent = y;
+	tm_set_parent( x, y );
 }
 
 static inline void lc_tree_map_insert_fixup( lc_tree_map_t *p_map, lc_tree_map_node_t ** t )
 {
 	lc_tree_map_node_t *y = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
 
-	while( (*t)->parent->is_red )
+	while( tm_is_red( tm_parent( *t ) ) )
 	{
-		if( (*t)->parent == (*t)->parent->parent->left ) /* is parent on left side of grandparent... */
+		if( tm_parent( *t ) == tm_parent( tm_parent( *t ) )->left ) /* is parent on left side of grandparent... */
 		{
-			y = (*t)->parent->parent->right; /* y is uncle */
+			y = tm_parent( tm_parent( *t ) )->right; /* y is uncle */
 			/* case 1 */
-			if( y->is_red ) /* uncle is red, just recolor */
+			if( tm_is_red( y ) ) /* uncle is red, just recolor */
 			{
-				(*t)->parent->is_red = false;
-				y->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				(*t) = (*t)->parent->parent;
+				tm_set_red( tm_parent( *t ), false );
+				tm_set_red( y, false );
+				tm_set_red( tm_parent( tm_parent( *t ) ), true );
+				(*t) = tm_parent( tm_parent( *t ) );
 			}
 			else
 			{
 				/* case 2 - uncle is black and t is on the right */
-				if( (*t) == (*t)->parent->right )
+				if( (*t) == tm_parent( *t )->right )
 				{
-					(*t) = (*t)->parent;
+					(*t) = tm_parent( *t );
 					lc_tree_map_left_rotate( p_map, (*t) );
 				}
 				/* case 3 - uncle is black and t is on the left */
-				(*t)->parent->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				lc_tree_map_right_rotate( p_map, (*t)->parent->parent );
+				tm_set_red( tm_parent( *t ), false );
+				tm_set_red( tm_parent( tm_parent( *t ) ), true );
+				lc_tree_map_right_rotate( p_map, tm_parent( tm_parent( *t ) ) );
 			}
 		}
 		else  /* parent is on right side of grandparent... */
 		{
-			y = (*t)->parent->parent->left; /* y is uncle */
+			y = tm_parent( tm_parent( *t ) )->left; /* y is uncle */
 			/* case 1 */
-			if( y->is_red ) /* uncle is red */
+			if( tm_is_red( y ) ) /* uncle is red */
 			{
-				(*t)->parent->is_red = false;
-				y->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				(*t) = (*t)->parent->parent;
+				tm_set_red( tm_parent( *t ), false );
+				tm_set_red( y, false );
+				tm_set_red( tm_parent( tm_parent( *t ) ), true );
+				(*t) = tm_parent( tm_parent( *t ) );
 			}
 			else
 			{
 				/* case 2 - uncle is black and t is on the left */
-				if( (*t) == (*t)->parent->left )
+				if( (*t) == tm_parent( *t )->left )
 				{
-					(*t) = (*t)->parent;
+					(*t) = tm_parent( *t );
 					lc_tree_map_right_rotate( p_map, (*t) );
 				}
 				/* case 3 - uncle is black and t is on the right */
-				(*t)->parent->is_red = false;
-				(*t)->parent->parent->is_red = true;
-				lc_tree_map_left_rotate( p_map, (*t)->parent->parent );
+				tm_set_red( tm_parent( *t ), false );
+				tm_set_red( tm_parent( tm_parent( *t ) ), true );
+				lc_tree_map_left_rotate( p_map, tm_parent( tm_parent( *t ) ) );
 			}
 		}
 	}
 
-	p_map->root->is_red = false;
+	tm_set_red( p_map->root, false );
 }
 
 static inline void lc_tree_map_delete_fixup( lc_tree_map_t *p_map, lc_tree_map_node_t ** t )
 {
 	lc_tree_map_node_t *w = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
 
-	while( (*t) != p_map->root && (*t)->is_red == false )
+	while( (*t) != p_map->root && tm_is_red( *t ) == false )
 	{
-		if( (*t) == (*t)->parent->left )
+		if( (*t) == tm_parent( *t )->left )
 		{
-			w = (*t)->parent->right;
+			w = tm_parent( *t )->right;
 
-			if( w->is_red )
+			if( tm_is_red( w ) )
 			{
-				w->is_red            = false;
-				(*t)->parent->is_red = true;
-				lc_tree_map_left_rotate( p_map, (*t)->parent );
-				w = (*t)->parent->right;
+				tm_set_red( w, false );
+				tm_set_red( tm_parent( *t ), true );
+				lc_tree_map_left_rotate( p_map, tm_parent( *t ) );
+				w = tm_parent( *t )->right;
 			}
 
-			if( w->left->is_red == false && w->right->is_red == false )
+			if( tm_is_red( w->left ) == false && tm_is_red( w->right ) == false )
 			{
-				w->is_red = true;
-				(*t) = (*t)->parent;
+				tm_set_red( w, true );
+				(*t) = tm_parent( *t );
 			}
 			else {
-				if( w->right->is_red == false )
+				if( tm_is_red( w->right ) == false )
 				{
-					w->left->is_red = false;
-					w->is_red       = true;
+					tm_set_red( w->left, false );
+					tm_set_red( w, true );
 					lc_tree_map_right_rotate( p_map, w );
-					w = (*t)->parent->right;
+					w = tm_parent( *t )->right;
 				}
 
-				w->is_red            = (*t)->parent->is_red;
-				(*t)->parent->is_red = false;
-				w->right->is_red     = false;
-				lc_tree_map_left_rotate( p_map, (*t)->parent );
+				tm_set_red( w, tm_is_red( tm_parent( *t ) ) );
+				tm_set_red( tm_parent( *t ), false );
+				tm_set_red( w->right, false );
+				lc_tree_map_left_rotate( p_map, tm_parent( *t ) );
 				(*t) = p_map->root;
 			}
 		}
 		else
 		{
-			w = (*t)->parent->left;
+			w = tm_parent( *t )->left;
 
-			if( w->is_red )
+			if( tm_is_red( w ) )
 			{
-				w->is_red = false;
-				(*t)->parent->is_red = true;
-				lc_tree_map_right_rotate( p_map, (*t)->parent );
-				w = (*t)->parent->left;
+				tm_set_red( w, false );
+				tm_set_red( tm_parent( *t ), true );
+				lc_tree_map_right_rotate( p_map, tm_parent( *t ) );
+				w = tm_parent( *t )->left;
 			}
 
-			if( w->right->is_red == false && w->left->is_red == false )
+			if( tm_is_red( w->right ) == false && tm_is_red( w->left ) == false )
 			{
-				w->is_red = true;
-				(*t) = (*t)->parent;
+				tm_set_red( w, true );
+				(*t) = tm_parent( *t );
 			}
 			else
 			{
-				if( w->left->is_red == false )
+				if( tm_is_red( w->left ) == false )
 				{
-					w->right->is_red = false;
-					w->is_red = true;
+					tm_set_red( w->right, false );
+					tm_set_red( w, true );
 					lc_tree_map_left_rotate( p_map, w );
-					w = (*t)->parent->left;
+					w = tm_parent( *t )->left;
 				}
 
-				w->is_red = (*t)->parent->is_red;
-				(*t)->parent->is_red = false;
-				w->left->is_red = false;
-				lc_tree_map_right_rotate( p_map, (*t)->parent );
+				tm_set_red( w, tm_is_red( tm_parent( *t ) ) );
+				tm_set_red( tm_parent( *t ), false );
+				tm_set_red( w->left, false );
+				lc_tree_map_right_rotate( p_map, tm_parent( *t ) );
 				(*t) = p_map->root;
 			}
 		}
 	}
 
-	(*t)->is_red = false;
+	tm_set_red( *t, false );
 }
 
 lc_tree_map_node_t *lc_tree_map_node_minimum( lc_tree_map_node_t *t )
@@ -276,12 +326,12 @@ lc_tree_map_node_t *lc_tree_map_node_successor( lc_tree_map_node_t *t )
 		return lc_tree_map_node_minimum( t->right );
 	}
 
-	y = t->parent;
+	y = tm_parent( t );
 
 	while( y != &TREE_MAP_NODE_NIL && t == y->right )
 	{
 		t = y;
-		y = y->parent;
+		y = tm_parent( y );
 	}
 
 	return y;
@@ -296,12 +346,12 @@ lc_tree_map_node_t *lc_tree_map_node_predecessor( lc_tree_map_node_t *t )
 		return lc_tree_map_node_maximum( t->left );
 	}
 
-	y = t->parent;
+	y = tm_parent( t );
 
 	while( y != &TREE_MAP_NODE_NIL && t == y->left )
 	{
 		t = y;
-		y = y->parent;
+		y = tm_parent( y );
 	}
 
 	return y;
@@ -333,6 +383,15 @@ void lc_tree_map_create( lc_tree_map_t *p_map, lc_tree_map_element_fxn_t destroy
 	p_map->destroy = destroy;
 	p_map->_alloc  = alloc;
 	p_map->_free   = free;
+	p_map->_block  = NULL;
+	p_map->_block_count = 0;
+	lc_allocator_init( &p_map->_allocator, NULL );
+}
+
+void lc_tree_map_create_with_allocator( lc_tree_map_t *p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, const lc_allocator_t* allocator )
+{
+	lc_tree_map_create( p_map, destroy, compare, malloc, free );
+	lc_allocator_init( &p_map->_allocator, allocator );
 }
 
 void lc_tree_map_destroy( lc_tree_map_t *p_map )
@@ -374,7 +433,7 @@ bool lc_tree_map_insert( lc_tree_map_t *p_map, const void *key, const void *valu
 	lc_tree_map_node_t *y       = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
 	lc_tree_map_node_t *x       = p_map->root;
 
-	lc_tree_map_node_t *newNode = (lc_tree_map_node_t *) p_map->_alloc( sizeof(lc_tree_map_node_t) );
+	lc_tree_map_node_t *newNode = (lc_tree_map_node_t *) tm_alloc( p_map, sizeof(lc_tree_map_node_t) );
 	if( !newNode ) return false;
 
 	/* Find where to insert the new node--y points the parent. */
@@ -445,21 +504,21 @@ bool lc_tree_map_remove( lc_tree_map_t *p_map, const void *key )
 		x = y->right;
 	}
 
-	x->parent = y->parent;
+	tm_set_parent( x, tm_parent( y ) );
 
-	if( y->parent == &TREE_MAP_NODE_NIL )
+	if( tm_parent( y ) == &TREE_MAP_NODE_NIL )
 	{
 		p_map->root = x;
 	}
 	else
 	{
-		if( y == y->parent->left )
+		if( y == tm_parent( y )->left )
 		{
-			y->parent->left = x;
+			tm_parent( y )->left = x;
 		}
 		else
 		{
-			y->parent->right = x;
+			tm_parent( y )->right = x;
 		}
 	}
 
@@ -472,17 +531,17 @@ bool lc_tree_map_remove( lc_tree_map_t *p_map, const void *key )
 		t->key   = y->key;
 		t->value = y->value;
 
-		y_is_red = y->is_red;
+		y_is_red = tm_is_red( y );
 
-		p_map->_free( y );
+		tm_node_free( p_map, y );
 	}
 	else
 	{
 		DESTROY_CHECK(
 			p_map->destroy( y->key, y->value );
 		);
-		y_is_red = y->is_red;
-		p_map->_free( y );
+		y_is_red = tm_is_red( y );
+		tm_node_free( p_map, y );
 	}
 
 	if( y_is_red == false ) /* y is black */
@@ -492,6 +551,11 @@ bool lc_tree_map_remove( lc_tree_map_t *p_map, const void *key )
 
 	p_map->size--;
 
+	if( p_map->size == 0 )
+	{
+		tm_block_release( p_map );
+	}
+
 	return true;
 }
 
@@ -564,37 +628,37 @@ void lc_tree_map_clear( lc_tree_map_t *p_map )
 
 		if( y->right == &TREE_MAP_NODE_NIL )
 		{
-			y->parent->left = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
-			x = y->parent;
+			tm_parent( y )->left = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
+			x = tm_parent( y );
 
 			/* free... */
 			DESTROY_CHECK(
 				p_map->destroy( y->key, y->value );
 			);
 
-			p_map->_free( y );
+			tm_node_free( p_map, y );
 
 			p_map->size--;
 		}
 		else
 		{
 			x = y->right;
-			x->parent = y->parent;
+			tm_set_parent( x, tm_parent( y ) );
 
-			if( x->parent == &TREE_MAP_NODE_NIL )
+			if( tm_parent( x ) == &TREE_MAP_NODE_NIL )
 			{
 				p_map->root = x;
 			}
 			else
 			{
-				y->parent->left = x;
+				tm_parent( y )->left = x;
 			}
 			/* free... */
 			DESTROY_CHECK(
 				p_map->destroy( y->key, y->value );
 			);
 
-			p_map->_free( y );
+			tm_node_free( p_map, y );
 			p_map->size--;
 		}
 
@@ -606,6 +670,123 @@ void lc_tree_map_clear( lc_tree_map_t *p_map )
 
 	/* reset the root and current pointers */
 	p_map->root = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
+	tm_block_release( p_map );
+}
+
+/*
+ * Link keys[lo, hi) into a subtree rooted at its middle element. The
+ * halves never differ in size by more than one so every level above
+ * red_depth is full; nodes on that last, partial level are colored red
+ * and every path from the root has the same number of black nodes.
+ * Nodes come from block, or when there is no block from the spare list.
+ */
+static lc_tree_map_node_t* tm_build( lc_tree_map_node_t *block, lc_tree_map_node_t **p_spare, void *const *keys, void *const *values,
+                                     size_t lo, size_t hi, size_t depth, size_t red_depth, lc_tree_map_node_t *parent )
+{
+	lc_tree_map_node_t *node;
+	size_t mid;
+
+	if( lo >= hi )
+	{
+		return (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
+	}
+
+	mid = lo + (hi - lo) / 2;
+
+	if( block )
+	{
+		node = &block[ mid ];
+	}
+	else
+	{
+		node     = *p_spare;
+		*p_spare = node->right;
+	}
+
+	lc_tree_map_node_init( node, keys[ mid ], values[ mid ], parent, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL, depth == red_depth );
+	node->left  = tm_build( block, p_spare, keys, values, lo, mid, depth + 1, red_depth, node );
+	node->right = tm_build( block, p_spare, keys, values, mid + 1, hi, depth + 1, red_depth, node );
+
+	return node;
+}
+
+bool lc_tree_map_build_sorted( lc_tree_map_t *p_map, void *const *keys, void *const *values, size_t count )
+{
+	lc_tree_map_node_t *block;
+	lc_tree_map_node_t *spare = NULL;
+	size_t full_levels = 0;
+	size_t i;
+
+	assert( p_map );
+	assert( count == 0 || (keys && values) );
+
+	if( p_map->size > 0 )
+	{
+		return false;
+	}
+
+	for( i = 1; i < count; i++ )
+	{
+		if( p_map->compare( keys[ i - 1 ], keys[ i ] ) > 0 )
+		{
+			return false;
+		}
+	}
+
+	if( count == 0 )
+	{
+		return true;
+	}
+
+	if( count > SIZE_MAX / sizeof(lc_tree_map_node_t) )
+	{
+		return false;
+	}
+
+	if( lc_allocator_is_set( &p_map->_allocator ) )
+	{
+		/* An allocator such as a pool may only hand out one node at a
+		 * time, so each node is obtained on its own. */
+		block = NULL;
+
+		for( i = 0; i < count; i++ )
+		{
+			lc_tree_map_node_t *node = (lc_tree_map_node_t *) tm_alloc( p_map, sizeof(lc_tree_map_node_t) );
+
+			if( !node )
+			{
+				while( spare )
+				{
+					node  = spare;
+					spare = spare->right;
+					tm_free( p_map, node );
+				}
+				return false;
+			}
+
+			node->right = spare;
+			spare       = node;
+		}
+	}
+	else
+	{
+		block = (lc_tree_map_node_t *) p_map->_alloc( count * sizeof(lc_tree_map_node_t) );
+		if( !block ) return false;
+	}
+
+	/* floor(log2(count + 1)) levels are completely filled. */
+	for( i = count + 1; i > 1; i >>= 1 )
+	{
+		full_levels++;
+	}
+
+	tm_block_release( p_map );
+	p_map->_block       = block;
+	p_map->_block_count = block ? count : 0;
+	p_map->root         = tm_build( block, &spare, keys, values, 0, count, 0, full_levels, (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL );
+	p_map->size         = count;
+
+	return true;
 }
 
 bool lc_tree_map_serialize( lc_tree_map_t *p_map, size_t key_size, size_t value_size, FILE *file )
@@ -648,10 +829,39 @@ done:
 	return result;
 }
 
+/*
+ * Bytes from the current position to the end of the file, if the file
+ * can seek.
+ */
+static bool tm_file_remaining( FILE *file, size_t *p_remaining )
+{
+	long position = ftell( file );
+	long end;
+
+	if( position < 0 || fseek( file, 0, SEEK_END ) != 0 )
+	{
+		return false;
+	}
+
+	end = ftell( file );
+
+	if( fseek( file, position, SEEK_SET ) != 0 || end < position )
+	{
+		return false;
+	}
+
+	*p_remaining = (size_t) (end - position);
+	return true;
+}
+
 bool lc_tree_map_unserialize( lc_tree_map_t *p_map, size_t key_size, size_t value_size, FILE *file )
 {
 	bool result = true;
 	size_t count = 0;
+	size_t read = 0;
+	size_t remaining;
+	size_t i;
+	void **entries = NULL; /* keys, then values */
 
 	if( !p_map )
 	{
@@ -665,7 +875,37 @@ bool lc_tree_map_unserialize( lc_tree_map_t *p_map, size_t key_size, size_t valu
 		goto done;
 	}
 
-	while( count > 0 && feof(file) == 0 )
+	if( count == 0 )
+	{
+		goto done;
+	}
+
+	if( tm_file_remaining( file, &remaining ) )
+	{
+		/* The count comes from the file, so it is checked against the
+		 * file before anything is allocated for it. */
+		if( key_size == 0 || value_size == 0 || key_size > SIZE_MAX - value_size ||
+		    count > remaining / (key_size + value_size) )
+		{
+			result = false;
+			goto done;
+		}
+
+		/* Serialized entries are in order so they can be bulk loaded. Keys,
+		 * values and this scratch array come from the legacy callbacks, not
+		 * the node allocator, which may only hand out nodes. */
+		entries = count <= SIZE_MAX / (2 * sizeof(void*)) ? (void **) p_map->_alloc( 2 * count * sizeof(void*) ) : NULL;
+
+		if( !entries )
+		{
+			result = false;
+			goto done;
+		}
+	}
+
+	/* Without a size to check the count against, as with a pipe, the
+	 * entries are inserted as they are read. */
+	while( read < count && feof(file) == 0 )
 	{
 		void *p_key;
 		void *p_val;
@@ -677,7 +917,7 @@ bool lc_tree_map_unserialize( lc_tree_map_t *p_map, size_t key_size, size_t valu
 			p_map->_free( p_key );
 
 			result = false;
-			goto done;
+			break;
 		}
 
 		p_val = p_map->_alloc( value_size );
@@ -688,11 +928,33 @@ bool lc_tree_map_unserialize( lc_tree_map_t *p_map, size_t key_size, size_t valu
 			p_map->_free( p_val );
 
 			result = false;
-			goto done;
+			break;
 		}
 
-		lc_tree_map_insert( p_map, p_key, p_val );
-		count--;
+		if( entries )
+		{
+			entries[ read ]         = p_key;
+			entries[ count + read ] = p_val;
+		}
+		else
+		{
+			lc_tree_map_insert( p_map, p_key, p_val );
+		}
+
+		read++;
+	}
+
+	if( entries )
+	{
+		if( !lc_tree_map_build_sorted( p_map, entries, entries + count, read ) )
+		{
+			for( i = 0; i < read; i++ )
+			{
+				lc_tree_map_insert( p_map, entries[ i ], entries[ count + i ] );
+			}
+		}
+
+		p_map->_free( entries );
 	}
 
 done:
@@ -749,6 +1011,76 @@ lc_tree_map_iterator_t lc_tree_map_end( )
 	return (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
 }
 
+lc_tree_map_iterator_t lc_tree_map_lower_bound( const lc_tree_map_t *p_map, const void *key )
+{
+	lc_tree_map_node_t *x      = p_map->root;
+	lc_tree_map_node_t *result = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
+
+	while( x != &TREE_MAP_NODE_NIL )
+	{
+		if( p_map->compare( x->key, key ) < 0 )
+		{
+			x = x->right;
+		}
+		else
+		{
+			result = x;
+			x      = x->left;
+		}
+	}
+
+	return result;
+}
+
+lc_tree_map_iterator_t lc_tree_map_upper_bound( const lc_tree_map_t *p_map, const void *key )
+{
+	lc_tree_map_node_t *x      = p_map->root;
+	lc_tree_map_node_t *result = (lc_tree_map_node_t *) &TREE_MAP_NODE_NIL;
+
+	while( x != &TREE_MAP_NODE_NIL )
+	{
+		if( p_map->compare( key, x->key ) < 0 )
+		{
+			result = x;
+			x      = x->left;
+		}
+		else
+		{
+			x = x->right;
+		}
+	}
+
+	return result;
+}
+
+void lc_tree_map_equal_range( const lc_tree_map_t *p_map, const void *key, lc_tree_map_iterator_t *p_first, lc_tree_map_iterator_t *p_last )
+{
+	*p_first = lc_tree_map_lower_bound( p_map, key );
+	*p_last  = lc_tree_map_upper_bound( p_map, key );
+}
+
+size_t lc_tree_map_range( const lc_tree_map_t *p_map, const void *low, const void *high, lc_tree_map_range_fxn_t visit, void *user_data )
+{
+	lc_tree_map_iterator_t itr = low ? lc_tree_map_lower_bound( p_map, low ) : lc_tree_map_begin( p_map );
+	size_t count = 0;
+
+	assert( visit );
+
+	while( itr != &TREE_MAP_NODE_NIL && (!high || p_map->compare( itr->key, high ) < 0) )
+	{
+		count++;
+
+		if( !visit( itr->key, itr->value, user_data ) )
+		{
+			break;
+		}
+
+		itr = lc_tree_map_node_successor( itr );
+	}
+
+	return count;
+}
+
 
 
 #ifdef LC_DEBUG_TREE_MAP
@@ -759,7 +1091,7 @@ static void structure           ( const lc_tree_map_node_t *root, int level );
 bool lc_tree_map_verify_tree( lc_tree_map_t *p_map )
 {
 	/* check if root is black... */
-	if( p_map->root->is_red )
+	if( tm_is_red( p_map->root ) )
 	{
 		return false;
 	}
@@ -774,9 +1106,9 @@ bool lc_tree_map_node_verify_tree( lc_tree_map_t *p_map, lc_tree_map_node_t *t )
 		return true;
 	}
 
-	if( t->is_red )
+	if( tm_is_red( t ) )
 	{
-		if( t->left->is_red || t->right->is_red )
+		if( tm_is_red( t->left ) || tm_is_red( t->right ) )
 		{
 			return false;
 		}
@@ -810,7 +1142,7 @@ inline void structure( const lc_tree_map_node_t *root, int level )
 		structure( root->right, level + 1 );
 		padding( '\t', level );
 		printf( "%d-", *( (int *) root->key ) );
-		printf( "%c\n", root->is_red ? 'R' : 'B' );
+		printf( "%c\n", tm_is_red( root ) ? 'R' : 'B' );
 		structure( root->left, level + 1 );
 	}
 }
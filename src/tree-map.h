@@ -25,23 +25,45 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
 #include <stdbool.h>
 #include "alloc.h"
 
 typedef int     (*lc_tree_map_compare_fxn_t) ( const void *p_key_left, const void *p_key_right );
 typedef bool    (*lc_tree_map_element_fxn_t) ( void *p_key, void *p_value );
+/* Called for each entry of a range; return false to stop early. */
+typedef bool    (*lc_tree_map_range_fxn_t)   ( void *p_key, void *p_value, void *user_data );
 
 
 
+/*
+ * With LC_TREE_MAP_COMPACT_NODES the color is kept in the low bit of the
+ * parent pointer, which saves a word per node. It changes the node layout
+ * and must be defined the same way for the library and its users.
+ */
 typedef struct lc_lc_tree_map_node {
+#ifdef LC_TREE_MAP_COMPACT_NODES
+	uintptr_t parent_color; /* parent pointer; the low bit is set when red */
+#else
 	struct lc_lc_tree_map_node* parent;
+#endif
 	struct lc_lc_tree_map_node* left;
 	struct lc_lc_tree_map_node* right;
+#ifndef LC_TREE_MAP_COMPACT_NODES
 	bool  is_red;
+#endif
 	void* key;
 	void* value;
 } lc_tree_map_node_t;
 
+#ifdef LC_TREE_MAP_COMPACT_NODES
+#define lc_tree_map_node_parent( p_node )   ((lc_tree_map_node_t *) ((p_node)->parent_color & ~(uintptr_t) 1))
+#define lc_tree_map_node_is_red( p_node )   ((bool) ((p_node)->parent_color & 1))
+#else
+#define lc_tree_map_node_parent( p_node )   ((p_node)->parent)
+#define lc_tree_map_node_is_red( p_node )   ((p_node)->is_red)
+#endif
+
 typedef struct lc_tree_map {
 	lc_tree_map_node_t *root;
 	size_t size;
@@ -50,6 +72,11 @@ typedef struct lc_tree_map {
 
 	lc_alloc_fxn_t  _alloc;
 	lc_free_fxn_t   _free;
+	lc_allocator_t  _allocator;
+
+	/* Nodes allocated in one block by lc_tree_map_build_sorted(). */
+	lc_tree_map_node_t *_block;
+	size_t _block_count;
 } lc_tree_map_t;
 
 typedef lc_tree_map_node_t* lc_tree_map_iterator_t;
@@ -57,6 +84,7 @@ typedef lc_tree_map_node_t* lc_tree_map_iterator_t;
 
 lc_tree_map_t* lc_tree_map_create_ex   ( lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
 void        lc_tree_map_create      ( lc_tree_map_t *p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, lc_alloc_fxn_t alloc, lc_free_fxn_t free );
+void        lc_tree_map_create_with_allocator ( lc_tree_map_t *p_map, lc_tree_map_element_fxn_t destroy, lc_tree_map_compare_fxn_t compare, const lc_allocator_t* allocator );
 void        lc_tree_map_destroy     ( lc_tree_map_t *p_map );
 void        lc_tree_map_copy        ( lc_tree_map_t const *p_srcTree, lc_tree_map_t *p_dstTree );
 bool        lc_tree_map_insert      ( lc_tree_map_t *p_map, const void *key, const void *value );
@@ -65,6 +93,18 @@ bool        lc_tree_map_search      ( const lc_tree_map_t *p_map, const void *ke
 void        lc_tree_map_clear       ( lc_tree_map_t *p_map );
 bool        lc_tree_map_serialize   ( lc_tree_map_t *p_map, size_t key_size, size_t value_size, FILE *file );
 bool        lc_tree_map_unserialize ( lc_tree_map_t *p_map, size_t key_size, size_t value_size, FILE *file );
+/*
+ * Build a balanced tree from count keys (and their values) that are
+ * already in ascending order, in O(n) and with one allocation for all
+ * of the nodes. The map must be empty. Returns false if the keys are
+ * not sorted or memory could not be allocated.
+ *
+ * Removing a key does not give its node back: the block stays allocated
+ * at its full size until the map is empty again. A map with an
+ * lc_allocator_t gets its nodes from the allocator one at a time
+ * instead, since an allocator such as a pool may not hand out a block.
+ */
+bool        lc_tree_map_build_sorted ( lc_tree_map_t *p_map, void *const *keys, void *const *values, size_t count );
 void        lc_tree_map_alloc_set   ( lc_tree_map_t *p_map, lc_alloc_fxn_t alloc );
 void        lc_tree_map_free_set    ( lc_tree_map_t *p_map, lc_free_fxn_t free );
 
@@ -76,6 +116,18 @@ lc_tree_map_node_t* lc_tree_map_node_predecessor ( lc_tree_map_node_t *t );
 lc_tree_map_iterator_t lc_tree_map_begin ( const lc_tree_map_t *p_map );
 lc_tree_map_iterator_t lc_tree_map_end   ( );
 lc_tree_map_iterator_t lc_tree_map_find  ( const lc_tree_map_t *p_map, const void *key );
+/* The first entry whose key is not less than key, or lc_tree_map_end(). */
+lc_tree_map_iterator_t lc_tree_map_lower_bound ( const lc_tree_map_t *p_map, const void *key );
+/* The first entry whose key is greater than key, or lc_tree_map_end(). */
+lc_tree_map_iterator_t lc_tree_map_upper_bound ( const lc_tree_map_t *p_map, const void *key );
+/* The entries equal to key are [*p_first, *p_last). */
+void                   lc_tree_map_equal_range ( const lc_tree_map_t *p_map, const void *key, lc_tree_map_iterator_t *p_first, lc_tree_map_iterator_t *p_last );
+/*
+ * Visit the entries with low <= key < high in order, in O(log n + k). A
+ * NULL low or high leaves that end of the range open. Returns the number
+ * of entries visited.
+ */
+size_t                 lc_tree_map_range       ( const lc_tree_map_t *p_map, const void *low, const void *high, lc_tree_map_range_fxn_t visit, void *user_data );
 
 
 #ifdef LC_DEBUG_TREE_MAP
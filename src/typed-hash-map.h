@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_TYPED_HASH_MAP_H_
+#define _LC_TYPED_HASH_MAP_H_
+/**
+ * @file typed-hash-map.h
+ * @brief Hash maps for specific key and value types.
+ *
+ * LC_HASH_MAP_DECL and LC_HASH_MAP_IMPL generate a hash map whose keys
+ * and values are stored inline in a flat array of entries, and whose hash
+ * and equality functions (or macros) are called directly so the compiler
+ * can inline them. There is no void* per key or value and no function
+ * pointer call per probe.
+ *
+ * The map uses Robin Hood linear probing. Each entry has one metadata
+ * byte that is 0 for an empty entry or 1 + the entry's distance from its
+ * home position. Removes shift the following entries back, so there are
+ * no deleted markers. The hash is scrambled before use, so an identity
+ * hash is fine for integer keys.
+ *
+ * Pointers to values are invalidated by inserts and removes.
+ *
+ * @defgroup lc_typed_hash_map Typed Hash Map
+ * @ingroup Collections
+ * @{
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "alloc.h"
+
+/* Entries are added until the map is this full (7/8) */
+#define LC_HASH_MAP_MAX_LOAD( capacity )     ((capacity) - (capacity) / 8)
+#ifndef LC_HASH_MAP_MIN_CAPACITY
+#define LC_HASH_MAP_MIN_CAPACITY             (8)
+#endif
+/* A capacity of 1 would make the home position shift by 64. */
+#if LC_HASH_MAP_MIN_CAPACITY < 2
+#error "LC_HASH_MAP_MIN_CAPACITY must be at least 2."
+#endif
+
+/* Hash and equality for integer keys. */
+#define LC_HASH_MAP_IDENTITY_HASH( key )     ((size_t) (key))
+#define LC_HASH_MAP_EQUAL( left, right )     ((left) == (right))
+
+/*
+ * Declare a hash map from key_type to value_type.
+ */
+#define LC_HASH_MAP_DECL( prefix, key_type, value_type ) \
+	typedef struct prefix##_hash_map_entry { \
+		key_type   key; \
+		value_type value; \
+	} prefix##_hash_map_entry_t; \
+	\
+	typedef struct prefix##_hash_map { \
+		size_t   size; \
+		size_t   capacity; /* a power of two */ \
+		unsigned shift;    /* 64 - log2(capacity) */ \
+		uint8_t* meta; \
+		prefix##_hash_map_entry_t* entries; \
+		lc_allocator_t allocator; \
+	} prefix##_hash_map_t; \
+	\
+	bool        prefix##_hash_map_create  ( prefix##_hash_map_t* p_map, size_t count, const lc_allocator_t* allocator ); \
+	void        prefix##_hash_map_destroy ( prefix##_hash_map_t* p_map ); \
+	bool        prefix##_hash_map_insert  ( prefix##_hash_map_t* p_map, key_type key, value_type value ); \
+	bool        prefix##_hash_map_put     ( prefix##_hash_map_t* p_map, key_type key, value_type value ); \
+	value_type* prefix##_hash_map_find    ( const prefix##_hash_map_t* p_map, key_type key ); \
+	bool        prefix##_hash_map_remove  ( prefix##_hash_map_t* p_map, key_type key ); \
+	void        prefix##_hash_map_clear   ( prefix##_hash_map_t* p_map ); \
+	bool        prefix##_hash_map_reserve ( prefix##_hash_map_t* p_map, size_t count ); \
+	size_t      prefix##_hash_map_size    ( const prefix##_hash_map_t* p_map ); \
+	prefix##_hash_map_entry_t* prefix##_hash_map_next ( const prefix##_hash_map_t* p_map, size_t* p_index );
+
+/*
+ * Implement a hash map from key_type to value_type. hash( key ) must give
+ * a size_t and eq( left, right ) must be true for equal keys; both may be
+ * functions or macros.
+ *
+ * prefix##_hash_map_create() sizes the map for count entries; a NULL
+ * allocator means malloc() and free().
+ * prefix##_hash_map_insert() fails if the key is already in the map and
+ * prefix##_hash_map_put() replaces its value instead. An insert whose
+ * probe would be longer than the metadata byte can hold tries again in a
+ * map of twice the capacity. It fails, leaving the map as it was, if the
+ * probe is still too long there; that happens once 255 keys in the map
+ * share its full hash.
+ * prefix##_hash_map_next() walks the entries; start *p_index at 0 and
+ * stop when it returns NULL.
+ */
+#define LC_HASH_MAP_IMPL( prefix, key_type, value_type, hash, eq ) \
+	static inline size_t prefix##_hash_map_home( const prefix##_hash_map_t* p_map, key_type key ) \
+	{ \
+		/* Fibonacci hashing; the top bits are the best mixed. */ \
+		return (size_t) (((uint64_t) hash( key ) * 0x9E3779B97F4A7C15ULL) >> p_map->shift); \
+	} \
+	\
+	static inline bool prefix##_hash_map_allocate( prefix##_hash_map_t* p_map, size_t capacity ) \
+	{ \
+		unsigned bits = 0; \
+		\
+		while( ((size_t) 1 << bits) < capacity ) \
+		{ \
+			bits++; \
+		} \
+		\
+		p_map->size     = 0; \
+		p_map->capacity = (size_t) 1 << bits; \
+		p_map->shift    = 64 - bits; \
+		p_map->entries  = (prefix##_hash_map_entry_t*) lc_allocator_alloc( &p_map->allocator, malloc, p_map->capacity * sizeof(prefix##_hash_map_entry_t) ); \
+		p_map->meta     = (uint8_t*) lc_allocator_alloc( &p_map->allocator, malloc, p_map->capacity ); \
+		\
+		if( !p_map->entries || !p_map->meta ) \
+		{ \
+			if( p_map->entries ) lc_allocator_free( &p_map->allocator, free, p_map->entries ); \
+			if( p_map->meta )    lc_allocator_free( &p_map->allocator, free, p_map->meta ); \
+			return false; \
+		} \
+		\
+		memset( p_map->meta, 0, p_map->capacity ); \
+		return true; \
+	} \
+	\
+	static inline size_t prefix##_hash_map_capacity_for( size_t count ) \
+	{ \
+		size_t capacity = LC_HASH_MAP_MIN_CAPACITY; \
+		\
+		while( LC_HASH_MAP_MAX_LOAD( capacity ) < count ) \
+		{ \
+			capacity <<= 1; \
+		} \
+		\
+		return capacity; \
+	} \
+	\
+	/* Put an entry that isn't in the map yet into its Robin Hood position. */ \
+	/* Fails, without changing anything, if a distance would not fit in the */ \
+	/* metadata byte.                                                       */ \
+	static inline bool prefix##_hash_map_place( prefix##_hash_map_t* p_map, key_type key, value_type value ) \
+	{ \
+		size_t  mask  = p_map->capacity - 1; \
+		size_t  index = prefix##_hash_map_home( p_map, key ); \
+		uint8_t dist  = 1; \
+		size_t  empty; \
+		\
+		while( p_map->meta[ index ] >= dist ) \
+		{ \
+			if( dist == UINT8_MAX ) \
+			{ \
+				return false; \
+			} \
+			dist++; \
+			index = (index + 1) & mask; \
+		} \
+		\
+		for( empty = index; p_map->meta[ empty ] != 0; empty = (empty + 1) & mask ) \
+		{ \
+			if( p_map->meta[ empty ] == UINT8_MAX ) \
+			{ \
+				return false; \
+			} \
+		} \
+		\
+		/* Everything from index up to the empty entry moves down one. */ \
+		while( empty != index ) \
+		{ \
+			size_t previous = (empty - 1) & mask; \
+			p_map->entries[ empty ] = p_map->entries[ previous ]; \
+			p_map->meta[ empty ]    = p_map->meta[ previous ] + 1; \
+			empty = previous; \
+		} \
+		\
+		p_map->entries[ index ].key   = key; \
+		p_map->entries[ index ].value = value; \
+		p_map->meta[ index ]          = dist; \
+		p_map->size++; \
+		return true; \
+	} \
+	\
+	/* Copies the entries into a new map of the given capacity; p_map is */ \
+	/* left unchanged.                                                    */ \
+	static bool prefix##_hash_map_copy( const prefix##_hash_map_t* p_map, prefix##_hash_map_t* p_new_map, size_t capacity ) \
+	{ \
+		size_t i; \
+		\
+		*p_new_map = *p_map; \
+		\
+		if( !prefix##_hash_map_allocate( p_new_map, capacity ) ) \
+		{ \
+			return false; \
+		} \
+		\
+		for( i = 0; i < p_map->capacity; i++ ) \
+		{ \
+			if( p_map->meta[ i ] && !prefix##_hash_map_place( p_new_map, p_map->entries[ i ].key, p_map->entries[ i ].value ) ) \
+			{ \
+				lc_allocator_free( &p_new_map->allocator, free, p_new_map->entries ); \
+				lc_allocator_free( &p_new_map->allocator, free, p_new_map->meta ); \
+				return false; \
+			} \
+		} \
+		\
+		return true; \
+	} \
+	\
+	static bool prefix##_hash_map_resize( prefix##_hash_map_t* p_map, size_t capacity ) \
+	{ \
+		prefix##_hash_map_t new_map; \
+		\
+		if( !prefix##_hash_map_copy( p_map, &new_map, capacity ) ) \
+		{ \
+			return false; \
+		} \
+		\
+		prefix##_hash_map_destroy( p_map ); \
+		*p_map = new_map; \
+		return true; \
+	} \
+	\
+	static inline size_t prefix##_hash_map_find_index( const prefix##_hash_map_t* p_map, key_type key ) \
+	{ \
+		size_t mask  = p_map->capacity - 1; \
+		size_t index = prefix##_hash_map_home( p_map, key ); \
+		size_t dist  = 1; \
+		\
+		/* Stop at the first entry closer to home than the key would be. */ \
+		while( p_map->meta[ index ] >= dist ) \
+		{ \
+			if( eq( p_map->entries[ index ].key, key ) ) \
+			{ \
+				return index; \
+			} \
+			dist++; \
+			index = (index + 1) & mask; \
+		} \
+		\
+		return p_map->capacity; \
+	} \
+	\
+	bool prefix##_hash_map_create( prefix##_hash_map_t* p_map, size_t count, const lc_allocator_t* allocator ) \
+	{ \
+		assert( p_map ); \
+		lc_allocator_init( &p_map->allocator, allocator ); \
+		return prefix##_hash_map_allocate( p_map, prefix##_hash_map_capacity_for( count ) ); \
+	} \
+	\
+	void prefix##_hash_map_destroy( prefix##_hash_map_t* p_map ) \
+	{ \
+		assert( p_map ); \
+		lc_allocator_free( &p_map->allocator, free, p_map->entries ); \
+		lc_allocator_free( &p_map->allocator, free, p_map->meta ); \
+		p_map->entries  = NULL; \
+		p_map->meta     = NULL; \
+		p_map->size     = 0; \
+		p_map->capacity = 0; \
+	} \
+	\
+	bool prefix##_hash_map_insert( prefix##_hash_map_t* p_map, key_type key, value_type value ) \
+	{ \
+		assert( p_map ); \
+		\
+		if( prefix##_hash_map_find_index( p_map, key ) != p_map->capacity ) \
+		{ \
+			return false; \
+		} \
+		\
+		if( p_map->size >= LC_HASH_MAP_MAX_LOAD( p_map->capacity ) && \
+		    !prefix##_hash_map_resize( p_map, 2 * p_map->capacity ) ) \
+		{ \
+			return false; \
+		} \
+		\
+		/* Below the load limit a probe too long for the metadata byte means */ \
+		/* a cluster of keys whose homes are close. Doubling the capacity    */ \
+		/* uses one more hash bit and can split it, but keys whose full      */ \
+		/* hashes are equal stay together at any capacity. So the doubled    */ \
+		/* map is only kept if the key fits in it.                           */ \
+		if( !prefix##_hash_map_place( p_map, key, value ) ) \
+		{ \
+			prefix##_hash_map_t new_map; \
+			\
+			if( !prefix##_hash_map_copy( p_map, &new_map, 2 * p_map->capacity ) ) \
+			{ \
+				return false; \
+			} \
+			\
+			if( !prefix##_hash_map_place( &new_map, key, value ) ) \
+			{ \
+				prefix##_hash_map_destroy( &new_map ); \
+				return false; \
+			} \
+			\
+			prefix##_hash_map_destroy( p_map ); \
+			*p_map = new_map; \
+		} \
+		\
+		return true; \
+	} \
+	\
+	bool prefix##_hash_map_put( prefix##_hash_map_t* p_map, key_type key, value_type value ) \
+	{ \
+		value_type* p_value = prefix##_hash_map_find( p_map, key ); \
+		\
+		if( p_value ) \
+		{ \
+			*p_value = value; \
+			return true; \
+		} \
+		\
+		return prefix##_hash_map_insert( p_map, key, value ); \
+	} \
+	\
+	value_type* prefix##_hash_map_find( const prefix##_hash_map_t* p_map, key_type key ) \
+	{ \
+		size_t index; \
+		\
+		assert( p_map ); \
+		index = prefix##_hash_map_find_index( p_map, key ); \
+		\
+		return index != p_map->capacity ? &p_map->entries[ index ].value : NULL; \
+	} \
+	\
+	bool prefix##_hash_map_remove( prefix##_hash_map_t* p_map, key_type key ) \
+	{ \
+		size_t mask = p_map->capacity - 1; \
+		size_t index; \
+		size_t next; \
+		\
+		assert( p_map ); \
+		index = prefix##_hash_map_find_index( p_map, key ); \
+		\
+		if( index == p_map->capacity ) \
+		{ \
+			return false; \
+		} \
+		\
+		/* Backward shift; entries that aren't home move back one. */ \
+		for( next = (index + 1) & mask; p_map->meta[ next ] > 1; next = (next + 1) & mask ) \
+		{ \
+			p_map->entries[ index ] = p_map->entries[ next ]; \
+			p_map->meta[ index ]    = p_map->meta[ next ] - 1; \
+			index = next; \
+		} \
+		\
+		p_map->meta[ index ] = 0; \
+		p_map->size--; \
+		return true; \
+	} \
+	\
+	void prefix##_hash_map_clear( prefix##_hash_map_t* p_map ) \
+	{ \
+		assert( p_map ); \
+		memset( p_map->meta, 0, p_map->capacity ); \
+		p_map->size = 0; \
+	} \
+	\
+	bool prefix##_hash_map_reserve( prefix##_hash_map_t* p_map, size_t count ) \
+	{ \
+		size_t capacity = prefix##_hash_map_capacity_for( count ); \
+		\
+		assert( p_map ); \
+		return capacity <= p_map->capacity || prefix##_hash_map_resize( p_map, capacity ); \
+	} \
+	\
+	size_t prefix##_hash_map_size( const prefix##_hash_map_t* p_map ) \
+	{ \
+		return p_map->size; \
+	} \
+	\
+	prefix##_hash_map_entry_t* prefix##_hash_map_next( const prefix##_hash_map_t* p_map, size_t* p_index ) \
+	{ \
+		assert( p_map ); \
+		assert( p_index ); \
+		\
+		while( *p_index < p_map->capacity ) \
+		{ \
+			size_t index = (*p_index)++; \
+			\
+			if( p_map->meta[ index ] ) \
+			{ \
+				return &p_map->entries[ index ]; \
+			} \
+		} \
+		\
+		return NULL; \
+	}
+
+#endif /* _LC_TYPED_HASH_MAP_H_ */
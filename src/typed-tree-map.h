@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2010-2025 by Joseph A. Marrero.  https://joemarrero.com/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _LC_TYPED_TREE_MAP_H_
+#define _LC_TYPED_TREE_MAP_H_
+/**
+ * @file typed-tree-map.h
+ * @brief Ordered maps for specific key and value types.
+ *
+ * LC_TREE_MAP_DECL and LC_TREE_MAP_IMPL generate a red-black tree map
+ * whose keys and values are stored inside the nodes, and whose compare
+ * function (or macro) is called directly so the compiler can inline it.
+ * Walking down the tree touches one node per level instead of a node, a
+ * key and an indirect compare call.
+ *
+ * Keys are unique. Removing a node with two children moves the key and
+ * value of its successor, so pointers to values are invalidated by
+ * removes (but not by inserts).
+ *
+ * @defgroup lc_typed_tree_map Typed Tree Map
+ * @ingroup Collections
+ * @{
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "alloc.h"
+
+/* Compare for integer keys. */
+#define LC_TREE_MAP_COMPARE( left, right )   (((left) > (right)) - ((left) < (right)))
+
+/*
+ * Declare a tree map from key_type to value_type.
+ */
+#define LC_TREE_MAP_DECL( prefix, key_type, value_type ) \
+	typedef struct prefix##_tree_map_node { \
+		struct prefix##_tree_map_node* parent; \
+		struct prefix##_tree_map_node* left; \
+		struct prefix##_tree_map_node* right; \
+		bool       is_red; \
+		key_type   key; \
+		value_type value; \
+	} prefix##_tree_map_node_t; \
+	\
+	typedef struct prefix##_tree_map { \
+		prefix##_tree_map_node_t* root; \
+		size_t size; \
+		lc_allocator_t allocator; \
+	} prefix##_tree_map_t; \
+	\
+	void        prefix##_tree_map_create  ( prefix##_tree_map_t* p_map, const lc_allocator_t* allocator ); \
+	void        prefix##_tree_map_destroy ( prefix##_tree_map_t* p_map ); \
+	bool        prefix##_tree_map_insert  ( prefix##_tree_map_t* p_map, key_type key, value_type value ); \
+	bool        prefix##_tree_map_put     ( prefix##_tree_map_t* p_map, key_type key, value_type value ); \
+	value_type* prefix##_tree_map_find    ( const prefix##_tree_map_t* p_map, key_type key ); \
+	bool        prefix##_tree_map_remove  ( prefix##_tree_map_t* p_map, key_type key ); \
+	void        prefix##_tree_map_clear   ( prefix##_tree_map_t* p_map ); \
+	size_t      prefix##_tree_map_size    ( const prefix##_tree_map_t* p_map ); \
+	prefix##_tree_map_node_t* prefix##_tree_map_first    ( const prefix##_tree_map_t* p_map ); \
+	prefix##_tree_map_node_t* prefix##_tree_map_last     ( const prefix##_tree_map_t* p_map ); \
+	prefix##_tree_map_node_t* prefix##_tree_map_next     ( const prefix##_tree_map_node_t* p_node ); \
+	prefix##_tree_map_node_t* prefix##_tree_map_previous ( const prefix##_tree_map_node_t* p_node );
+
+/*
+ * Implement a tree map from key_type to value_type. cmp( left, right )
+ * must return a negative, zero or positive int like strcmp(); it may be
+ * a function or a macro.
+ *
+ * A NULL allocator means malloc() and free().
+ * prefix##_tree_map_insert() fails if the key is already in the map and
+ * prefix##_tree_map_put() replaces its value instead.
+ * prefix##_tree_map_first() and prefix##_tree_map_next() walk the nodes
+ * in key order; both return NULL at the end.
+ */
+#define LC_TREE_MAP_IMPL( prefix, key_type, value_type, cmp ) \
+	static inline bool prefix##_tree_map_node_is_red( const prefix##_tree_map_node_t* p_node ) \
+	{ \
+		return p_node && p_node->is_red; /* leaves (NULL) are black */ \
+	} \
+	\
+	static inline void prefix##_tree_map_replace_child( prefix##_tree_map_t* p_map, prefix##_tree_map_node_t* parent, prefix##_tree_map_node_t* old_child, prefix##_tree_map_node_t* new_child ) \
+	{ \
+		if( !parent ) \
+		{ \
+			p_map->root = new_child; \
+		} \
+		else if( parent->left == old_child ) \
+		{ \
+			parent->left = new_child; \
+		} \
+		else \
+		{ \
+			parent->right = new_child; \
+		} \
+	} \
+	\
+	static inline void prefix##_tree_map_left_rotate( prefix##_tree_map_t* p_map, prefix##_tree_map_node_t* x ) \
+	{ \
+		prefix##_tree_map_node_t* y = x->right; \
+		\
+		x->right = y->left; \
+		if( y->left ) \
+		{ \
+			y->left->parent = x; \
+		} \
+		y->parent = x->parent; \
+		prefix##_tree_map_replace_child( p_map, x->parent, x, y ); \
+		y->left   = x; \
+		x->parent = y; \
+	} \
+	\
+	static inline void prefix##_tree_map_right_rotate( prefix##_tree_map_t* p_map, prefix##_tree_map_node_t* x ) \
+	{ \
+		prefix##_tree_map_node_t* y = x->left; \
+		\
+		x->left = y->right; \
+		if( y->right ) \
+		{ \
+			y->right->parent = x; \
+		} \
+		y->parent = x->parent; \
+		prefix##_tree_map_replace_child( p_map, x->parent, x, y ); \
+		y->right  = x; \
+		x->parent = y; \
+	} \
+	\
+	static void prefix##_tree_map_insert_fixup( prefix##_tree_map_t* p_map, prefix##_tree_map_node_t* t ) \
+	{ \
+		prefix##_tree_map_node_t* parent; \
+		\
+		while( (parent = t->parent) != NULL && parent->is_red ) \
+		{ \
+			prefix##_tree_map_node_t* grandparent = parent->parent; \
+			\
+			if( parent == grandparent->left ) \
+			{ \
+				prefix##_tree_map_node_t* uncle = grandparent->right; \
+				\
+				if( prefix##_tree_map_node_is_red( uncle ) ) \
+				{ \
+					parent->is_red      = false; \
+					uncle->is_red       = false; \
+					grandparent->is_red = true; \
+					t = grandparent; \
+				} \
+				else \
+				{ \
+					if( t == parent->right ) \
+					{ \
+						prefix##_tree_map_left_rotate( p_map, parent ); \
+						t      = parent; \
+						parent = t->parent; \
+					} \
+					parent->is_red      = false; \
+					grandparent->is_red = true; \
+					prefix##_tree_map_right_rotate( p_map, grandparent ); \
+				} \
+			} \
+			else \
+			{ \
+				prefix##_tree_map_node_t* uncle = grandparent->left; \
+				\
+				if( prefix##_tree_map_node_is_red( uncle ) ) \
+				{ \
+					parent->is_red      = false; \
+					uncle->is_red       = false; \
+					grandparent->is_red = true; \
+					t = grandparent; \
+				} \
+				else \
+				{ \
+					if( t == parent->left ) \
+					{ \
+						prefix##_tree_map_right_rotate( p_map, parent ); \
+						t      = parent; \
+						parent = t->parent; \
+					} \
+					parent->is_red      = false; \
+					grandparent->is_red = true; \
+					prefix##_tree_map_left_rotate( p_map, grandparent ); \
+				} \
+			} \
+		} \
+		\
+		p_map->root->is_red = false; \
+	} \
+	\
+	/* t may be a leaf (NULL) so its parent is passed along with it. */ \
+	static void prefix##_tree_map_delete_fixup( prefix##_tree_map_t* p_map, prefix##_tree_map_node_t* t, prefix##_tree_map_node_t* parent ) \
+	{ \
+		while( t != p_map->root && !prefix##_tree_map_node_is_red( t ) ) \
+		{ \
+			if( t == parent->left ) \
+			{ \
+				prefix##_tree_map_node_t* w = parent->right; \
+				\
+				if( w->is_red ) \
+				{ \
+					w->is_red      = false; \
+					parent->is_red = true; \
+					prefix##_tree_map_left_rotate( p_map, parent ); \
+					w = parent->right; \
+				} \
+				\
+				if( !prefix##_tree_map_node_is_red( w->left ) && !prefix##_tree_map_node_is_red( w->right ) ) \
+				{ \
+					w->is_red = true; \
+					t         = parent; \
+					parent    = t->parent; \
+				} \
+				else \
+				{ \
+					if( !prefix##_tree_map_node_is_red( w->right ) ) \
+					{ \
+						w->left->is_red = false; \
+						w->is_red       = true; \
+						prefix##_tree_map_right_rotate( p_map, w ); \
+						w = parent->right; \
+					} \
+					w->is_red        = parent->is_red; \
+					parent->is_red   = false; \
+					w->right->is_red = false; \
+					prefix##_tree_map_left_rotate( p_map, parent ); \
+					t = p_map->root; \
+				} \
+			} \
+			else \
+			{ \
+				prefix##_tree_map_node_t* w = parent->left; \
+				\
+				if( w->is_red ) \
+				{ \
+					w->is_red      = false; \
+					parent->is_red = true; \
+					prefix##_tree_map_right_rotate( p_map, parent ); \
+					w = parent->left; \
+				} \
+				\
+				if( !prefix##_tree_map_node_is_red( w->right ) && !prefix##_tree_map_node_is_red( w->left ) ) \
+				{ \
+					w->is_red = true; \
+					t         = parent; \
+					parent    = t->parent; \
+				} \
+				else \
+				{ \
+					if( !prefix##_tree_map_node_is_red( w->left ) ) \
+					{ \
+						w->right->is_red = false; \
+						w->is_red        = true; \
+						prefix##_tree_map_left_rotate( p_map, w ); \
+						w = parent->left; \
+					} \
+					w->is_red       = parent->is_red; \
+					parent->is_red  = false; \
+					w->left->is_red = false; \
+					prefix##_tree_map_right_rotate( p_map, parent ); \
+					t = p_map->root; \
+				} \
+			} \
+		} \
+		\
+		if( t ) \
+		{ \
+			t->is_red = false; \
+		} \
+	} \
+	\
+	static inline prefix##_tree_map_node_t* prefix##_tree_map_find_node( const prefix##_tree_map_t* p_map, key_type key ) \
+	{ \
+		prefix##_tree_map_node_t* x = p_map->root; \
+		\
+		while( x ) \
+		{ \
+			int c = cmp( key, x->key ); \
+			\
+			if( c == 0 ) \
+			{ \
+				break; \
+			} \
+			x = c < 0 ? x->left : x->right; \
+		} \
+		\
+		return x; \
+	} \
+	\
+	void prefix##_tree_map_create( prefix##_tree_map_t* p_map, const lc_allocator_t* allocator ) \
+	{ \
+		assert( p_map ); \
+		p_map->root = NULL; \
+		p_map->size = 0; \
+		lc_allocator_init( &p_map->allocator, allocator ); \
+	} \
+	\
+	void prefix##_tree_map_destroy( prefix##_tree_map_t* p_map ) \
+	{ \
+		prefix##_tree_map_clear( p_map ); \
+	} \
+	\
+	bool prefix##_tree_map_insert( prefix##_tree_map_t* p_map, key_type key, value_type value ) \
+	{ \
+		prefix##_tree_map_node_t* parent = NULL; \
+		prefix##_tree_map_node_t* x      = p_map->root; \
+		prefix##_tree_map_node_t* node; \
+		int c = 0; \
+		\
+		assert( p_map ); \
+		\
+		while( x ) \
+		{ \
+			parent = x; \
+			c = cmp( key, x->key ); \
+			\
+			if( c == 0 ) \
+			{ \
+				return false; \
+			} \
+			x = c < 0 ? x->left : x->right; \
+		} \
+		\
+		node = (prefix##_tree_map_node_t*) lc_allocator_alloc( &p_map->allocator, malloc, sizeof(prefix##_tree_map_node_t) ); \
+		if( !node ) \
+		{ \
+			return false; \
+		} \
+		\
+		node->parent = parent; \
+		node->left   = NULL; \
+		node->right  = NULL; \
+		node->is_red = true; \
+		node->key    = key; \
+		node->value  = value; \
+		\
+		if( !parent ) \
+		{ \
+			p_map->root = node; \
+		} \
+		else if( c < 0 ) \
+		{ \
+			parent->left = node; \
+		} \
+		else \
+		{ \
+			parent->right = node; \
+		} \
+		\
+		prefix##_tree_map_insert_fixup( p_map, node ); \
+		p_map->size++; \
+		return true; \
+	} \
+	\
+	bool prefix##_tree_map_put( prefix##_tree_map_t* p_map, key_type key, value_type value ) \
+	{ \
+		value_type* p_value = prefix##_tree_map_find( p_map, key ); \
+		\
+		if( p_value ) \
+		{ \
+			*p_value = value; \
+			return true; \
+		} \
+		\
+		return prefix##_tree_map_insert( p_map, key, value ); \
+	} \
+	\
+	value_type* prefix##_tree_map_find( const prefix##_tree_map_t* p_map, key_type key ) \
+	{ \
+		prefix##_tree_map_node_t* x; \
+		\
+		assert( p_map ); \
+		x = prefix##_tree_map_find_node( p_map, key ); \
+		\
+		return x ? &x->value : NULL; \
+	} \
+	\
+	bool prefix##_tree_map_remove( prefix##_tree_map_t* p_map, key_type key ) \
+	{ \
+		prefix##_tree_map_node_t* t; \
+		prefix##_tree_map_node_t* child; \
+		prefix##_tree_map_node_t* parent; \
+		\
+		assert( p_map ); \
+		t = prefix##_tree_map_find_node( p_map, key ); \
+		\
+		if( !t ) \
+		{ \
+			return false; \
+		} \
+		\
+		if( t->left && t->right ) \
+		{ \
+			/* Take the successor's place; its node is the one unlinked. */ \
+			prefix##_tree_map_node_t* y = t->right; \
+			\
+			while( y->left ) \
+			{ \
+				y = y->left; \
+			} \
+			\
+			t->key   = y->key; \
+			t->value = y->value; \
+			t = y; \
+		} \
+		\
+		child  = t->left ? t->left : t->right; \
+		parent = t->parent; \
+		\
+		if( child ) \
+		{ \
+			child->parent = parent; \
+		} \
+		prefix##_tree_map_replace_child( p_map, parent, t, child ); \
+		\
+		if( !t->is_red ) \
+		{ \
+			prefix##_tree_map_delete_fixup( p_map, child, parent ); \
+		} \
+		\
+		lc_allocator_free( &p_map->allocator, free, t ); \
+		p_map->size--; \
+		return true; \
+	} \
+	\
+	void prefix##_tree_map_clear( prefix##_tree_map_t* p_map ) \
+	{ \
+		prefix##_tree_map_node_t* x; \
+		\
+		assert( p_map ); \
+		x = p_map->root; \
+		\
+		/* Free the nodes bottom up without any recursion or stack. */ \
+		while( x ) \
+		{ \
+			if( x->left ) \
+			{ \
+				x = x->left; \
+			} \
+			else if( x->right ) \
+			{ \
+				x = x->right; \
+			} \
+			else \
+			{ \
+				prefix##_tree_map_node_t* parent = x->parent; \
+				\
+				if( parent ) \
+				{ \
+					if( parent->left == x ) parent->left = NULL; \
+					else                    parent->right = NULL; \
+				} \
+				\
+				lc_allocator_free( &p_map->allocator, free, x ); \
+				x = parent; \
+			} \
+		} \
+		\
+		p_map->root = NULL; \
+		p_map->size = 0; \
+	} \
+	\
+	size_t prefix##_tree_map_size( const prefix##_tree_map_t* p_map ) \
+	{ \
+		return p_map->size; \
+	} \
+	\
+	prefix##_tree_map_node_t* prefix##_tree_map_first( const prefix##_tree_map_t* p_map ) \
+	{ \
+		prefix##_tree_map_node_t* x = p_map->root; \
+		\
+		while( x && x->left ) \
+		{ \
+			x = x->left; \
+		} \
+		\
+		return x; \
+	} \
+	\
+	prefix##_tree_map_node_t* prefix##_tree_map_last( const prefix##_tree_map_t* p_map ) \
+	{ \
+		prefix##_tree_map_node_t* x = p_map->root; \
+		\
+		while( x && x->right ) \
+		{ \
+			x = x->right; \
+		} \
+		\
+		return x; \
+	} \
+	\
+	prefix##_tree_map_node_t* prefix##_tree_map_next( const prefix##_tree_map_node_t* p_node ) \
+	{ \
+		prefix##_tree_map_node_t* x = (prefix##_tree_map_node_t*) p_node; \
+		\
+		if( x->right ) \
+		{ \
+			x = x->right; \
+			while( x->left ) \
+			{ \
+				x = x->left; \
+			} \
+			return x; \
+		} \
+		\
+		while( x->parent && x == x->parent->right ) \
+		{ \
+			x = x->parent; \
+		} \
+		\
+		return x->parent; \
+	} \
+	\
+	prefix##_tree_map_node_t* prefix##_tree_map_previous( const prefix##_tree_map_node_t* p_node ) \
+	{ \
+		prefix##_tree_map_node_t* x = (prefix##_tree_map_node_t*) p_node; \
+		\
+		if( x->left ) \
+		{ \
+			x = x->left; \
+			while( x->right ) \
+			{ \
+				x = x->right; \
+			} \
+			return x; \
+		} \
+		\
+		while( x->parent && x == x->parent->left ) \
+		{ \
+			x = x->parent; \
+		} \
+		\
+		return x->parent; \
+	}
+
+#endif /* _LC_TYPED_TREE_MAP_H_ */